@@ -0,0 +1,123 @@
+//
+// Created by johnk on 2026/10/18.
+//
+
+#include <vector>
+#include <string>
+#include <random>
+#include <filesystem>
+
+#include <benchmark/benchmark.h>
+
+#include <Common/Compression.h>
+#include <Common/Math/Vector.h>
+
+using namespace Common;
+
+// Loading of a 16MB asset file through the mapped file stream, plain against block compressed, the compressed file is
+// decoded block by block on demand or all blocks in parallel on the thread pool. The texture-like payload is a tiled
+// sprite sheet with flat color regions, the mesh-like payload is a grid of vertex positions, the ratio counter is the
+// compressed file size over the plain file size.
+namespace {
+    constexpr size_t payloadSize = 16 << 20;
+
+    std::vector<uint8_t> MakeTexturePayload()
+    {
+        std::vector<uint8_t> result(payloadSize);
+        std::mt19937 random(42); // NOLINT
+        std::vector<uint8_t> palette(64 * 4);
+        for (auto& value : palette) {
+            value = static_cast<uint8_t>(random());
+        }
+        // 2048 x 2048 RGBA, each 32 x 32 tile is one color of the palette
+        for (size_t i = 0; i < payloadSize; i++) {
+            const auto pixel = i / 4;
+            const auto tile = (pixel % 2048) / 32 + (pixel / 2048 / 32) * 7;
+            result[i] = palette[(tile % 64) * 4 + i % 4];
+        }
+        return result;
+    }
+
+    std::vector<uint8_t> MakeMeshPayload()
+    {
+        std::vector<FVec3> positions(payloadSize / sizeof(FVec3));
+        for (size_t i = 0; i < positions.size(); i++) {
+            positions[i] = FVec3(static_cast<float>(i % 1024) * 0.25f, 0.0f, static_cast<float>(i / 1024) * 0.25f);
+        }
+        std::vector<uint8_t> result(positions.size() * sizeof(FVec3));
+        memcpy(result.data(), positions.data(), result.size());
+        return result;
+    }
+
+    std::string AssetFileName(bool inCompressed)
+    {
+        return (std::filesystem::temp_directory_path() / "ExplosionCompressionBenchmark" / (inCompressed ? "Compressed.bin" : "Plain.bin")).string();
+    }
+
+    void SaveAsset(const std::vector<uint8_t>& inPayload, bool inCompressed)
+    {
+        std::filesystem::create_directories(std::filesystem::temp_directory_path() / "ExplosionCompressionBenchmark");
+        BufferedFileSerializeStream fileStream(AssetFileName(inCompressed));
+        if (inCompressed) {
+            CompressedSerializeStream stream(fileStream);
+            Serializer<std::vector<uint8_t>>::Serialize(stream, inPayload);
+        } else {
+            Serializer<std::vector<uint8_t>>::Serialize(fileStream, inPayload);
+        }
+    }
+
+    template <std::vector<uint8_t>(*MakePayload)(), bool Compressed, bool Parallel>
+    void LoadAssetBenchmark(benchmark::State& state)
+    {
+        const auto payload = MakePayload();
+        SaveAsset(payload, false);
+        SaveAsset(payload, true);
+
+        ThreadPool threadPool("BenchmarkThreadPool", 4);
+        std::vector<uint8_t> loaded;
+        for (auto _ : state) {
+            MappedFileDeserializeStream fileStream(AssetFileName(Compressed));
+            if (Compressed) {
+                CompressedDeserializeStream stream(fileStream, Parallel ? &threadPool : nullptr);
+                Serializer<std::vector<uint8_t>>::Deserialize(stream, loaded);
+            } else {
+                Serializer<std::vector<uint8_t>>::Deserialize(fileStream, loaded);
+            }
+            benchmark::DoNotOptimize(loaded.data());
+        }
+        state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(payloadSize));
+        state.counters["ratio"] = static_cast<double>(std::filesystem::file_size(AssetFileName(true))) / static_cast<double>(std::filesystem::file_size(AssetFileName(false)));
+        std::filesystem::remove_all(std::filesystem::temp_directory_path() / "ExplosionCompressionBenchmark");
+    }
+}
+
+static void LoadTexturePlain(benchmark::State& state) { LoadAssetBenchmark<MakeTexturePayload, false, false>(state); }
+static void LoadTextureCompressed(benchmark::State& state) { LoadAssetBenchmark<MakeTexturePayload, true, false>(state); }
+static void LoadTextureCompressedParallel(benchmark::State& state) { LoadAssetBenchmark<MakeTexturePayload, true, true>(state); }
+static void LoadMeshPlain(benchmark::State& state) { LoadAssetBenchmark<MakeMeshPayload, false, false>(state); }
+static void LoadMeshCompressed(benchmark::State& state) { LoadAssetBenchmark<MakeMeshPayload, true, false>(state); }
+static void LoadMeshCompressedParallel(benchmark::State& state) { LoadAssetBenchmark<MakeMeshPayload, true, true>(state); }
+
+BENCHMARK(LoadTexturePlain)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(LoadTextureCompressed)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(LoadTextureCompressedParallel)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(LoadMeshPlain)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(LoadMeshCompressed)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(LoadMeshCompressedParallel)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// write side, the compression cost paid by the asset save
+static void SaveTextureCompressed(benchmark::State& state)
+{
+    const auto payload = MakeTexturePayload();
+    std::vector<uint8_t> bytes;
+    for (auto _ : state) {
+        bytes.clear();
+        MemorySerializeStream memoryStream(bytes);
+        CompressedSerializeStream stream(memoryStream);
+        Serializer<std::vector<uint8_t>>::Serialize(stream, payload);
+        stream.Close();
+        benchmark::DoNotOptimize(bytes.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(payloadSize));
+}
+BENCHMARK(SaveTextureCompressed)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,202 @@
+//
+// Created by johnk on 2026/10/18.
+//
+
+#include <queue>
+#include <mutex>
+#include <condition_variable>
+
+#include <benchmark/benchmark.h>
+
+#include <Common/Concurrent.h>
+
+using namespace Common;
+
+namespace {
+    constexpr int64_t taskNum = 100000;
+
+    // the worker thread queue this repo used before the mpsc ring, kept as the baseline of the submission benchmarks
+    class LockedQueueWorker {
+    public:
+        LockedQueueWorker()
+            : stop(false)
+        {
+            thread = std::thread([this]() -> void {
+                while (true) {
+                    std::function<void()> task;
+                    {
+                        std::unique_lock lock(mutex);
+                        condition.wait(lock, [this]() -> bool { return stop || !tasks.empty(); });
+                        if (stop && tasks.empty()) {
+                            return;
+                        }
+                        task = std::move(tasks.front());
+                        tasks.pop();
+                    }
+                    task();
+                }
+            });
+        }
+
+        ~LockedQueueWorker()
+        {
+            {
+                std::unique_lock lock(mutex);
+                stop = true;
+            }
+            condition.notify_all();
+            thread.join();
+        }
+
+        template <typename F>
+        auto EmplaceTask(F&& inTask)
+        {
+            using RetType = std::invoke_result_t<F>;
+            auto packagedTask = MakeShared<std::packaged_task<RetType()>>(inTask);
+            auto result = packagedTask->get_future();
+            {
+                std::unique_lock lock(mutex);
+                tasks.emplace([packagedTask]() -> void { (*packagedTask)(); });
+            }
+            condition.notify_one();
+            return result;
+        }
+
+    private:
+        bool stop;
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::queue<std::function<void()>> tasks;
+        std::thread thread;
+    };
+}
+
+// submission throughput, the producer posts a batch of tiny tasks and waits for the last one
+static void LockedQueueSubmit(benchmark::State& state)
+{
+    LockedQueueWorker worker;
+    uint64_t counter = 0;
+    for (auto _ : state) {
+        for (auto i = 0; i < state.range(0); i++) {
+            worker.EmplaceTask([&counter]() -> void { counter++; });
+        }
+        worker.EmplaceTask([]() -> void {}).wait();
+    }
+    benchmark::DoNotOptimize(counter);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(LockedQueueSubmit)->Arg(taskNum)->Unit(benchmark::kMillisecond);
+
+static void WorkerThreadEmplaceTask(benchmark::State& state)
+{
+    WorkerThread worker("BenchmarkWorker");
+    uint64_t counter = 0;
+    for (auto _ : state) {
+        for (auto i = 0; i < state.range(0); i++) {
+            worker.EmplaceTask([&counter]() -> void { counter++; });
+        }
+        worker.Flush();
+    }
+    benchmark::DoNotOptimize(counter);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(WorkerThreadEmplaceTask)->Arg(taskNum)->Unit(benchmark::kMillisecond);
+
+static void WorkerThreadPostTask(benchmark::State& state)
+{
+    WorkerThread worker("BenchmarkWorker");
+    uint64_t counter = 0;
+    for (auto _ : state) {
+        for (auto i = 0; i < state.range(0); i++) {
+            worker.PostTask([&counter]() -> void { counter++; });
+        }
+        worker.Flush();
+    }
+    benchmark::DoNotOptimize(counter);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(WorkerThreadPostTask)->Arg(taskNum)->Unit(benchmark::kMillisecond);
+
+// round trip latency, one task is submitted and waited at a time
+static void LockedQueueRoundTrip(benchmark::State& state)
+{
+    LockedQueueWorker worker;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(worker.EmplaceTask([]() -> uint32_t { return 1; }).get());
+    }
+}
+BENCHMARK(LockedQueueRoundTrip)->Unit(benchmark::kMicrosecond);
+
+static void WorkerThreadRoundTrip(benchmark::State& state)
+{
+    WorkerThread worker("BenchmarkWorker");
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(worker.EmplaceTask([]() -> uint32_t { return 1; }).get());
+    }
+}
+BENCHMARK(WorkerThreadRoundTrip)->Unit(benchmark::kMicrosecond);
+
+// raw ring throughput with several producers, the benchmark thread is the consumer
+static void MpscRingContended(benchmark::State& state)
+{
+    const auto producerNum = state.range(0);
+    for (auto _ : state) {
+        MpscRing<UniqueTask> ring(1024);
+        std::vector<std::thread> producers;
+        uint64_t counter = 0;
+        for (auto i = 0; i < producerNum; i++) {
+            producers.emplace_back([&ring, &counter]() -> void {
+                for (auto j = 0; j < taskNum; j++) {
+                    ring.Push(UniqueTask([&counter]() -> void { counter++; }));
+                }
+            });
+        }
+        UniqueTask task;
+        for (auto popped = 0; popped < producerNum * taskNum;) {
+            if (ring.TryPop(task)) {
+                task();
+                popped++;
+            } else {
+                ring.Wait([]() -> bool { return false; });
+            }
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        benchmark::DoNotOptimize(counter);
+    }
+    state.SetItemsProcessed(state.iterations() * producerNum * taskNum);
+}
+BENCHMARK(MpscRingContended)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// fork-join over many small items, one future per item against the chunked work-stealing parallel for
+static void ThreadPoolFuturePerItem(benchmark::State& state)
+{
+    ThreadPool threadPool("BenchmarkThreadPool", 4);
+    std::vector<float> values(state.range(0), 1.0f);
+    for (auto _ : state) {
+        std::vector<std::future<void>> futures;
+        futures.reserve(values.size());
+        for (auto i = 0; i < values.size(); i++) {
+            futures.emplace_back(threadPool.EmplaceTask([&values, i]() -> void { values[i] *= 1.0001f; }));
+        }
+        for (const auto& future : futures) {
+            future.wait();
+        }
+    }
+    benchmark::DoNotOptimize(values.data());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(ThreadPoolFuturePerItem)->Arg(taskNum)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void ThreadPoolParallelFor(benchmark::State& state)
+{
+    ThreadPool threadPool("BenchmarkThreadPool", 4);
+    std::vector<float> values(state.range(0), 1.0f);
+    for (auto _ : state) {
+        threadPool.ParallelFor(0, values.size(), 1024, [&values](size_t i) -> void { values[i] *= 1.0001f; });
+    }
+    benchmark::DoNotOptimize(values.data());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(ThreadPoolParallelFor)->Arg(taskNum)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -10,6 +10,8 @@
 #include <Common/Math/Vector.h>
 #include <Common/Math/Matrix.h>
 #include <Common/Math/Quaternion.h>
+#include <Common/Math/Transform.h>
+#include <Common/Math/TransformBatch.h>
 
 using namespace Common;
 
@@ -226,3 +228,65 @@ static void Mat3MulVecBatch(benchmark::State& state)
 }
 BENCHMARK(Mat3MulVecBatch<MathBackend::scalar>);
 BENCHMARK(Mat3MulVecBatch<MathBackend::simd>);
+
+// per-element FTransform::GetTransformMatrix() (three full 4x4 products) against the SoA batch kernel, which is what
+// TransformSystem runs over the gathered local transforms of each propagation batch
+namespace {
+    std::vector<FTransform> MakeRandomTransforms(const size_t count)
+    {
+        const auto raw = MakeRandomFloats(count * 10);
+        std::vector<FTransform> result(count);
+        for (size_t i = 0; i < count; i++) {
+            const float* p = &raw[i * 10];
+            result[i] = FTransform(FVec3(p[0], p[1], p[2]), FQuat(p[3], p[4], p[5], p[6]), FVec3(p[7], p[8], p[9]));
+        }
+        return result;
+    }
+}
+
+static void TransformToMatrixBatch(benchmark::State& state)
+{
+    const auto transforms = MakeRandomTransforms(batchSize);
+    std::vector<FMat4x4> matrices(batchSize);
+    for (auto _ : state) {
+        for (int i = 0; i < batchSize; i++) {
+            matrices[i] = transforms[i].GetTransformMatrix();
+        }
+        benchmark::DoNotOptimize(matrices.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * batchSize);
+}
+BENCHMARK(TransformToMatrixBatch);
+
+static void TransformToMatrixBatchKernel(benchmark::State& state)
+{
+    const auto transforms = MakeRandomTransforms(batchSize);
+    std::vector<FMat4x4> matrices(batchSize);
+    for (auto _ : state) {
+        BatchTransformToMatrix(transforms, matrices);
+        benchmark::DoNotOptimize(matrices.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * batchSize);
+}
+BENCHMARK(TransformToMatrixBatchKernel);
+
+static void MulAffineBatchKernel(benchmark::State& state)
+{
+    const auto transforms = MakeRandomTransforms(batchSize * 2);
+    std::vector<FMat4x4> parents(batchSize);
+    std::vector<FMat4x4> children(batchSize);
+    std::vector<FMat4x4> results(batchSize);
+    for (int i = 0; i < batchSize; i++) {
+        parents[i] = transforms[i].GetTransformMatrix();
+        children[i] = transforms[batchSize + i].GetTransformMatrix();
+    }
+    for (auto _ : state) {
+        BatchMulAffine(parents, children, results);
+        benchmark::DoNotOptimize(results.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * batchSize);
+}
+BENCHMARK(MulAffineBatchKernel);
@@ -0,0 +1,252 @@
+//
+// Created by johnk on 2026/10/18.
+//
+
+#include <vector>
+#include <string>
+#include <format>
+#include <filesystem>
+
+#include <benchmark/benchmark.h>
+
+#include <Common/Serialization.h>
+#include <Common/Math/Vector.h>
+
+using namespace Common;
+
+// Serialization of 1M-element containers into memory streams, the element by element baselines go through the same
+// per-value Write()/Read() calls the container serializers used before the bulk path. The big endian variants exercise
+// the byte swap on little endian hosts.
+namespace {
+    constexpr int64_t elementNum = 1 << 20;
+
+    std::vector<float> MakeFloats()
+    {
+        std::vector<float> result(elementNum);
+        for (auto i = 0; i < elementNum; i++) {
+            result[i] = static_cast<float>(i) * 0.5f;
+        }
+        return result;
+    }
+
+    std::vector<FVec3> MakePositions()
+    {
+        std::vector<FVec3> result(elementNum);
+        for (auto i = 0; i < elementNum; i++) {
+            result[i] = FVec3(static_cast<float>(i), static_cast<float>(i) * 0.5f, -static_cast<float>(i));
+        }
+        return result;
+    }
+
+    template <std::endian E>
+    void SerializeFloatsPerElement(benchmark::State& state)
+    {
+        const auto values = MakeFloats();
+        std::vector<uint8_t> bytes;
+        bytes.reserve(values.size() * sizeof(float) + 64);
+        for (auto _ : state) {
+            bytes.clear();
+            MemorySerializeStream<E> stream(bytes);
+            const uint64_t size = values.size();
+            stream.template Write<uint64_t>(size);
+            for (const auto value : values) {
+                stream.template Write<float>(value);
+            }
+            benchmark::DoNotOptimize(bytes.data());
+        }
+        state.SetBytesProcessed(state.iterations() * elementNum * static_cast<int64_t>(sizeof(float)));
+    }
+
+    template <std::endian E>
+    void SerializeFloatsBulk(benchmark::State& state)
+    {
+        const auto values = MakeFloats();
+        std::vector<uint8_t> bytes;
+        bytes.reserve(values.size() * sizeof(float) + 64);
+        for (auto _ : state) {
+            bytes.clear();
+            MemorySerializeStream<E> stream(bytes);
+            Serializer<std::vector<float>>::Serialize(stream, values);
+            benchmark::DoNotOptimize(bytes.data());
+        }
+        state.SetBytesProcessed(state.iterations() * elementNum * static_cast<int64_t>(sizeof(float)));
+    }
+
+    template <std::endian E>
+    void DeserializeFloatsPerElement(benchmark::State& state)
+    {
+        std::vector<uint8_t> bytes;
+        {
+            MemorySerializeStream<E> stream(bytes);
+            Serializer<std::vector<float>>::Serialize(stream, MakeFloats());
+        }
+        std::vector<float> values;
+        for (auto _ : state) {
+            MemoryDeserializeStream<E> stream(bytes);
+            uint64_t size;
+            stream.template Read<uint64_t>(size);
+            values.clear();
+            values.reserve(size);
+            for (auto i = 0; i < size; i++) {
+                float value;
+                stream.template Read<float>(value);
+                values.emplace_back(value);
+            }
+            benchmark::DoNotOptimize(values.data());
+        }
+        state.SetBytesProcessed(state.iterations() * elementNum * static_cast<int64_t>(sizeof(float)));
+    }
+
+    template <std::endian E>
+    void DeserializeFloatsBulk(benchmark::State& state)
+    {
+        std::vector<uint8_t> bytes;
+        {
+            MemorySerializeStream<E> stream(bytes);
+            Serializer<std::vector<float>>::Serialize(stream, MakeFloats());
+        }
+        std::vector<float> values;
+        for (auto _ : state) {
+            MemoryDeserializeStream<E> stream(bytes);
+            Serializer<std::vector<float>>::Deserialize(stream, values);
+            benchmark::DoNotOptimize(values.data());
+        }
+        state.SetBytesProcessed(state.iterations() * elementNum * static_cast<int64_t>(sizeof(float)));
+    }
+}
+
+static void SerializeFloatsPerElementLittle(benchmark::State& state) { SerializeFloatsPerElement<std::endian::little>(state); }
+static void SerializeFloatsPerElementBig(benchmark::State& state) { SerializeFloatsPerElement<std::endian::big>(state); }
+static void SerializeFloatsBulkLittle(benchmark::State& state) { SerializeFloatsBulk<std::endian::little>(state); }
+static void SerializeFloatsBulkBig(benchmark::State& state) { SerializeFloatsBulk<std::endian::big>(state); }
+static void DeserializeFloatsPerElementLittle(benchmark::State& state) { DeserializeFloatsPerElement<std::endian::little>(state); }
+static void DeserializeFloatsPerElementBig(benchmark::State& state) { DeserializeFloatsPerElement<std::endian::big>(state); }
+static void DeserializeFloatsBulkLittle(benchmark::State& state) { DeserializeFloatsBulk<std::endian::little>(state); }
+static void DeserializeFloatsBulkBig(benchmark::State& state) { DeserializeFloatsBulk<std::endian::big>(state); }
+
+BENCHMARK(SerializeFloatsPerElementLittle)->Unit(benchmark::kMillisecond);
+BENCHMARK(SerializeFloatsPerElementBig)->Unit(benchmark::kMillisecond);
+BENCHMARK(SerializeFloatsBulkLittle)->Unit(benchmark::kMillisecond);
+BENCHMARK(SerializeFloatsBulkBig)->Unit(benchmark::kMillisecond);
+BENCHMARK(DeserializeFloatsPerElementLittle)->Unit(benchmark::kMillisecond);
+BENCHMARK(DeserializeFloatsPerElementBig)->Unit(benchmark::kMillisecond);
+BENCHMARK(DeserializeFloatsBulkLittle)->Unit(benchmark::kMillisecond);
+BENCHMARK(DeserializeFloatsBulkBig)->Unit(benchmark::kMillisecond);
+
+// mesh vertex positions, the vector of FVec3 takes the bulk path through the Vec traits
+static void SerializePositions(benchmark::State& state)
+{
+    const auto positions = MakePositions();
+    std::vector<uint8_t> bytes;
+    for (auto _ : state) {
+        bytes.clear();
+        MemorySerializeStream stream(bytes);
+        Serializer<std::vector<FVec3>>::Serialize(stream, positions);
+        benchmark::DoNotOptimize(bytes.data());
+    }
+    state.SetBytesProcessed(state.iterations() * elementNum * static_cast<int64_t>(sizeof(FVec3)));
+}
+BENCHMARK(SerializePositions)->Unit(benchmark::kMillisecond);
+
+static void DeserializePositions(benchmark::State& state)
+{
+    std::vector<uint8_t> bytes;
+    {
+        MemorySerializeStream stream(bytes);
+        Serializer<std::vector<FVec3>>::Serialize(stream, MakePositions());
+    }
+    std::vector<FVec3> positions;
+    for (auto _ : state) {
+        MemoryDeserializeStream stream(bytes);
+        Serializer<std::vector<FVec3>>::Deserialize(stream, positions);
+        benchmark::DoNotOptimize(positions.data());
+    }
+    state.SetBytesProcessed(state.iterations() * elementNum * static_cast<int64_t>(sizeof(FVec3)));
+}
+BENCHMARK(DeserializePositions)->Unit(benchmark::kMillisecond);
+
+// asset directory throughput, each asset file carries a table of short names written field by field followed by a 1MB
+// texture-like payload, the directory size in MB is the argument, Arg(1024) is the 1GB directory case
+namespace {
+    constexpr size_t assetPayloadSize = 1 << 20;
+    constexpr size_t assetNameNum = 1024;
+
+    struct BenchmarkAssetData {
+        std::vector<std::string> names;
+        std::vector<uint8_t> payload;
+    };
+
+    BenchmarkAssetData MakeAssetData(size_t inSeed)
+    {
+        BenchmarkAssetData result;
+        result.names.reserve(assetNameNum);
+        for (auto i = 0; i < assetNameNum; i++) {
+            result.names.emplace_back(std::format("Asset{}_Mip{}", inSeed, i));
+        }
+        result.payload.resize(assetPayloadSize);
+        for (auto i = 0; i < assetPayloadSize; i++) {
+            result.payload[i] = static_cast<uint8_t>(i + inSeed);
+        }
+        return result;
+    }
+
+    std::string AssetFileName(size_t inIndex)
+    {
+        return (std::filesystem::temp_directory_path() / "ExplosionSerializationBenchmark" / std::format("Asset{}.bin", inIndex)).string();
+    }
+
+    template <typename S>
+    void SaveAssetDirectory(const BenchmarkAssetData& inData, size_t inFileNum)
+    {
+        std::filesystem::create_directories(std::filesystem::temp_directory_path() / "ExplosionSerializationBenchmark");
+        for (auto i = 0; i < inFileNum; i++) {
+            S stream(AssetFileName(i));
+            Serializer<std::vector<std::string>>::Serialize(stream, inData.names);
+            Serializer<std::vector<uint8_t>>::Serialize(stream, inData.payload);
+        }
+    }
+
+    template <typename S>
+    void LoadAssetDirectory(size_t inFileNum, BenchmarkAssetData& outData)
+    {
+        for (auto i = 0; i < inFileNum; i++) {
+            S stream(AssetFileName(i));
+            Serializer<std::vector<std::string>>::Deserialize(stream, outData.names);
+            Serializer<std::vector<uint8_t>>::Deserialize(stream, outData.payload);
+            benchmark::DoNotOptimize(outData.payload.data());
+        }
+    }
+
+    template <typename S>
+    void SaveAssetDirectoryBenchmark(benchmark::State& state)
+    {
+        const auto data = MakeAssetData(0);
+        for (auto _ : state) {
+            SaveAssetDirectory<S>(data, state.range(0));
+        }
+        state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<int64_t>(assetPayloadSize));
+        std::filesystem::remove_all(std::filesystem::temp_directory_path() / "ExplosionSerializationBenchmark");
+    }
+
+    template <typename S>
+    void LoadAssetDirectoryBenchmark(benchmark::State& state)
+    {
+        SaveAssetDirectory<BufferedFileSerializeStream<>>(MakeAssetData(0), state.range(0));
+        BenchmarkAssetData data;
+        for (auto _ : state) {
+            LoadAssetDirectory<S>(state.range(0), data);
+        }
+        state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<int64_t>(assetPayloadSize));
+        std::filesystem::remove_all(std::filesystem::temp_directory_path() / "ExplosionSerializationBenchmark");
+    }
+}
+
+static void SaveAssetDirectoryBinaryFile(benchmark::State& state) { SaveAssetDirectoryBenchmark<BinaryFileSerializeStream<>>(state); }
+static void SaveAssetDirectoryBufferedFile(benchmark::State& state) { SaveAssetDirectoryBenchmark<BufferedFileSerializeStream<>>(state); }
+static void LoadAssetDirectoryBinaryFile(benchmark::State& state) { LoadAssetDirectoryBenchmark<BinaryFileDeserializeStream<>>(state); }
+static void LoadAssetDirectoryMappedFile(benchmark::State& state) { LoadAssetDirectoryBenchmark<MappedFileDeserializeStream<>>(state); }
+
+BENCHMARK(SaveAssetDirectoryBinaryFile)->Arg(64)->Arg(1024)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(SaveAssetDirectoryBufferedFile)->Arg(64)->Arg(1024)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(LoadAssetDirectoryBinaryFile)->Arg(64)->Arg(1024)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(LoadAssetDirectoryMappedFile)->Arg(64)->Arg(1024)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,101 @@
+//
+// Created by johnk on 2026/10/18.
+//
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <Common/Serialization.h>
+#include <Common/Concurrent.h>
+
+namespace Common {
+    // Compresses the written bytes in independent blocks of blockSize with lz4 and appends them to another stream, a
+    // block that does not shrink is stored raw. The stream is forward-only and the wrapped stream only sees appends, so
+    // it may be forward-only too. The endian is the wrapped stream's.
+    //
+    // uint32_t magic
+    // uint32_t blockSize
+    // block[]
+    //     |- uint32_t rawSize                : blockSize except for the last block
+    //     |- uint32_t storedSize             : rawSize for the blocks stored raw
+    //     |- uint8_t[] storedContent         : storedSize
+    // uint32_t rawSize, storedSize           : both 0, the end of blocks
+    class CompressedSerializeStream final : public BinarySerializeStream {
+    public:
+        static constexpr uint32_t magic = HashUtils::StrCrc32("CompressedSerializeStream");
+        static constexpr size_t defaultBlockSize = 128 * 1024;
+
+        NonCopyable(CompressedSerializeStream)
+        explicit CompressedSerializeStream(BinarySerializeStream& inStream, size_t inBlockSize = defaultBlockSize);
+        ~CompressedSerializeStream() override;
+
+        void Seek(int64_t offset) override;
+        size_t Loc() override;
+        std::endian Endian() override;
+        bool Seekable() const override;
+        // writes the pending block and the end of blocks, the destructor calls it if not called before
+        void Close();
+
+    protected:
+        void WriteInternal(const void* data, size_t size) override;
+
+    private:
+        void FlushBlock();
+
+        BinarySerializeStream& stream;
+        size_t blockSize;
+        size_t pointer;
+        bool closed;
+        std::vector<uint8_t> block;
+        std::vector<uint8_t> compressed;
+    };
+
+    // Reads the output of CompressedSerializeStream. The block index is built from the block headers at construction,
+    // so a seek lands in its block directly. The blocks are decoded on demand one at a time, or all together at
+    // construction with a parallel for on the thread pool if one is given. The wrapped stream is moved by this stream
+    // until it is destroyed. A corrupted header, block or a read past the end marks the stream corrupted and reads zeros
+    // from then on, a loader checks Corrupted() after reading instead of trusting the data.
+    class CompressedDeserializeStream final : public BinaryDeserializeStream {
+    public:
+        // peeks the magic without moving the stream, false if less than the magic is left
+        static bool IsCompressed(BinaryDeserializeStream& inStream);
+
+        NonCopyable(CompressedDeserializeStream)
+        explicit CompressedDeserializeStream(BinaryDeserializeStream& inStream, ThreadPool* inThreadPool = nullptr);
+        ~CompressedDeserializeStream() override;
+
+        void Seek(int64_t offset) override;
+        size_t Loc() override;
+        std::endian Endian() override;
+        size_t Size() const override;
+        bool Corrupted() const;
+
+    protected:
+        void ReadInternal(void* data, size_t size) override;
+
+    private:
+        struct Block {
+            size_t storedLoc;
+            uint32_t rawSize;
+            uint32_t storedSize;
+        };
+
+        bool ReadBlockIndex();
+        void DecodeAll(ThreadPool& inThreadPool);
+        void DecodeBlock(size_t inIndex);
+
+        BinaryDeserializeStream& stream;
+        size_t blockSize;
+        size_t totalSize;
+        size_t pointer;
+        bool corrupted;
+        std::vector<Block> blocks;
+        // all decoded blocks in the parallel mode, or the block of decodedBlockIndex in the on demand mode
+        bool decodedAll;
+        size_t decodedBlockIndex;
+        std::vector<uint8_t> decoded;
+        std::vector<uint8_t> stored;
+    };
+}
@@ -6,12 +6,15 @@
 
 #include <string>
 #include <vector>
-#include <queue>
+#include <deque>
+#include <atomic>
+#include <cstddef>
 #include <mutex>
 #include <thread>
 #include <future>
 #include <functional>
 #include <type_traits>
+#include <condition_variable>
 
 #include <Common/Debug.h>
 #include <Common/Memory.h>
@@ -34,41 +37,220 @@ namespace Common {
         std::thread thread;
     };
 
+    // move-only void() callable, callables up to inlineSize bytes are stored in place, larger ones on the heap
+    class UniqueTask {
+    public:
+        static constexpr size_t inlineSize = 56;
+
+        UniqueTask();
+        template <typename F> requires (!std::is_same_v<std::decay_t<F>, UniqueTask>) UniqueTask(F&& inFunc); // NOLINT
+        UniqueTask(UniqueTask&& inOther) noexcept;
+        ~UniqueTask();
+
+        NonCopyable(UniqueTask)
+        UniqueTask& operator=(UniqueTask&& inOther) noexcept;
+
+        void operator()();
+        explicit operator bool() const;
+        void Reset();
+
+    private:
+        struct Ops {
+            void(*invoke)(void*);
+            // move constructs the callable at the first address from the second one and destroys the second one
+            void(*relocate)(void*, void*);
+            void(*destroy)(void*);
+        };
+
+        template <typename F> static constexpr bool storeInline = sizeof(F) <= inlineSize && alignof(F) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<F>;
+        template <typename F> static const Ops* GetOps();
+
+        alignas(std::max_align_t) uint8_t storage[inlineSize];
+        const Ops* ops;
+    };
+
+    // Bounded lock-free multi-producer single-consumer ring, each slot carries a sequence number telling whether it is
+    // ready to be written or read, so producers only contend on one atomic increment. Push() falls back to blocking while
+    // the ring is full, Wait() blocks the consumer while it is empty, the mutex is only touched when someone sleeps.
+    template <typename T>
+    class MpscRing {
+    public:
+        explicit MpscRing(size_t inCapacity);
+        ~MpscRing();
+
+        NonCopyable(MpscRing)
+        NonMovable(MpscRing)
+
+        // inValue is only moved from when returning true
+        bool TryPush(T&& inValue);
+        void Push(T&& inValue);
+        // consumer only
+        bool TryPop(T& outValue);
+        bool Empty() const;
+        // consumer only, blocks until the ring is not empty or inWakeCondition() is true
+        template <typename F> void Wait(F&& inWakeCondition);
+        // wakes the consumer up to recheck the wake condition of Wait() after it was changed
+        void NotifyConsumer();
+        size_t Capacity() const;
+        // number of pushes claimed but not popped yet
+        size_t Size() const;
+
+    private:
+        struct Slot {
+            std::atomic<size_t> sequence;
+            alignas(T) uint8_t storage[sizeof(T)];
+        };
+
+        bool Full() const;
+
+        size_t mask;
+        std::unique_ptr<Slot[]> slots;
+        alignas(64) std::atomic<size_t> pushPos;
+        alignas(64) std::atomic<size_t> popPos;
+        alignas(64) std::atomic<bool> consumerWaiting;
+        std::atomic<uint32_t> producerWaitingNum;
+        std::mutex mutex;
+        std::condition_variable consumerCondition;
+        std::condition_variable producerCondition;
+    };
+
+    // counts the tasks of a ThreadPool started with ThreadPool::Run() that have not finished yet
+    class TaskGroup {
+    public:
+        TaskGroup();
+        ~TaskGroup();
+
+        NonCopyable(TaskGroup)
+        NonMovable(TaskGroup)
+
+        bool Done() const;
+
+    private:
+        friend class ThreadPool;
+
+        std::atomic<size_t> pendingNum;
+    };
+
+    // reusable dependency graph of tasks run by ThreadPool::RunAndWait(), a node starts once all the nodes preceding it
+    // finished, only one run of a graph may be in flight at a time
+    class TaskGraph {
+    public:
+        using NodeId = size_t;
+
+        TaskGraph();
+        ~TaskGraph();
+
+        NonCopyable(TaskGraph)
+        NonMovable(TaskGraph)
+
+        // an empty function makes a placeholder node, e.g. a barrier between two sets of nodes
+        NodeId Emplace(std::function<void()> inFunc = {});
+        // inAfter starts after inBefore finished
+        void Precede(NodeId inBefore, NodeId inAfter);
+        void Clear();
+        size_t Size() const;
+
+    private:
+        friend class ThreadPool;
+
+        struct Node {
+            std::function<void()> func;
+            std::vector<NodeId> successors;
+            uint32_t predecessorNum;
+        };
+
+        void PrepareRun();
+
+        std::vector<Node> nodes;
+        std::unique_ptr<std::atomic<uint32_t>[]> pendingPredecessorNums;
+        size_t pendingPredecessorCapacity;
+    };
+
+    // Work-stealing pool, each worker owns a deque, pushes and pops its own tasks at the back and steals from the front
+    // of the other workers' deques when it runs out of work. Tasks submitted from outside the pool go through a lock-free
+    // injection ring. Waiting on a task group, from a worker or any other thread, executes pending tasks before blocking,
+    // so tasks may wait on the tasks they spawn.
     class ThreadPool {
     public:
+        static constexpr size_t taskQueueCapacity = 1024;
+
         ThreadPool(const std::string& name, uint8_t threadNum);
         ~ThreadPool();
 
         template <typename F> auto EmplaceTask(F&& task);
+        // fire-and-forget, no future is created
+        template <typename F> void PostTask(F&& task);
+        // task(i) for i in [0, taskNum)
         template <typename F> void ExecuteTasks(size_t taskNum, F&& task);
+        // inFunc(i) for i in [inBegin, inEnd), the range is split in halves until a piece holds at most inGrainSize
+        // indices, idle workers steal the larger halves, the calling thread takes part and returns when all are done
+        template <typename F> void ParallelFor(size_t inBegin, size_t inEnd, size_t inGrainSize, F&& inFunc);
+        template <typename F> void Run(TaskGroup& inGroup, F&& inTask);
+        void Wait(TaskGroup& inGroup);
+        void RunAndWait(TaskGraph& inGraph);
+        uint8_t ThreadNum() const;
+        // whether the calling thread is one of the workers of this pool
+        bool InWorker() const;
 
     private:
-        template <typename Ret> auto EmplaceTaskInternal(Common::SharedPtr<std::packaged_task<Ret()>> packedTask);
+        struct WorkerQueue {
+            std::mutex mutex;
+            std::deque<UniqueTask> tasks;
+        };
 
-        bool stop;
-        std::mutex mutex;
-        std::condition_variable condition;
+        template <typename F> void ParallelForRange(TaskGroup& inGroup, size_t inBegin, size_t inEnd, size_t inGrainSize, F& inFunc);
+        void Submit(UniqueTask&& inTask);
+        bool TryAcquire(UniqueTask& outTask);
+        void WakeWorker();
+        void FinishGroupTask(TaskGroup& inGroup);
+        void WorkerLoop(size_t inWorkerIndex);
+        void ScheduleGraphNode(TaskGraph& inGraph, TaskGroup& inGroup, TaskGraph::NodeId inNode);
+        void ExecuteGraphNode(TaskGraph& inGraph, TaskGroup& inGroup, TaskGraph::NodeId inNode);
+
+        std::atomic<bool> stop;
+        std::vector<std::unique_ptr<WorkerQueue>> workerQueues;
+        // the workers and waiting threads take turns to be the single consumer of the ring
+        MpscRing<UniqueTask> injectedTasks;
+        std::mutex injectedConsumerMutex;
+        // bumped by every submission, a worker only sleeps if no submission happened since its last scan
+        std::atomic<uint64_t> wakeEpoch;
+        std::atomic<uint32_t> sleepingNum;
+        // threads sleeping in Wait(), woken up by the last task of a group
+        std::atomic<uint32_t> waitingNum;
+        // submissions from outside the pool still running, the destructor waits for them
+        std::atomic<uint32_t> submittingNum;
+        std::mutex sleepMutex;
+        std::condition_variable sleepCondition;
         std::vector<NamedThread> threads;
-        std::queue<std::function<void()>> tasks;
     };
 
     class WorkerThread {
     public:
+        static constexpr size_t taskQueueCapacity = 1024;
+
         explicit WorkerThread(const std::string& name);
         ~WorkerThread();
 
         void Flush();
 
         template <typename F> auto EmplaceTask(F&& task);
+        // fire-and-forget, no future is created
+        template <typename F> void PostTask(F&& task);
+        // whether the calling thread is this worker thread
+        bool InThread() const;
 
     private:
-        bool stop;
-        bool flush;
-        std::mutex mutex;
-        std::condition_variable taskCondition;
-        std::condition_variable flushCondition;
+        // the thread posting to itself is the consumer, so it spills into overflowTasks instead of blocking on a full ring
+        void PostLocal(UniqueTask&& inTask);
+        void RunOverflowTasks();
+        void FinishFlush(std::promise<void>& outDone);
+
+        std::atomic<bool> stop;
+        MpscRing<UniqueTask> tasks;
+        // only touched by the worker thread, run once the ring is drained
+        std::vector<UniqueTask> overflowTasks;
+        std::vector<UniqueTask> runningOverflowTasks;
         NamedThread thread;
-        std::queue<std::function<void()>> tasks;
     };
 }
 
@@ -82,54 +264,267 @@ namespace Common {
         });
     }
 
-    template <typename F>
-    auto ThreadPool::EmplaceTask(F&& task)
+    template <typename F> requires (!std::is_same_v<std::decay_t<F>, UniqueTask>)
+    UniqueTask::UniqueTask(F&& inFunc)
+        : storage()
+        , ops(GetOps<std::decay_t<F>>())
     {
-        using RetType = std::invoke_result_t<F>;
-        return EmplaceTaskInternal<RetType>(Common::MakeShared<std::packaged_task<RetType()>>(task));
+        using Func = std::decay_t<F>;
+        if constexpr (storeInline<Func>) {
+            new (storage) Func(std::forward<F>(inFunc));
+        } else {
+            *reinterpret_cast<Func**>(storage) = new Func(std::forward<F>(inFunc));
+        }
     }
 
     template <typename F>
-    void ThreadPool::ExecuteTasks(size_t taskNum, F&& task)
+    const UniqueTask::Ops* UniqueTask::GetOps()
+    {
+        if constexpr (storeInline<F>) {
+            static constexpr Ops ops = {
+                [](void* inStorage) -> void { (*static_cast<F*>(inStorage))(); },
+                [](void* inDst, void* inSrc) -> void {
+                    new (inDst) F(std::move(*static_cast<F*>(inSrc)));
+                    static_cast<F*>(inSrc)->~F();
+                },
+                [](void* inStorage) -> void { static_cast<F*>(inStorage)->~F(); }
+            };
+            return &ops;
+        } else {
+            static constexpr Ops ops = {
+                [](void* inStorage) -> void { (**static_cast<F**>(inStorage))(); },
+                [](void* inDst, void* inSrc) -> void { *static_cast<F**>(inDst) = *static_cast<F**>(inSrc); },
+                [](void* inStorage) -> void { delete *static_cast<F**>(inStorage); }
+            };
+            return &ops;
+        }
+    }
+
+    template <typename T>
+    MpscRing<T>::MpscRing(size_t inCapacity)
+        : mask(inCapacity - 1)
+        , slots(new Slot[inCapacity])
+        , pushPos(0)
+        , popPos(0)
+        , consumerWaiting(false)
+        , producerWaitingNum(0)
+    {
+        AssertWithReason(inCapacity >= 2 && (inCapacity & (inCapacity - 1)) == 0, "capacity of mpsc ring must be a power of two");
+        for (size_t i = 0; i < inCapacity; i++) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    template <typename T>
+    MpscRing<T>::~MpscRing()
+    {
+        T value;
+        while (TryPop(value)) {}
+    }
+
+    template <typename T>
+    bool MpscRing<T>::TryPush(T&& inValue)
+    {
+        auto pos = pushPos.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &slots[pos & mask];
+            const auto sequence = slot->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (pushPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = pushPos.load(std::memory_order_relaxed);
+            }
+        }
+
+        new (slot->storage) T(std::move(inValue));
+        slot->sequence.store(pos + 1, std::memory_order_release);
+
+        // pairs with the fence in Wait(), either the consumer sees the value or we see it waiting
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (consumerWaiting.load(std::memory_order_relaxed)) {
+            {
+                std::unique_lock lock(mutex);
+            }
+            consumerCondition.notify_one();
+        }
+        return true;
+    }
+
+    template <typename T>
+    void MpscRing<T>::Push(T&& inValue)
     {
-        using RetType = std::invoke_result_t<F, size_t>;
+        while (!TryPush(std::move(inValue))) {
+            producerWaitingNum.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            {
+                std::unique_lock lock(mutex);
+                producerCondition.wait(lock, [this]() -> bool { return !Full(); });
+            }
+            producerWaitingNum.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
 
-        std::vector<std::future<RetType>> futures;
-        futures.reserve(taskNum);
-        for (size_t i = 0; i < taskNum; i++) {
-            futures.emplace_back(EmplaceTaskInternal<RetType>(Common::MakeShared<std::packaged_task<RetType()>>(std::bind(std::forward<F>(task), i))));
+    template <typename T>
+    bool MpscRing<T>::TryPop(T& outValue)
+    {
+        const auto pos = popPos.load(std::memory_order_relaxed);
+        auto& slot = slots[pos & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != pos + 1) {
+            return false;
         }
 
-        for (const auto& future : futures) {
-            future.wait();
+        auto* value = reinterpret_cast<T*>(slot.storage);
+        outValue = std::move(*value);
+        value->~T();
+        popPos.store(pos + 1, std::memory_order_relaxed);
+        slot.sequence.store(pos + mask + 1, std::memory_order_release);
+
+        // pairs with the fence in Push()
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (producerWaitingNum.load(std::memory_order_relaxed) > 0) {
+            {
+                std::unique_lock lock(mutex);
+            }
+            producerCondition.notify_all();
+        }
+        return true;
+    }
+
+    template <typename T>
+    bool MpscRing<T>::Empty() const
+    {
+        const auto pos = popPos.load(std::memory_order_relaxed);
+        return slots[pos & mask].sequence.load(std::memory_order_acquire) != pos + 1;
+    }
+
+    template <typename T>
+    template <typename F>
+    void MpscRing<T>::Wait(F&& inWakeCondition)
+    {
+        consumerWaiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        {
+            std::unique_lock lock(mutex);
+            consumerCondition.wait(lock, [&]() -> bool { return !Empty() || inWakeCondition(); });
         }
+        consumerWaiting.store(false, std::memory_order_relaxed);
     }
 
-    template <typename Ret>
-    auto ThreadPool::EmplaceTaskInternal(Common::SharedPtr<std::packaged_task<Ret()>> packedTask)
+    template <typename T>
+    void MpscRing<T>::NotifyConsumer()
     {
-        auto result = packedTask->get_future();
         {
             std::unique_lock lock(mutex);
-            Assert(!stop);
-            tasks.emplace([packedTask]() -> void { (*packedTask)(); });
         }
-        condition.notify_one();
+        consumerCondition.notify_one();
+    }
+
+    template <typename T>
+    size_t MpscRing<T>::Capacity() const
+    {
+        return mask + 1;
+    }
+
+    template <typename T>
+    size_t MpscRing<T>::Size() const
+    {
+        return pushPos.load(std::memory_order_relaxed) - popPos.load(std::memory_order_relaxed);
+    }
+
+    template <typename T>
+    bool MpscRing<T>::Full() const
+    {
+        const auto pos = pushPos.load(std::memory_order_relaxed);
+        return static_cast<intptr_t>(slots[pos & mask].sequence.load(std::memory_order_acquire)) - static_cast<intptr_t>(pos) < 0;
+    }
+
+    template <typename F>
+    auto ThreadPool::EmplaceTask(F&& task)
+    {
+        using RetType = std::invoke_result_t<F>;
+        std::packaged_task<RetType()> packagedTask(std::forward<F>(task));
+        auto result = packagedTask.get_future();
+        PostTask(std::move(packagedTask));
         return result;
     }
 
+    template <typename F>
+    void ThreadPool::PostTask(F&& task)
+    {
+        Assert(!stop.load(std::memory_order_relaxed));
+        Submit(UniqueTask(std::forward<F>(task)));
+    }
+
+    template <typename F>
+    void ThreadPool::ExecuteTasks(size_t taskNum, F&& task)
+    {
+        ParallelFor(0, taskNum, 1, std::forward<F>(task));
+    }
+
+    template <typename F>
+    void ThreadPool::ParallelFor(size_t inBegin, size_t inEnd, size_t inGrainSize, F&& inFunc)
+    {
+        Assert(inGrainSize > 0);
+        if (inBegin >= inEnd) {
+            return;
+        }
+        TaskGroup group;
+        ParallelForRange(group, inBegin, inEnd, inGrainSize, inFunc);
+        Wait(group);
+    }
+
+    template <typename F>
+    void ThreadPool::Run(TaskGroup& inGroup, F&& inTask)
+    {
+        Assert(!stop.load(std::memory_order_relaxed));
+        inGroup.pendingNum.fetch_add(1, std::memory_order_relaxed);
+        Submit(UniqueTask([this, &inGroup, task = std::forward<F>(inTask)]() mutable -> void {
+            task();
+            FinishGroupTask(inGroup);
+        }));
+    }
+
+    template <typename F>
+    void ThreadPool::ParallelForRange(TaskGroup& inGroup, size_t inBegin, size_t inEnd, size_t inGrainSize, F& inFunc)
+    {
+        // the upper half is handed to the pool and the lower half is kept, so a thief always gets the largest piece left
+        while (inEnd - inBegin > inGrainSize) {
+            const auto middle = inBegin + (inEnd - inBegin) / 2;
+            Run(inGroup, [this, &inGroup, middle, inEnd, inGrainSize, &inFunc]() -> void {
+                ParallelForRange(inGroup, middle, inEnd, inGrainSize, inFunc);
+            });
+            inEnd = middle;
+        }
+        for (auto i = inBegin; i < inEnd; i++) {
+            inFunc(i);
+        }
+    }
+
     template <typename F>
     auto WorkerThread::EmplaceTask(F&& task)
     {
         using RetType = std::invoke_result_t<F>;
-        auto packagedTask = Common::MakeShared<std::packaged_task<RetType()>>(task);
-        auto result = packagedTask->get_future();
-        {
-            std::unique_lock lock(mutex);
-            Assert(!stop);
-            tasks.emplace([packagedTask]() -> void { (*packagedTask)(); });
-        }
-        taskCondition.notify_one();
+        std::packaged_task<RetType()> packagedTask(std::forward<F>(task));
+        auto result = packagedTask.get_future();
+        PostTask(std::move(packagedTask));
         return result;
     }
+
+    template <typename F>
+    void WorkerThread::PostTask(F&& task)
+    {
+        Assert(!stop.load(std::memory_order_relaxed));
+        UniqueTask uniqueTask(std::forward<F>(task));
+        if (InThread()) {
+            PostLocal(std::move(uniqueTask));
+            return;
+        }
+        tasks.Push(std::move(uniqueTask));
+    }
 }
@@ -0,0 +1,469 @@
+//
+// Created by johnk on 2026/10/18.
+//
+
+#pragma once
+
+#include <vector>
+#include <mutex>
+#include <algorithm>
+#include <condition_variable>
+#include <atomic>
+#include <future>
+#include <chrono>
+#include <utility>
+#include <optional>
+#include <concepts>
+#include <coroutine>
+#include <type_traits>
+
+#include <Common/Debug.h>
+#include <Common/Utility.h>
+#include <Common/Concurrent.h>
+
+// Coroutine jobs on top of the engine executors, a job suspended on something not ready yet gives its thread back to
+// the executor instead of blocking it. Awaitables that can not be woken up by an event (futures, GPU fences) are polled,
+// each poll is a task posted to the executor, a failed poll is re-posted by the poll scheduler after a delay growing
+// with the number of failed polls, so a long wait neither spins the executor nor delays a short one much.
+namespace Common {
+    // anything accepting fire-and-forget tasks, e.g. ThreadPool, WorkerThread
+    template <typename E> concept TaskExecutor = requires(E& executor, UniqueTask&& task) { executor.PostTask(std::move(task)); };
+    // e.g. RHI::Fence
+    template <typename S> concept Signalable = requires(S& signalable) { { signalable.IsSignaled() } -> std::convertible_to<bool>; };
+}
+
+namespace Common::Internal {
+    template <TaskExecutor E> class FrameBarrierAwaiter;
+
+    // timer thread holding the deferred polls, each is posted back to its executor once its delay expired
+    class PollScheduler {
+    public:
+        static PollScheduler& Get();
+
+        ~PollScheduler();
+
+        NonCopyable(PollScheduler)
+        NonMovable(PollScheduler)
+
+        void Schedule(std::chrono::steady_clock::duration inDelay, UniqueTask&& inTask);
+
+    private:
+        struct Entry {
+            std::chrono::steady_clock::time_point time;
+            uint64_t order;
+            UniqueTask task;
+        };
+
+        PollScheduler();
+
+        static bool LaterEntry(const Entry& inLhs, const Entry& inRhs);
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        // min heap on (time, order)
+        std::vector<Entry> entries;
+        uint64_t nextOrder;
+        bool stop;
+        NamedThread thread;
+    };
+}
+
+namespace Common {
+    // Lazily started coroutine job, the body begins when it is co_await-ed or handed to Spawn()/SyncWait(), and the
+    // awaiting coroutine continues on the thread that finished the job.
+    template <typename T = void>
+    class CoTask {
+    public:
+        struct promise_type;
+        using Handle = std::coroutine_handle<promise_type>;
+
+        CoTask();
+        explicit CoTask(Handle inHandle);
+        CoTask(CoTask&& inOther) noexcept;
+        ~CoTask();
+
+        NonCopyable(CoTask)
+        CoTask& operator=(CoTask&& inOther) noexcept;
+
+        bool Valid() const;
+        bool Done() const;
+        auto operator co_await() && noexcept;
+
+    private:
+        Handle handle;
+    };
+
+    // starts inTask on inExecutor and forgets it, the coroutine frame frees itself once the job finished
+    template <TaskExecutor E> void Spawn(E& inExecutor, CoTask<void>&& inTask);
+    // runs inTask on the calling thread until its first suspension, then blocks until it finished, for the boundary
+    // between blocking code and coroutines, e.g. tests and shutdown
+    template <typename T> T SyncWait(CoTask<T>&& inTask);
+
+    // co_await ResumeOn(executor) moves the rest of the coroutine onto executor
+    template <TaskExecutor E> auto ResumeOn(E& inExecutor);
+    // resumes on inExecutor once inPredicate() returns true
+    template <TaskExecutor E, typename F> auto WaitUntil(E& inExecutor, F&& inPredicate);
+    // resumes on inExecutor once inSignalable is signaled, inSignalable must outlive the wait
+    template <TaskExecutor E, Signalable S> auto WaitSignaled(E& inExecutor, S& inSignalable);
+    // resumes on inExecutor once inFuture is ready, co_await yields the value of the future
+    template <TaskExecutor E, typename T> auto WaitFuture(E& inExecutor, std::future<T>&& inFuture);
+
+    // Resumes every coroutine waiting on it when Signal() is called, e.g. at the beginning of each frame. Unlike the
+    // polled awaitables, waiting costs nothing until the signal.
+    class FrameBarrier {
+    public:
+        FrameBarrier();
+        ~FrameBarrier();
+
+        NonCopyable(FrameBarrier)
+        NonMovable(FrameBarrier)
+
+        // co_await barrier.Wait(executor) always suspends, and resumes on executor after the next Signal()
+        template <TaskExecutor E> auto Wait(E& inExecutor);
+        void Signal();
+        uint64_t SignaledNum() const;
+        size_t WaitingNum() const;
+
+    private:
+        template <TaskExecutor E> friend class Internal::FrameBarrierAwaiter;
+
+        void Enqueue(UniqueTask&& inResumeTask);
+
+        mutable std::mutex mutex;
+        std::vector<UniqueTask> waiters;
+        std::atomic<uint64_t> signaledNum;
+    };
+}
+
+namespace Common::Internal {
+    template <typename T>
+    struct CoTaskResult {
+        template <typename V> void return_value(V&& inValue)
+        {
+            value.emplace(std::forward<V>(inValue));
+        }
+
+        T TakeResult()
+        {
+            Assert(value.has_value());
+            return std::move(*value);
+        }
+
+        std::optional<T> value;
+    };
+
+    template <>
+    struct CoTaskResult<void> {
+        void return_void() {}
+        void TakeResult() {}
+    };
+
+    // fire-and-forget coroutine, the frame is destroyed when the body returns
+    struct DetachedCoroutine {
+        struct promise_type {
+            DetachedCoroutine get_return_object() { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { QuickFail(); }
+        };
+    };
+
+    template <TaskExecutor E>
+    DetachedCoroutine RunDetached(E& inExecutor, CoTask<void> inTask)
+    {
+        co_await ResumeOn(inExecutor);
+        co_await std::move(inTask);
+    }
+
+    template <typename T>
+    DetachedCoroutine RunAndNotify(CoTask<T> inTask, std::promise<T> inPromise)
+    {
+        // the promise lives in this frame, so the waiting thread never destroys it while it is being set
+        if constexpr (std::is_void_v<T>) {
+            co_await std::move(inTask);
+            inPromise.set_value();
+        } else {
+            inPromise.set_value(co_await std::move(inTask));
+        }
+    }
+
+    template <TaskExecutor E>
+    class ResumeOnAwaiter {
+    public:
+        explicit ResumeOnAwaiter(E& inExecutor)
+            : executor(inExecutor)
+        {
+        }
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> inHandle)
+        {
+            executor.PostTask([inHandle]() -> void { inHandle.resume(); });
+        }
+
+        void await_resume() const noexcept {}
+
+    private:
+        E& executor;
+    };
+
+    // each failed poll schedules the next one with a doubled delay, the awaiter lives in the suspended coroutine frame so
+    // the posted tasks may refer to it, Derived provides Ready() and await_resume()
+    template <TaskExecutor E, typename Derived>
+    class PollAwaiter {
+    public:
+        static constexpr std::chrono::microseconds minPollDelay = std::chrono::microseconds(20);
+        static constexpr std::chrono::microseconds maxPollDelay = std::chrono::microseconds(2000);
+
+        explicit PollAwaiter(E& inExecutor)
+            : executor(inExecutor)
+            , pollDelay(minPollDelay)
+        {
+        }
+
+        bool await_ready()
+        {
+            return static_cast<Derived*>(this)->Ready();
+        }
+
+        void await_suspend(std::coroutine_handle<> inHandle)
+        {
+            handle = inHandle;
+            PostPoll();
+        }
+
+    private:
+        void PostPoll()
+        {
+            executor.PostTask([this]() -> void {
+                if (static_cast<Derived*>(this)->Ready()) {
+                    handle.resume();
+                    return;
+                }
+                const auto delay = pollDelay;
+                pollDelay = std::min(pollDelay * 2, maxPollDelay);
+                PollScheduler::Get().Schedule(delay, [this]() -> void { PostPoll(); });
+            });
+        }
+
+        E& executor;
+        std::coroutine_handle<> handle;
+        std::chrono::microseconds pollDelay;
+    };
+
+    template <TaskExecutor E, typename F>
+    class PredicateAwaiter : public PollAwaiter<E, PredicateAwaiter<E, F>> {
+    public:
+        PredicateAwaiter(E& inExecutor, F inPredicate)
+            : PollAwaiter<E, PredicateAwaiter<E, F>>(inExecutor)
+            , predicate(std::move(inPredicate))
+        {
+        }
+
+        bool Ready() { return predicate(); }
+        void await_resume() const noexcept {}
+
+    private:
+        F predicate;
+    };
+
+    template <TaskExecutor E, Signalable S>
+    class SignalAwaiter : public PollAwaiter<E, SignalAwaiter<E, S>> {
+    public:
+        SignalAwaiter(E& inExecutor, S& inSignalable)
+            : PollAwaiter<E, SignalAwaiter<E, S>>(inExecutor)
+            , signalable(inSignalable)
+        {
+        }
+
+        bool Ready() { return signalable.IsSignaled(); }
+        void await_resume() const noexcept {}
+
+    private:
+        S& signalable;
+    };
+
+    template <TaskExecutor E, typename T>
+    class FutureAwaiter : public PollAwaiter<E, FutureAwaiter<E, T>> {
+    public:
+        FutureAwaiter(E& inExecutor, std::future<T>&& inFuture)
+            : PollAwaiter<E, FutureAwaiter<E, T>>(inExecutor)
+            , future(std::move(inFuture))
+        {
+            Assert(future.valid());
+        }
+
+        bool Ready() { return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }
+        T await_resume() { return future.get(); }
+
+    private:
+        std::future<T> future;
+    };
+
+    template <TaskExecutor E>
+    class FrameBarrierAwaiter {
+    public:
+        FrameBarrierAwaiter(FrameBarrier& inBarrier, E& inExecutor)
+            : barrier(inBarrier)
+            , executor(inExecutor)
+        {
+        }
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> inHandle)
+        {
+            barrier.Enqueue([executor = &executor, inHandle]() -> void {
+                executor->PostTask([inHandle]() -> void { inHandle.resume(); });
+            });
+        }
+
+        void await_resume() const noexcept {}
+
+    private:
+        FrameBarrier& barrier;
+        E& executor;
+    };
+}
+
+namespace Common {
+    template <typename T>
+    struct CoTask<T>::promise_type : Internal::CoTaskResult<T> {
+        struct FinalAwaiter {
+            bool await_ready() const noexcept { return false; }
+
+            // symmetric transfer to the awaiting coroutine, instead of resuming it from inside the finishing frame
+            std::coroutine_handle<> await_suspend(Handle inHandle) noexcept
+            {
+                const auto continuation = inHandle.promise().continuation;
+                return continuation ? continuation : std::noop_coroutine();
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        CoTask get_return_object() { return CoTask(Handle::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        FinalAwaiter final_suspend() noexcept { return {}; }
+        void unhandled_exception() { QuickFail(); }
+
+        std::coroutine_handle<> continuation;
+    };
+
+    template <typename T>
+    CoTask<T>::CoTask()
+        : handle(nullptr)
+    {
+    }
+
+    template <typename T>
+    CoTask<T>::CoTask(Handle inHandle)
+        : handle(inHandle)
+    {
+    }
+
+    template <typename T>
+    CoTask<T>::CoTask(CoTask&& inOther) noexcept
+        : handle(std::exchange(inOther.handle, nullptr))
+    {
+    }
+
+    template <typename T>
+    CoTask<T>::~CoTask()
+    {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    template <typename T>
+    CoTask<T>& CoTask<T>::operator=(CoTask&& inOther) noexcept
+    {
+        if (this != &inOther) {
+            if (handle) {
+                handle.destroy();
+            }
+            handle = std::exchange(inOther.handle, nullptr);
+        }
+        return *this;
+    }
+
+    template <typename T>
+    bool CoTask<T>::Valid() const
+    {
+        return static_cast<bool>(handle);
+    }
+
+    template <typename T>
+    bool CoTask<T>::Done() const
+    {
+        return handle && handle.done();
+    }
+
+    template <typename T>
+    auto CoTask<T>::operator co_await() && noexcept
+    {
+        struct Awaiter {
+            bool await_ready() const noexcept { return handle.done(); }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> inContinuation) noexcept
+            {
+                handle.promise().continuation = inContinuation;
+                return handle;
+            }
+
+            T await_resume() { return handle.promise().TakeResult(); }
+
+            Handle handle;
+        };
+        Assert(Valid());
+        return Awaiter { handle };
+    }
+
+    template <TaskExecutor E>
+    void Spawn(E& inExecutor, CoTask<void>&& inTask)
+    {
+        Internal::RunDetached(inExecutor, std::move(inTask));
+    }
+
+    template <typename T>
+    T SyncWait(CoTask<T>&& inTask)
+    {
+        std::promise<T> promise;
+        auto future = promise.get_future();
+        Internal::RunAndNotify<T>(std::move(inTask), std::move(promise));
+        return future.get();
+    }
+
+    template <TaskExecutor E>
+    auto ResumeOn(E& inExecutor)
+    {
+        return Internal::ResumeOnAwaiter<E>(inExecutor);
+    }
+
+    template <TaskExecutor E, typename F>
+    auto WaitUntil(E& inExecutor, F&& inPredicate)
+    {
+        return Internal::PredicateAwaiter<E, std::decay_t<F>>(inExecutor, std::forward<F>(inPredicate));
+    }
+
+    template <TaskExecutor E, Signalable S>
+    auto WaitSignaled(E& inExecutor, S& inSignalable)
+    {
+        return Internal::SignalAwaiter<E, S>(inExecutor, inSignalable);
+    }
+
+    template <TaskExecutor E, typename T>
+    auto WaitFuture(E& inExecutor, std::future<T>&& inFuture)
+    {
+        return Internal::FutureAwaiter<E, T>(inExecutor, std::move(inFuture));
+    }
+
+    template <TaskExecutor E>
+    auto FrameBarrier::Wait(E& inExecutor)
+    {
+        return Internal::FrameBarrierAwaiter<E>(*this, inExecutor);
+    }
+}
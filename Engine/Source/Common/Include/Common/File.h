@@ -5,10 +5,12 @@
 #pragma once
 
 #include <string>
+#include <cstdint>
 
 #include <rapidjson/document.h>
 
 #include <Common/Result.h>
+#include <Common/Utility.h>
 
 namespace Common {
     class FileUtils {
@@ -18,4 +20,26 @@ namespace Common {
         static Result<rapidjson::Document, std::string> ReadJsonFile(const std::string& inFileName);
         static Result<void, std::string> WriteJsonFile(const std::string& inFileName, const rapidjson::Document& inJsonDocument, bool inPretty = true);
     };
+
+    // read-only memory mapping of a whole file, the mapped bytes stay valid until the MappedFile is destroyed
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::string& inFileName);
+        ~MappedFile();
+
+        NonCopyable(MappedFile)
+        MappedFile(MappedFile&& inOther) noexcept;
+        MappedFile& operator=(MappedFile&& inOther) noexcept;
+
+        bool IsValid() const;
+        const uint8_t* Data() const;
+        size_t Size() const;
+
+    private:
+        void Unmap();
+
+        bool valid;
+        const uint8_t* data;
+        size_t size;
+    };
 }
@@ -336,6 +336,12 @@ namespace Common { // NOLINT
         }
     };
 
+    template <BulkSerializable T, uint8_t R, uint8_t C, MathBackend B> requires (sizeof(Mat<T, R, C, B>) == R * C * sizeof(T))
+    struct BulkSerializeTraits<Mat<T, R, C, B>> {
+        static constexpr bool bulk = true;
+        using ElementType = typename BulkSerializeTraits<T>::ElementType;
+    };
+
     template <StringConvertible T, uint8_t R, uint8_t C, MathBackend B>
     struct StringConverter<Mat<T, R, C, B>> {
         static std::string ToString(const Mat<T, R, C, B>& inValue)
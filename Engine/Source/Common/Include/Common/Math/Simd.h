@@ -64,6 +64,18 @@ namespace Common::Simd {
         r2 = { s0.lanes[2], s1.lanes[2], s2.lanes[2], s3.lanes[2] };
         r3 = { s0.lanes[3], s1.lanes[3], s2.lanes[3], s3.lanes[3] };
     }
+
+    template <int N>
+    inline void ByteSwapLanes16(uint8_t* p)
+    {
+        for (int lane = 0; lane < 16; lane += N) {
+            for (int i = 0; i < N / 2; i++) {
+                const uint8_t tmp = p[lane + i];
+                p[lane + i] = p[lane + N - 1 - i];
+                p[lane + N - 1 - i] = tmp;
+            }
+        }
+    }
 #elif ARCH_X86
     using F32x4 = __m128;
 
@@ -97,6 +109,22 @@ namespace Common::Simd {
     {
         _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
     }
+
+    // Reverses the bytes of every N-byte lane (N = 2, 4 or 8) of the 16 bytes at p, in place. SSE2 has no byte shuffle,
+    // so the 16-bit words of each lane are reversed first and the two bytes of each word are swapped with shifts.
+    template <int N>
+    inline void ByteSwapLanes16(uint8_t* p)
+    {
+        static_assert(N == 2 || N == 4 || N == 8);
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        if constexpr (N == 4) {
+            v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+        } else if constexpr (N == 8) {
+            v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3)), _MM_SHUFFLE(0, 1, 2, 3));
+        }
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+    }
 #elif ARCH_ARM
     using F32x4 = float32x4_t;
 
@@ -139,6 +167,21 @@ namespace Common::Simd {
         r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
         r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
     }
+
+    // Reverses the bytes of every N-byte lane (N = 2, 4 or 8) of the 16 bytes at p, in place.
+    template <int N>
+    inline void ByteSwapLanes16(uint8_t* p)
+    {
+        static_assert(N == 2 || N == 4 || N == 8);
+        const uint8x16_t v = vld1q_u8(p);
+        if constexpr (N == 2) {
+            vst1q_u8(p, vrev16q_u8(v));
+        } else if constexpr (N == 4) {
+            vst1q_u8(p, vrev32q_u8(v));
+        } else {
+            vst1q_u8(p, vrev64q_u8(v));
+        }
+    }
 #endif
 
     // Safe partial load/store for tight 3-float storage (a Vec3, or one row of a Mat3). Load3 reads exactly three
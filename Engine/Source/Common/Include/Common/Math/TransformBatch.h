@@ -0,0 +1,193 @@
+//
+// Created by johnk on 2026/10/18.
+//
+
+#pragma once
+
+#include <span>
+
+#include <Common/Debug.h>
+#include <Common/Math/Simd.h>
+#include <Common/Math/Matrix.h>
+#include <Common/Math/Quaternion.h>
+#include <Common/Math/Transform.h>
+
+// Batch kernels over spans of transforms, e.g. the component columns of a chunk. Quaternion/transform to matrix
+// conversions run four elements per iteration in SoA form (four quaternions are transposed into x/y/z/w registers, the
+// nine rotation terms are computed lane-wise, and the rows are transposed back), any <4 tail falls back to the scalar
+// single-element path. The affine compositions treat the last row of both operands as (0, 0, 0, 1) and skip it.
+namespace Common {
+    // outMatrices[i] = inQuats[i].GetRotationMatrix()
+    inline void BatchQuatToMatrix(std::span<const FQuat> inQuats, std::span<FMat4x4> outMatrices);
+    // outMatrices[i] = inTransforms[i].GetTransformMatrix()
+    inline void BatchTransformToMatrix(std::span<const FTransform> inTransforms, std::span<FMat4x4> outMatrices);
+    // outMatrices[i] = inParents[i] * inChildren[i], all affine, outMatrices may alias inChildren
+    inline void BatchMulAffine(std::span<const FMat4x4> inParents, std::span<const FMat4x4> inChildren, std::span<FMat4x4> outMatrices);
+}
+
+namespace Common::Internal {
+    static_assert(sizeof(FQuat) == 4 * sizeof(float));
+    static_assert(sizeof(FMat4x4) == 16 * sizeof(float));
+
+    struct RotationLanes {
+        Simd::F32x4 m[3][3];
+    };
+
+    // four quaternions to the upper 3x3 of their rotation matrices, lane i of m[r][c] is element (r, c) of quaternion i
+    inline RotationLanes QuatToRotationLanes(Simd::F32x4 inX, Simd::F32x4 inY, Simd::F32x4 inZ, Simd::F32x4 inW)
+    {
+        const Simd::F32x4 one = Simd::Set1(1.0f);
+        const Simd::F32x4 x2 = Simd::Add(inX, inX);
+        const Simd::F32x4 y2 = Simd::Add(inY, inY);
+        const Simd::F32x4 z2 = Simd::Add(inZ, inZ);
+
+        const Simd::F32x4 xx2 = Simd::Mul(inX, x2);
+        const Simd::F32x4 yy2 = Simd::Mul(inY, y2);
+        const Simd::F32x4 zz2 = Simd::Mul(inZ, z2);
+        const Simd::F32x4 wx2 = Simd::Mul(inW, x2);
+        const Simd::F32x4 wy2 = Simd::Mul(inW, y2);
+        const Simd::F32x4 wz2 = Simd::Mul(inW, z2);
+        const Simd::F32x4 xy2 = Simd::Mul(inX, y2);
+        const Simd::F32x4 xz2 = Simd::Mul(inX, z2);
+        const Simd::F32x4 yz2 = Simd::Mul(inY, z2);
+
+        RotationLanes result;
+        result.m[0][0] = Simd::Sub(Simd::Sub(one, yy2), zz2);
+        result.m[0][1] = Simd::Add(xy2, wz2);
+        result.m[0][2] = Simd::Sub(xz2, wy2);
+        result.m[1][0] = Simd::Sub(xy2, wz2);
+        result.m[1][1] = Simd::Sub(Simd::Sub(one, xx2), zz2);
+        result.m[1][2] = Simd::Add(yz2, wx2);
+        result.m[2][0] = Simd::Add(xz2, wy2);
+        result.m[2][1] = Simd::Sub(yz2, wx2);
+        result.m[2][2] = Simd::Sub(Simd::Sub(one, xx2), yy2);
+        return result;
+    }
+
+    // lane i of inRows[r][c] goes to element (r, c) of outMatrices[i], the last row is set to (0, 0, 0, 1)
+    inline void StoreAffineLanes(const Simd::F32x4 (&inRows)[3][4], FMat4x4* outMatrices)
+    {
+        const Simd::F32x4 lastRow = Simd::Set(0.0f, 0.0f, 0.0f, 1.0f);
+        for (auto r = 0; r < 3; r++) {
+            Simd::F32x4 m0 = inRows[r][0];
+            Simd::F32x4 m1 = inRows[r][1];
+            Simd::F32x4 m2 = inRows[r][2];
+            Simd::F32x4 m3 = inRows[r][3];
+            Simd::Transpose4(m0, m1, m2, m3);
+            Simd::StoreU(&outMatrices[0].data[r * 4], m0);
+            Simd::StoreU(&outMatrices[1].data[r * 4], m1);
+            Simd::StoreU(&outMatrices[2].data[r * 4], m2);
+            Simd::StoreU(&outMatrices[3].data[r * 4], m3);
+        }
+        for (auto i = 0; i < 4; i++) {
+            Simd::StoreU(&outMatrices[i].data[12], lastRow);
+        }
+    }
+
+    inline void MulAffine(const FMat4x4& inParent, const FMat4x4& inChild, FMat4x4& outMatrix)
+    {
+        const Simd::F32x4 c0 = Simd::LoadU(&inChild.data[0]);
+        const Simd::F32x4 c1 = Simd::LoadU(&inChild.data[4]);
+        const Simd::F32x4 c2 = Simd::LoadU(&inChild.data[8]);
+        const Simd::F32x4 lastRow = Simd::Set(0.0f, 0.0f, 0.0f, 1.0f);
+
+        // the rows are computed before storing, outMatrix may alias inChild
+        Simd::F32x4 rows[3];
+        for (auto r = 0; r < 3; r++) {
+            const Simd::F32x4 p = Simd::LoadU(&inParent.data[r * 4]);
+            rows[r] = Simd::Add(
+                Simd::Add(
+                    Simd::Mul(Simd::Splat<0>(p), c0),
+                    Simd::Mul(Simd::Splat<1>(p), c1)),
+                Simd::Add(
+                    Simd::Mul(Simd::Splat<2>(p), c2),
+                    Simd::Mul(Simd::Splat<3>(p), lastRow)));
+        }
+        for (auto r = 0; r < 3; r++) {
+            Simd::StoreU(&outMatrix.data[r * 4], rows[r]);
+        }
+        Simd::StoreU(&outMatrix.data[12], lastRow);
+    }
+}
+
+namespace Common {
+    inline void BatchQuatToMatrix(std::span<const FQuat> inQuats, std::span<FMat4x4> outMatrices)
+    {
+        Assert(inQuats.size() == outMatrices.size());
+        const Simd::F32x4 zero = Simd::Set1(0.0f);
+
+        size_t i = 0;
+        for (; i + 4 <= inQuats.size(); i += 4) {
+            // one quaternion per register, transposed into one component per register
+            Simd::F32x4 x = Simd::LoadU(&inQuats[i + 0].x);
+            Simd::F32x4 y = Simd::LoadU(&inQuats[i + 1].x);
+            Simd::F32x4 z = Simd::LoadU(&inQuats[i + 2].x);
+            Simd::F32x4 w = Simd::LoadU(&inQuats[i + 3].x);
+            Simd::Transpose4(x, y, z, w);
+
+            const auto rotation = Internal::QuatToRotationLanes(x, y, z, w);
+            const Simd::F32x4 rows[3][4] = {
+                { rotation.m[0][0], rotation.m[0][1], rotation.m[0][2], zero },
+                { rotation.m[1][0], rotation.m[1][1], rotation.m[1][2], zero },
+                { rotation.m[2][0], rotation.m[2][1], rotation.m[2][2], zero }
+            };
+            Internal::StoreAffineLanes(rows, &outMatrices[i]);
+        }
+        for (; i < inQuats.size(); i++) {
+            outMatrices[i] = inQuats[i].GetRotationMatrix();
+        }
+    }
+
+    inline void BatchTransformToMatrix(std::span<const FTransform> inTransforms, std::span<FMat4x4> outMatrices)
+    {
+        Assert(inTransforms.size() == outMatrices.size());
+
+        size_t i = 0;
+        for (; i + 4 <= inTransforms.size(); i += 4) {
+            const auto& t0 = inTransforms[i + 0];
+            const auto& t1 = inTransforms[i + 1];
+            const auto& t2 = inTransforms[i + 2];
+            const auto& t3 = inTransforms[i + 3];
+
+            // one quaternion per register, transposed into one component per register
+            Simd::F32x4 x = Simd::LoadU(&t0.rotation.x);
+            Simd::F32x4 y = Simd::LoadU(&t1.rotation.x);
+            Simd::F32x4 z = Simd::LoadU(&t2.rotation.x);
+            Simd::F32x4 w = Simd::LoadU(&t3.rotation.x);
+            Simd::Transpose4(x, y, z, w);
+
+            // translate * rotate * scale, column c of the rotation is scaled by scale[c]
+            const auto rotation = Internal::QuatToRotationLanes(x, y, z, w);
+            const Simd::F32x4 scale[3] = {
+                Simd::Set(t0.scale.x, t1.scale.x, t2.scale.x, t3.scale.x),
+                Simd::Set(t0.scale.y, t1.scale.y, t2.scale.y, t3.scale.y),
+                Simd::Set(t0.scale.z, t1.scale.z, t2.scale.z, t3.scale.z)
+            };
+            const Simd::F32x4 translation[3] = {
+                Simd::Set(t0.translation.x, t1.translation.x, t2.translation.x, t3.translation.x),
+                Simd::Set(t0.translation.y, t1.translation.y, t2.translation.y, t3.translation.y),
+                Simd::Set(t0.translation.z, t1.translation.z, t2.translation.z, t3.translation.z)
+            };
+
+            Simd::F32x4 rows[3][4];
+            for (auto r = 0; r < 3; r++) {
+                for (auto c = 0; c < 3; c++) {
+                    rows[r][c] = Simd::Mul(rotation.m[r][c], scale[c]);
+                }
+                rows[r][3] = translation[r];
+            }
+            Internal::StoreAffineLanes(rows, &outMatrices[i]);
+        }
+        for (; i < inTransforms.size(); i++) {
+            outMatrices[i] = inTransforms[i].GetTransformMatrix();
+        }
+    }
+
+    inline void BatchMulAffine(std::span<const FMat4x4> inParents, std::span<const FMat4x4> inChildren, std::span<FMat4x4> outMatrices)
+    {
+        Assert(inParents.size() == inChildren.size() && inChildren.size() == outMatrices.size());
+        for (size_t i = 0; i < inChildren.size(); i++) {
+            Internal::MulAffine(inParents[i], inChildren[i], outMatrices[i]);
+        }
+    }
+}
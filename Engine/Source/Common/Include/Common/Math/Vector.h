@@ -246,6 +246,12 @@ namespace Common {
         }
     };
 
+    template <BulkSerializable T, uint8_t L, MathBackend B> requires (sizeof(Vec<T, L, B>) == L * sizeof(T))
+    struct BulkSerializeTraits<Vec<T, L, B>> {
+        static constexpr bool bulk = true;
+        using ElementType = typename BulkSerializeTraits<T>::ElementType;
+    };
+
     template <StringConvertible T, uint8_t L, MathBackend B>
     struct StringConverter<Vec<T, L, B>> {
         static std::string ToString(const Vec<T, L, B>& inValue)
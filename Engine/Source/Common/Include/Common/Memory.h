@@ -4,8 +4,13 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <Common/Utility.h>
 
@@ -109,6 +114,90 @@ namespace Common {
 
     template <typename T, typename... Args> UniquePtr<T> MakeUnique(Args&&... args);
     template <typename T, typename... Args> SharedPtr<T> MakeShared(Args&&... args);
+
+    struct FrameArenaStats {
+        // allocations served by the arena, each of them would be a heap allocation without it
+        size_t allocationNum;
+        size_t allocatedBytes;
+        // heap allocations of the arena itself, only happens when the recycled blocks run out
+        size_t blockAllocationNum;
+    };
+
+    // Linear allocator for transient per-frame data, memory is bumped out of large blocks and never freed one by one. The
+    // arena is split into bufferNum buffers, NextFrame() switches to the oldest buffer and recycles its blocks, so memory
+    // allocated in a frame stays valid until bufferNum - 1 more frames begin. Allocate() is thread-safe, NextFrame() must
+    // not run concurrently with it.
+    class FrameArena {
+    public:
+        static constexpr size_t bufferNum = 3;
+        static constexpr size_t defaultBlockSize = 256 * 1024;
+
+        explicit FrameArena(size_t inBlockSize = defaultBlockSize);
+        ~FrameArena();
+
+        NonCopyable(FrameArena)
+        NonMovable(FrameArena)
+
+        void* Allocate(size_t inSize, size_t inAlignment);
+        void NextFrame();
+        FrameArenaStats CurrentFrameStats() const;
+        FrameArenaStats LastFrameStats() const;
+        size_t ReservedBytes() const;
+
+    private:
+        struct Block {
+            explicit Block(size_t inSize);
+
+            std::unique_ptr<uint8_t[]> memory;
+            size_t size;
+            std::atomic<size_t> offset;
+        };
+
+        struct Buffer {
+            Buffer();
+
+            std::vector<std::unique_ptr<Block>> blocks;
+            size_t currentBlockIndex;
+            std::atomic<Block*> currentBlock;
+            std::atomic<size_t> allocationNum;
+            std::atomic<size_t> allocatedBytes;
+            std::atomic<size_t> blockAllocationNum;
+        };
+
+        static void* TryAllocate(Block& inBlock, size_t inSize, size_t inAlignment);
+        static FrameArenaStats GetStats(const Buffer& inBuffer);
+
+        size_t blockSize;
+        size_t bufferIndex;
+        std::array<Buffer, bufferNum> buffers;
+        FrameArenaStats lastFrameStats;
+        mutable std::mutex mutex;
+    };
+
+    // STL allocator over a FrameArena, deallocate() is a no-op, containers using it must be destroyed before the memory is
+    // recycled by the arena
+    template <typename T>
+    class FrameAllocator {
+    public:
+        using value_type = T;
+
+        FrameAllocator(FrameArena& inArena) noexcept; // NOLINT
+        template <typename T2> FrameAllocator(const FrameAllocator<T2>& inOther) noexcept; // NOLINT
+
+        T* allocate(size_t inNum);
+        void deallocate(T* inPointer, size_t inNum) noexcept;
+        template <typename T2> bool operator==(const FrameAllocator<T2>& inRhs) const noexcept;
+        FrameArena& Arena() const;
+
+    private:
+        template <typename T2> friend class FrameAllocator;
+
+        FrameArena* arena;
+    };
+
+    template <typename T> using FrameVector = std::vector<T, FrameAllocator<T>>;
+    template <typename K, typename V, typename H = std::hash<K>, typename E = std::equal_to<K>> using FrameUnorderedMap = std::unordered_map<K, V, H, E, FrameAllocator<std::pair<const K, V>>>;
+    template <typename T, typename H = std::hash<T>, typename E = std::equal_to<T>> using FrameUnorderedSet = std::unordered_set<T, H, E, FrameAllocator<T>>;
 }
 
 namespace Common {
@@ -512,4 +601,41 @@ namespace Common {
     {
         return Common::SharedPtr<T>(new T(std::forward<Args>(args)...));
     }
+
+    template <typename T>
+    FrameAllocator<T>::FrameAllocator(FrameArena& inArena) noexcept
+        : arena(&inArena)
+    {
+    }
+
+    template <typename T>
+    template <typename T2>
+    FrameAllocator<T>::FrameAllocator(const FrameAllocator<T2>& inOther) noexcept
+        : arena(inOther.arena)
+    {
+    }
+
+    template <typename T>
+    T* FrameAllocator<T>::allocate(size_t inNum)
+    {
+        return static_cast<T*>(arena->Allocate(inNum * sizeof(T), alignof(T)));
+    }
+
+    template <typename T>
+    void FrameAllocator<T>::deallocate(T* inPointer, size_t inNum) noexcept
+    {
+    }
+
+    template <typename T>
+    template <typename T2>
+    bool FrameAllocator<T>::operator==(const FrameAllocator<T2>& inRhs) const noexcept
+    {
+        return arena == inRhs.arena;
+    }
+
+    template <typename T>
+    FrameArena& FrameAllocator<T>::Arena() const
+    {
+        return *arena;
+    }
 }
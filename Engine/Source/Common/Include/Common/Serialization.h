@@ -6,6 +6,8 @@
 
 #include <cstdint>
 #include <cmath>
+#include <cstring>
+#include <algorithm>
 #include <fstream>
 #include <string>
 #include <optional>
@@ -17,6 +19,8 @@
 #include <set>
 #include <map>
 #include <variant>
+#include <memory>
+#include <functional>
 
 #include <rapidjson/document.h>
 
@@ -26,22 +30,52 @@
 #include <Common/String.h>
 #include <Common/FileSystem.h>
 #include <Common/File.h>
+#include <Common/Math/Simd.h>
 
 namespace Common {
+    // Per-stream state of a serializer, e.g. the class schema table of the reflected class serializer. The stream owns
+    // it, so the state never outlives the file it describes.
+    class SerializeStreamContext {
+    public:
+        virtual ~SerializeStreamContext();
+
+        // context of a size counting pass over the stream, it sees the state of this context but keeps its own changes
+        // apart, so the counting pass writes exactly what the following real pass will write
+        virtual std::unique_ptr<SerializeStreamContext> Fork() const;
+    };
+
     class BinarySerializeStream {
     public:
         NonCopyable(BinarySerializeStream)
         virtual ~BinarySerializeStream();
 
         template <CppArithmetic T> void Write(const T& value);
+        // writes count values with one WriteInternal() call, or one call per byte-swapped chunk when the stream endian
+        // differs from the native one
+        template <CppArithmetic T> void WriteArray(const T* values, size_t count);
         virtual void Seek(int64_t offset) = 0;
         virtual size_t Loc() = 0;
         virtual std::endian Endian() = 0;
+        // false for the forward-only streams, e.g. pipes, sockets and compressors, Seek() is not allowed on them and the
+        // serializers write their size prefixes after a size counting pass instead of back-patching, the written bytes
+        // are the same as the seekable streams'
+        virtual bool Seekable() const;
+
+        // writes reflected classes in the schema table format: one schema per class per stream, instances reference
+        // members by schema index instead of carrying their names. The deserialize stream of the file must enable it too.
+        void EnableSchemaTable();
+        bool SchemaTableEnabled() const;
+        SerializeStreamContext* GetContext() const;
+        void SetContext(std::unique_ptr<SerializeStreamContext>&& inContext);
 
     protected:
         BinarySerializeStream();
 
         virtual void WriteInternal(const void* data, size_t size) = 0;
+
+    private:
+        bool schemaTable;
+        std::unique_ptr<SerializeStreamContext> context;
     };
 
     class BinaryDeserializeStream {
@@ -50,14 +84,27 @@ namespace Common {
         virtual ~BinaryDeserializeStream();
 
         template <CppArithmetic T> void Read(T& value);
+        // reads count values with one ReadInternal() call and byte-swaps them in place if needed
+        template <CppArithmetic T> void ReadArray(T* values, size_t count);
         virtual void Seek(int64_t offset) = 0;
         virtual size_t Loc() = 0;
         virtual std::endian Endian() = 0;
+        // total bytes of the stream, Loc() is within [0, Size()]
+        virtual size_t Size() const = 0;
+
+        void EnableSchemaTable();
+        bool SchemaTableEnabled() const;
+        SerializeStreamContext* GetContext() const;
+        void SetContext(std::unique_ptr<SerializeStreamContext>&& inContext);
 
     protected:
         BinaryDeserializeStream();
 
         virtual void ReadInternal(void* data, size_t size) = 0;
+
+    private:
+        bool schemaTable;
+        std::unique_ptr<SerializeStreamContext> context;
     };
 
     template <std::endian E = std::endian::little>
@@ -89,6 +136,7 @@ namespace Common {
         void Seek(int64_t offset) override;
         size_t Loc() override;
         std::endian Endian() override;
+        size_t Size() const override;
         void Close();
 
     protected:
@@ -99,6 +147,108 @@ namespace Common {
         size_t fileSize;
     };
 
+    // Collects writes in a user-space window and writes it to the file in one call when a write falls outside of it, so
+    // seeking back to patch a header that is still in the window (e.g. by FieldSerializer) costs no file operation.
+    // Writes behind the flushed part of the file or larger than the window go to the file directly.
+    template <std::endian E = std::endian::little>
+    class BufferedFileSerializeStream final : public BinarySerializeStream {
+    public:
+        static constexpr size_t defaultBufferSize = 4 * 1024 * 1024;
+
+        NonCopyable(BufferedFileSerializeStream)
+        explicit BufferedFileSerializeStream(const std::string& inFileName, size_t inBufferSize = defaultBufferSize);
+        ~BufferedFileSerializeStream() override;
+
+        void Seek(int64_t offset) override;
+        size_t Loc() override;
+        std::endian Endian() override;
+        void Flush();
+        void Close();
+
+    protected:
+        void WriteInternal(const void* data, size_t size) override;
+
+    private:
+        void WriteFile(size_t inPosition, const void* inData, size_t inSize);
+
+        std::ofstream file;
+        std::vector<uint8_t> buffer;
+        // file position of buffer[0]
+        size_t bufferBegin;
+        // bytes of the buffer written so far
+        size_t bufferSize;
+        // end of the bytes already written to the file, the window always begins at or after it
+        size_t flushedEnd;
+        size_t pointer;
+    };
+
+    // Maps the whole file and reads by moving a pointer over the mapped bytes, no file operation after the open.
+    template <std::endian E = std::endian::little>
+    class MappedFileDeserializeStream final : public BinaryDeserializeStream {
+    public:
+        NonCopyable(MappedFileDeserializeStream)
+        explicit MappedFileDeserializeStream(const std::string& inFileName);
+        ~MappedFileDeserializeStream() override;
+
+        void Seek(int64_t offset) override;
+        size_t Loc() override;
+        std::endian Endian() override;
+        size_t Size() const override;
+        bool IsValid() const;
+
+    protected:
+        void ReadInternal(void* data, size_t size) override;
+
+    private:
+        MappedFile file;
+        size_t pointer;
+    };
+
+    // Forward-only stream handing the written bytes to a sink in order, e.g. a pipe, a socket or a compression stage.
+    template <std::endian E = std::endian::little>
+    class SinkSerializeStream final : public BinarySerializeStream {
+    public:
+        using Sink = std::function<void(const void*, size_t)>;
+
+        NonCopyable(SinkSerializeStream)
+        explicit SinkSerializeStream(Sink inSink);
+        ~SinkSerializeStream() override;
+
+        void Seek(int64_t offset) override;
+        size_t Loc() override;
+        std::endian Endian() override;
+        bool Seekable() const override;
+
+    protected:
+        void WriteInternal(const void* data, size_t size) override;
+
+    private:
+        Sink sink;
+        size_t pointer;
+    };
+
+    // Discards the written bytes and only counts them, it takes the endian, schema table mode and a fork of the context
+    // of the stream the counting pass is made for.
+    class SizeCountSerializeStream final : public BinarySerializeStream {
+    public:
+        NonCopyable(SizeCountSerializeStream)
+        explicit SizeCountSerializeStream(BinarySerializeStream& inStream);
+        ~SizeCountSerializeStream() override;
+
+        void Seek(int64_t offset) override;
+        size_t Loc() override;
+        std::endian Endian() override;
+        size_t Size() const;
+
+    protected:
+        void WriteInternal(const void* data, size_t size) override;
+
+    private:
+        std::endian endian;
+        size_t pointer;
+        size_t end;
+    };
+
     template <std::endian E = std::endian::little>
     class MemorySerializeStream final : public BinarySerializeStream {
     public:
@@ -123,21 +273,40 @@ namespace Common {
     public:
         NonCopyable(MemoryDeserializeStream)
         explicit MemoryDeserializeStream(const std::vector<uint8_t>& inBytes, size_t pointerBegin = 0);
+        // reads from an external range, e.g. a mapped file, the range must outlive the stream
+        MemoryDeserializeStream(const uint8_t* inData, size_t inSize, size_t pointerBegin = 0);
         ~MemoryDeserializeStream() override;
 
         void Seek(int64_t offset) override;
         std::endian Endian() override;
         size_t Loc() override;
+        size_t Size() const override;
 
     protected:
         void ReadInternal(void* data, size_t size) override;
 
     private:
         size_t pointer;
-        const std::vector<uint8_t>& bytes;
+        const uint8_t* data;
+        size_t size;
     };
 
     template <typename T> struct Serializer {};
+
+    // Types whose Serializer writes exactly their object representation as a sequence of ElementType values, so a
+    // contiguous range of them is serialized with WriteArray()/ReadArray() instead of element by element. Specialize it
+    // next to the Serializer of such a type.
+    template <typename T> struct BulkSerializeTraits {
+        static constexpr bool bulk = false;
+    };
+
+    template <CppArithmeticNonBool T> struct BulkSerializeTraits<T> {
+        static constexpr bool bulk = true;
+        using ElementType = T;
+    };
+
+    template <typename T> concept BulkSerializable = BulkSerializeTraits<T>::bulk;
+
     template <typename T> concept Serializable = requires(T inValue, BinarySerializeStream& serializeStream, BinaryDeserializeStream& deserializeStream)
     {
         { Serializer<T>::typeId } -> std::convertible_to<uint32_t>;
@@ -187,17 +356,8 @@ namespace Common {
     }; \
 
 namespace Common::Internal {
-    inline std::vector<uint8_t> SwapEndian(const void* data, const size_t size)
-    {
-        std::vector<uint8_t> result;
-        result.resize(size);
-
-        const auto* bytes = static_cast<const uint8_t*>(data);
-        for (auto i = 0; i < size; i++) {
-            result[i] = bytes[size - 1 - i];
-        }
-        return result;
-    }
+    // bytes of the stack buffer WriteArray() swaps through when the endian differs
+    constexpr size_t swapChunkSize = 4096;
 
     inline void SwapEndianInplace(void* data, size_t size)
     {
@@ -206,6 +366,43 @@ namespace Common::Internal {
             std::swap(bytes[i], bytes[size - 1 - i]);
         }
     }
+
+    // swaps count values of N bytes each, 16 bytes per iteration, the tail one by one
+    template <size_t N>
+    void SwapEndianArrayInplace(void* data, size_t count)
+    {
+        if constexpr (N > 1) {
+            auto* bytes = static_cast<uint8_t*>(data);
+            const size_t size = count * N;
+            size_t i = 0;
+            if constexpr (N == 2 || N == 4 || N == 8) {
+                for (; i + 16 <= size; i += 16) {
+                    Simd::ByteSwapLanes16<N>(bytes + i);
+                }
+            }
+            for (; i < size; i += N) {
+                SwapEndianInplace(bytes + i, N);
+            }
+        }
+    }
+
+    template <typename T>
+    const typename BulkSerializeTraits<T>::ElementType* BulkElements(const T* values)
+    {
+        return reinterpret_cast<const typename BulkSerializeTraits<T>::ElementType*>(values);
+    }
+
+    template <typename T>
+    typename BulkSerializeTraits<T>::ElementType* BulkElements(T* values)
+    {
+        return reinterpret_cast<typename BulkSerializeTraits<T>::ElementType*>(values);
+    }
+
+    template <typename T>
+    constexpr size_t BulkElementNum(size_t count)
+    {
+        return count * (sizeof(T) / sizeof(typename BulkSerializeTraits<T>::ElementType));
+    }
 }
 
 namespace Common {
@@ -215,8 +412,30 @@ namespace Common {
         if (std::endian::native == Endian()) {
             WriteInternal(&value, sizeof(T));
         } else {
-            const auto swapped = Internal::SwapEndian(&value, sizeof(T));
-            WriteInternal(reinterpret_cast<const char*>(swapped.data()), static_cast<std::streamsize>(swapped.size()));
+            T swapped = value;
+            Internal::SwapEndianInplace(&swapped, sizeof(T));
+            WriteInternal(&swapped, sizeof(T));
+        }
+    }
+
+    template <CppArithmetic T>
+    void BinarySerializeStream::WriteArray(const T* values, size_t count)
+    {
+        if (count == 0) {
+            return;
+        }
+        if (sizeof(T) == 1 || std::endian::native == Endian()) {
+            WriteInternal(values, count * sizeof(T));
+            return;
+        }
+
+        constexpr size_t chunkCount = Internal::swapChunkSize / sizeof(T);
+        alignas(16) T chunk[chunkCount];
+        for (size_t i = 0; i < count; i += chunkCount) {
+            const size_t num = std::min(chunkCount, count - i);
+            memcpy(chunk, values + i, num * sizeof(T));
+            Internal::SwapEndianArrayInplace<sizeof(T)>(chunk, num);
+            WriteInternal(chunk, num * sizeof(T));
         }
     }
 
@@ -229,6 +448,18 @@ namespace Common {
         }
     }
 
+    template <CppArithmetic T>
+    void BinaryDeserializeStream::ReadArray(T* values, size_t count)
+    {
+        if (count == 0) {
+            return;
+        }
+        ReadInternal(values, count * sizeof(T));
+        if (std::endian::native != Endian()) {
+            Internal::SwapEndianArrayInplace<sizeof(T)>(values, count);
+        }
+    }
+
     template <std::endian E>
     BinaryFileSerializeStream<E>::BinaryFileSerializeStream(const std::string& inFileName)
     {
@@ -322,6 +553,12 @@ namespace Common {
         return E;
     }
 
+    template <std::endian E>
+    size_t BinaryFileDeserializeStream<E>::Size() const
+    {
+        return fileSize;
+    }
+
     template <std::endian E>
     void BinaryFileDeserializeStream<E>::Close()
     {
@@ -335,6 +572,151 @@ namespace Common {
         }
     }
 
+    template <std::endian E>
+    BufferedFileSerializeStream<E>::BufferedFileSerializeStream(const std::string& inFileName, size_t inBufferSize)
+        : bufferBegin(0)
+        , bufferSize(0)
+        , flushedEnd(0)
+        , pointer(0)
+    {
+        Assert(inBufferSize > 0);
+        if (const auto parentPath = Common::Path(inFileName).Parent();
+            !parentPath.Exists()) {
+            parentPath.MakeDir();
+        }
+        file = std::ofstream(inFileName, std::ios::binary);
+        buffer.resize(inBufferSize);
+    }
+
+    template <std::endian E>
+    BufferedFileSerializeStream<E>::~BufferedFileSerializeStream()
+    {
+        Close();
+    }
+
+    template <std::endian E>
+    void BufferedFileSerializeStream<E>::WriteInternal(const void* data, const size_t size)
+    {
+        if (pointer >= bufferBegin && pointer + size <= bufferBegin + buffer.size()) {
+            const auto offset = pointer - bufferBegin;
+            // bytes skipped by a forward seek, they are patched later or stay zero as in a sparse file
+            if (offset > bufferSize) {
+                memset(buffer.data() + bufferSize, 0, offset - bufferSize);
+            }
+            memcpy(buffer.data() + offset, data, size);
+            bufferSize = std::max(bufferSize, offset + size);
+        } else {
+            Flush();
+            if (pointer < flushedEnd || size >= buffer.size()) {
+                WriteFile(pointer, data, size);
+                bufferBegin = std::max(flushedEnd, pointer + size);
+            } else {
+                bufferBegin = pointer;
+                memcpy(buffer.data(), data, size);
+                bufferSize = size;
+            }
+        }
+        pointer += size;
+    }
+
+    template <std::endian E>
+    void BufferedFileSerializeStream<E>::Seek(int64_t offset)
+    {
+        pointer += offset;
+    }
+
+    template <std::endian E>
+    size_t BufferedFileSerializeStream<E>::Loc()
+    {
+        return pointer;
+    }
+
+    template <std::endian E>
+    std::endian BufferedFileSerializeStream<E>::Endian()
+    {
+        return E;
+    }
+
+    template <std::endian E>
+    void BufferedFileSerializeStream<E>::Flush()
+    {
+        if (bufferSize > 0) {
+            WriteFile(bufferBegin, buffer.data(), bufferSize);
+        }
+        bufferBegin = std::max(flushedEnd, pointer);
+        bufferSize = 0;
+    }
+
+    template <std::endian E>
+    void BufferedFileSerializeStream<E>::Close()
+    {
+        if (!file.is_open()) {
+            return;
+        }
+        Flush();
+        try {
+            file.close();
+        } catch (const std::exception&) {
+            QuickFail();
+        }
+    }
+
+    template <std::endian E>
+    void BufferedFileSerializeStream<E>::WriteFile(size_t inPosition, const void* inData, size_t inSize)
+    {
+        file.seekp(static_cast<std::streamoff>(inPosition), std::ios::beg);
+        file.write(static_cast<const char*>(inData), static_cast<std::streamsize>(inSize));
+        flushedEnd = std::max(flushedEnd, inPosition + inSize);
+    }
+
+    template <std::endian E>
+    MappedFileDeserializeStream<E>::MappedFileDeserializeStream(const std::string& inFileName)
+        : file(inFileName)
+        , pointer(0)
+    {
+    }
+
+    template <std::endian E>
+    MappedFileDeserializeStream<E>::~MappedFileDeserializeStream() = default;
+
+    template <std::endian E>
+    void MappedFileDeserializeStream<E>::ReadInternal(void* data, const size_t size)
+    {
+        Assert(pointer + size <= file.Size());
+        memcpy(data, file.Data() + pointer, size);
+        pointer += size;
+    }
+
+    template <std::endian E>
+    void MappedFileDeserializeStream<E>::Seek(int64_t offset)
+    {
+        pointer += offset;
+    }
+
+    template <std::endian E>
+    size_t MappedFileDeserializeStream<E>::Loc()
+    {
+        return pointer;
+    }
+
+    template <std::endian E>
+    std::endian MappedFileDeserializeStream<E>::Endian()
+    {
+        return E;
+    }
+
+    template <std::endian E>
+    size_t MappedFileDeserializeStream<E>::Size() const
+    {
+        return file.Size();
+    }
+
+    template <std::endian E>
+    bool MappedFileDeserializeStream<E>::IsValid() const
+    {
+        return file.IsValid();
+    }
+
     template <std::endian E>
     MemorySerializeStream<E>::MemorySerializeStream(std::vector<uint8_t>& inBytes, const size_t pointerBegin)
         : pointer(pointerBegin)
@@ -380,21 +762,28 @@ namespace Common {
 
     template <std::endian E>
     MemoryDeserializeStream<E>::MemoryDeserializeStream(const std::vector<uint8_t>& inBytes, const size_t pointerBegin)
+        : MemoryDeserializeStream(inBytes.data(), inBytes.size(), pointerBegin)
+    {
+    }
+
+    template <std::endian E>
+    MemoryDeserializeStream<E>::MemoryDeserializeStream(const uint8_t* inData, const size_t inSize, const size_t pointerBegin)
         : pointer(pointerBegin)
-        , bytes(inBytes)
+        , data(inData)
+        , size(inSize)
     {
-        Assert(pointer <= bytes.size());
+        Assert(pointer <= size);
     }
 
     template <std::endian E>
     MemoryDeserializeStream<E>::~MemoryDeserializeStream() = default;
 
     template <std::endian E>
-    void MemoryDeserializeStream<E>::ReadInternal(void* data, const size_t size)
+    void MemoryDeserializeStream<E>::ReadInternal(void* outData, const size_t inSize)
     {
-        const auto newPointer = pointer + size;
-        Assert(newPointer <= bytes.size());
-        memcpy(data, bytes.data() + pointer, size);
+        const auto newPointer = pointer + inSize;
+        Assert(newPointer <= size);
+        memcpy(outData, data + pointer, inSize);
         pointer = newPointer;
     }
 
@@ -416,6 +805,53 @@ namespace Common {
         return E;
     }
 
+    template <std::endian E>
+    size_t MemoryDeserializeStream<E>::Size() const
+    {
+        return size;
+    }
+
+    template <std::endian E>
+    SinkSerializeStream<E>::SinkSerializeStream(Sink inSink)
+        : sink(std::move(inSink))
+        , pointer(0)
+    {
+    }
+
+    template <std::endian E>
+    SinkSerializeStream<E>::~SinkSerializeStream() = default;
+
+    template <std::endian E>
+    void SinkSerializeStream<E>::WriteInternal(const void* data, const size_t size)
+    {
+        sink(data, size);
+        pointer += size;
+    }
+
+    template <std::endian E>
+    void SinkSerializeStream<E>::Seek(int64_t offset)
+    {
+        QuickFailWithReason("seek on a forward-only stream");
+    }
+
+    template <std::endian E>
+    size_t SinkSerializeStream<E>::Loc()
+    {
+        return pointer;
+    }
+
+    template <std::endian E>
+    std::endian SinkSerializeStream<E>::Endian()
+    {
+        return E;
+    }
+
+    template <std::endian E>
+    bool SinkSerializeStream<E>::Seekable() const
+    {
+        return false;
+    }
+
     template <typename T>
     size_t Serialize(BinarySerializeStream& inStream, const T& inValue)
     {
@@ -515,6 +951,15 @@ namespace Common {
             Header header;
             header.typeId = Serializer<T>::typeId;
 
+            if (!stream.Seekable()) {
+                SizeCountSerializeStream sizeCountStream(stream);
+                header.contentSize = Serializer<T>::Serialize(sizeCountStream, value);
+                header.Serialize(stream);
+                const auto contentSize = Serializer<T>::Serialize(stream, value);
+                Assert(contentSize == header.contentSize);
+                return sizeof(Header) + contentSize;
+            }
+
             stream.Seek(sizeof(Header));
             header.contentSize = Serializer<T>::Serialize(stream, value);
             stream.Seek(-static_cast<int64_t>(sizeof(Header)) - static_cast<int64_t>(header.contentSize));
@@ -565,11 +1010,7 @@ namespace Common {
             const uint64_t size = value.size();
             serialized += Serializer<uint64_t>::Serialize(stream, size);
 
-            const auto* data = reinterpret_cast<const uint8_t*>(value.data());
-            for (auto i = 0; i < size; i++) {
-                stream.Write<uint8_t>(data[i]);
-            }
-
+            stream.WriteArray<uint8_t>(reinterpret_cast<const uint8_t*>(value.data()), size);
             serialized += size;
             return serialized;
         }
@@ -582,11 +1023,7 @@ namespace Common {
             deserialized += Serializer<uint64_t>::Deserialize(stream, size);
 
             value.resize(size);
-            auto* data = reinterpret_cast<uint8_t*>(value.data());
-            for (auto i = 0; i < size; i++) {
-                stream.Read<uint8_t>(data[i]);
-            }
-
+            stream.ReadArray<uint8_t>(reinterpret_cast<uint8_t*>(value.data()), size);
             deserialized += size;
             return deserialized;
         }
@@ -606,8 +1043,18 @@ namespace Common {
             serialized += Serializer<uint64_t>::Serialize(stream, size);
 
             const auto* data = static_cast<const std::wstring::value_type*>(value.data());
-            for (auto i = 0; i < size; i++) {
-                stream.Write<uint32_t>(static_cast<uint32_t>(data[i]));
+            if constexpr (sizeof(std::wstring::value_type) == sizeof(uint32_t)) {
+                stream.WriteArray<uint32_t>(reinterpret_cast<const uint32_t*>(data), size);
+            } else {
+                // widened through a stack buffer, one stream call per chunk
+                uint32_t chunk[Internal::swapChunkSize / sizeof(uint32_t)];
+                for (size_t i = 0; i < size; i += std::size(chunk)) {
+                    const auto num = std::min(std::size(chunk), static_cast<size_t>(size - i));
+                    for (size_t j = 0; j < num; j++) {
+                        chunk[j] = static_cast<uint32_t>(data[i + j]);
+                    }
+                    stream.WriteArray<uint32_t>(chunk, num);
+                }
             }
 
             serialized += size * sizeof(uint32_t);
@@ -623,10 +1070,17 @@ namespace Common {
 
             value.resize(size);
             auto* data = static_cast<std::wstring::value_type*>(value.data());
-            for (auto i = 0; i < size; i++) {
-                uint32_t tempValue;
-                stream.Read<uint32_t>(tempValue);
-                data[i] = static_cast<std::wstring::value_type>(tempValue);
+            if constexpr (sizeof(std::wstring::value_type) == sizeof(uint32_t)) {
+                stream.ReadArray<uint32_t>(reinterpret_cast<uint32_t*>(data), size);
+            } else {
+                uint32_t chunk[Internal::swapChunkSize / sizeof(uint32_t)];
+                for (size_t i = 0; i < size; i += std::size(chunk)) {
+                    const auto num = std::min(std::size(chunk), static_cast<size_t>(size - i));
+                    stream.ReadArray<uint32_t>(chunk, num);
+                    for (size_t j = 0; j < num; j++) {
+                        data[i + j] = static_cast<std::wstring::value_type>(chunk[j]);
+                    }
+                }
             }
 
             deserialized += size * sizeof(uint32_t);
@@ -708,8 +1162,13 @@ namespace Common {
             const uint64_t size = value.size();
             serialized += Serializer<uint64_t>::Serialize(stream, size);
 
-            for (const auto& element : value) {
-                serialized += Serializer<T>::Serialize(stream, element);
+            if constexpr (BulkSerializable<T>) {
+                stream.WriteArray(Internal::BulkElements(value.data()), Internal::BulkElementNum<T>(N));
+                serialized += N * sizeof(T);
+            } else {
+                for (const auto& element : value) {
+                    serialized += Serializer<T>::Serialize(stream, element);
+                }
             }
             return serialized;
         }
@@ -728,10 +1187,15 @@ namespace Common {
                 return deserialized;
             }
 
-            for (auto i = 0; i < size; i++) {
-                T element;
-                deserialized += Serializer<T>::Deserialize(stream, element);
-                value[i] = std::move(element);
+            if constexpr (BulkSerializable<T>) {
+                stream.ReadArray(Internal::BulkElements(value.data()), Internal::BulkElementNum<T>(N));
+                deserialized += N * sizeof(T);
+            } else {
+                for (auto i = 0; i < size; i++) {
+                    T element;
+                    deserialized += Serializer<T>::Deserialize(stream, element);
+                    value[i] = std::move(element);
+                }
             }
             return deserialized;
         }
@@ -750,8 +1214,13 @@ namespace Common {
             const uint64_t size = value.size();
             serialized += Serializer<uint64_t>::Serialize(stream, size);
 
-            for (auto i = 0; i < size; i++) {
-                serialized += Serializer<T>::Serialize(stream, value[i]);
+            if constexpr (BulkSerializable<T>) {
+                stream.WriteArray(Internal::BulkElements(value.data()), Internal::BulkElementNum<T>(size));
+                serialized += size * sizeof(T);
+            } else {
+                for (auto i = 0; i < size; i++) {
+                    serialized += Serializer<T>::Serialize(stream, value[i]);
+                }
             }
             return serialized;
         }
@@ -764,11 +1233,17 @@ namespace Common {
             uint64_t size;
             deserialized += Serializer<uint64_t>::Deserialize(stream, size);
 
-            value.reserve(size);
-            for (auto i = 0; i < size; i++) {
-                T element;
-                deserialized += Serializer<T>::Deserialize(stream, element);
-                value.emplace_back(std::move(element));
+            if constexpr (BulkSerializable<T>) {
+                value.resize(size);
+                stream.ReadArray(Internal::BulkElements(value.data()), Internal::BulkElementNum<T>(size));
+                deserialized += size * sizeof(T);
+            } else {
+                value.reserve(size);
+                for (auto i = 0; i < size; i++) {
+                    T element;
+                    deserialized += Serializer<T>::Deserialize(stream, element);
+                    value.emplace_back(std::move(element));
+                }
             }
             return deserialized;
         }
@@ -0,0 +1,291 @@
+//
+// Created by johnk on 2026/10/18.
+//
+
+#include <atomic>
+#include <limits>
+
+#include <lz4.h>
+
+#include <Common/Compression.h>
+#include <Common/Debug.h>
+
+namespace Common::Internal {
+    // false if the block does not decode to exactly inRawSize bytes
+    static bool DecodeBlock(const uint8_t* inStored, uint32_t inStoredSize, uint8_t* outRaw, uint32_t inRawSize)
+    {
+        if (inStoredSize == inRawSize) {
+            memcpy(outRaw, inStored, inRawSize);
+            return true;
+        }
+        const auto decodedSize = LZ4_decompress_safe(reinterpret_cast<const char*>(inStored), reinterpret_cast<char*>(outRaw), static_cast<int>(inStoredSize), static_cast<int>(inRawSize));
+        return decodedSize == static_cast<int>(inRawSize);
+    }
+}
+
+namespace Common {
+    CompressedSerializeStream::CompressedSerializeStream(BinarySerializeStream& inStream, size_t inBlockSize)
+        : stream(inStream)
+        , blockSize(inBlockSize)
+        , pointer(0)
+        , closed(false)
+    {
+        Assert(blockSize > 0 && blockSize <= std::numeric_limits<int32_t>::max());
+        block.reserve(blockSize);
+        compressed.resize(LZ4_compressBound(static_cast<int>(blockSize)));
+
+        stream.Write<uint32_t>(magic);
+        stream.Write<uint32_t>(static_cast<uint32_t>(blockSize));
+    }
+
+    CompressedSerializeStream::~CompressedSerializeStream()
+    {
+        if (!closed) {
+            Close();
+        }
+    }
+
+    void CompressedSerializeStream::Seek(int64_t offset)
+    {
+        QuickFailWithReason("seek on a forward-only stream");
+    }
+
+    size_t CompressedSerializeStream::Loc()
+    {
+        return pointer;
+    }
+
+    std::endian CompressedSerializeStream::Endian()
+    {
+        return stream.Endian();
+    }
+
+    bool CompressedSerializeStream::Seekable() const
+    {
+        return false;
+    }
+
+    void CompressedSerializeStream::Close()
+    {
+        Assert(!closed);
+        if (!block.empty()) {
+            FlushBlock();
+        }
+        stream.Write<uint32_t>(0);
+        stream.Write<uint32_t>(0);
+        closed = true;
+    }
+
+    void CompressedSerializeStream::WriteInternal(const void* data, size_t size)
+    {
+        Assert(!closed);
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        while (size > 0) {
+            const auto copySize = std::min(size, blockSize - block.size());
+            block.insert(block.end(), bytes, bytes + copySize);
+            if (block.size() == blockSize) {
+                FlushBlock();
+            }
+            bytes += copySize;
+            size -= copySize;
+            pointer += copySize;
+        }
+    }
+
+    void CompressedSerializeStream::FlushBlock()
+    {
+        const auto rawSize = static_cast<uint32_t>(block.size());
+        const auto compressedSize = LZ4_compress_default(reinterpret_cast<const char*>(block.data()), reinterpret_cast<char*>(compressed.data()), static_cast<int>(rawSize), static_cast<int>(compressed.size()));
+        const bool storeRaw = compressedSize <= 0 || static_cast<uint32_t>(compressedSize) >= rawSize;
+
+        stream.Write<uint32_t>(rawSize);
+        if (storeRaw) {
+            stream.Write<uint32_t>(rawSize);
+            stream.WriteArray<uint8_t>(block.data(), rawSize);
+        } else {
+            stream.Write<uint32_t>(static_cast<uint32_t>(compressedSize));
+            stream.WriteArray<uint8_t>(compressed.data(), compressedSize);
+        }
+        block.clear();
+    }
+
+    bool CompressedDeserializeStream::IsCompressed(BinaryDeserializeStream& inStream)
+    {
+        if (inStream.Size() - inStream.Loc() < sizeof(uint32_t)) {
+            return false;
+        }
+        uint32_t value = 0;
+        inStream.Read<uint32_t>(value);
+        inStream.Seek(-static_cast<int64_t>(sizeof(uint32_t)));
+        return value == CompressedSerializeStream::magic;
+    }
+
+    CompressedDeserializeStream::CompressedDeserializeStream(BinaryDeserializeStream& inStream, ThreadPool* inThreadPool)
+        : stream(inStream)
+        , blockSize(0)
+        , totalSize(0)
+        , pointer(0)
+        , corrupted(false)
+        , decodedAll(false)
+        , decodedBlockIndex(std::numeric_limits<size_t>::max())
+    {
+        if (!ReadBlockIndex()) {
+            corrupted = true;
+            blocks.clear();
+            totalSize = 0;
+            return;
+        }
+        if (inThreadPool != nullptr) {
+            DecodeAll(*inThreadPool);
+        }
+    }
+
+    CompressedDeserializeStream::~CompressedDeserializeStream() = default;
+
+    void CompressedDeserializeStream::Seek(int64_t offset)
+    {
+        // an offset out of range comes from a corrupted size, it is clamped and reported like ReadInternal() does
+        const auto distance = offset < 0 ? 0 - static_cast<size_t>(offset) : static_cast<size_t>(offset);
+        if (offset < 0 ? distance > pointer : distance > totalSize - pointer) {
+            corrupted = true;
+            pointer = offset < 0 ? 0 : totalSize;
+            return;
+        }
+        pointer = offset < 0 ? pointer - distance : pointer + distance;
+    }
+
+    size_t CompressedDeserializeStream::Loc()
+    {
+        return pointer;
+    }
+
+    std::endian CompressedDeserializeStream::Endian()
+    {
+        return stream.Endian();
+    }
+
+    size_t CompressedDeserializeStream::Size() const
+    {
+        return totalSize;
+    }
+
+    bool CompressedDeserializeStream::Corrupted() const
+    {
+        return corrupted;
+    }
+
+    void CompressedDeserializeStream::ReadInternal(void* data, size_t size)
+    {
+        if (corrupted || size > totalSize - pointer) {
+            corrupted = true;
+            memset(data, 0, size);
+            return;
+        }
+        if (decodedAll) {
+            memcpy(data, decoded.data() + pointer, size);
+            pointer += size;
+            return;
+        }
+
+        auto* bytes = static_cast<uint8_t*>(data);
+        while (size > 0) {
+            const auto blockIndex = pointer / blockSize;
+            if (blockIndex != decodedBlockIndex) {
+                DecodeBlock(blockIndex);
+                if (corrupted) {
+                    memset(bytes, 0, size);
+                    return;
+                }
+            }
+            const auto offset = pointer - blockIndex * blockSize;
+            const auto copySize = std::min(size, blocks[blockIndex].rawSize - offset);
+            memcpy(bytes, decoded.data() + offset, copySize);
+            bytes += copySize;
+            size -= copySize;
+            pointer += copySize;
+        }
+    }
+
+    bool CompressedDeserializeStream::ReadBlockIndex()
+    {
+        // every size is checked against the wrapped stream before it is used, so a truncated or corrupted file can not
+        // make the reads below run past its end
+        const auto streamSize = stream.Size();
+        constexpr auto headerSize = 2 * sizeof(uint32_t);
+        if (streamSize - stream.Loc() < headerSize) {
+            return false;
+        }
+        uint32_t streamMagic = 0;
+        uint32_t streamBlockSize = 0;
+        stream.Read<uint32_t>(streamMagic);
+        stream.Read<uint32_t>(streamBlockSize);
+        if (streamMagic != CompressedSerializeStream::magic || streamBlockSize == 0) {
+            return false;
+        }
+        blockSize = streamBlockSize;
+
+        while (true) {
+            if (streamSize - stream.Loc() < headerSize) {
+                return false;
+            }
+            Block block {};
+            stream.Read<uint32_t>(block.rawSize);
+            stream.Read<uint32_t>(block.storedSize);
+            if (block.rawSize == 0) {
+                return block.storedSize == 0;
+            }
+            // only the last block can be partial, and a block is only stored compressed if it shrinks
+            if ((!blocks.empty() && blocks.back().rawSize != blockSize) || block.rawSize > blockSize || block.storedSize > block.rawSize) {
+                return false;
+            }
+            block.storedLoc = stream.Loc();
+            if (streamSize - block.storedLoc < block.storedSize) {
+                return false;
+            }
+            stream.Seek(block.storedSize);
+            totalSize += block.rawSize;
+            blocks.emplace_back(block);
+        }
+    }
+
+    void CompressedDeserializeStream::DecodeAll(ThreadPool& inThreadPool)
+    {
+        // the wrapped stream is read on this thread, only the decoding goes parallel
+        std::vector<size_t> storedOffsets;
+        storedOffsets.reserve(blocks.size());
+        size_t storedSize = 0;
+        for (const auto& block : blocks) {
+            storedOffsets.emplace_back(storedSize);
+            storedSize += block.storedSize;
+        }
+        stored.resize(storedSize);
+        for (size_t i = 0; i < blocks.size(); i++) {
+            stream.Seek(static_cast<int64_t>(blocks[i].storedLoc) - static_cast<int64_t>(stream.Loc()));
+            stream.ReadArray<uint8_t>(stored.data() + storedOffsets[i], blocks[i].storedSize);
+        }
+
+        decoded.resize(totalSize);
+        std::atomic<bool> failed = false;
+        inThreadPool.ParallelFor(0, blocks.size(), 1, [&](size_t inIndex) -> void {
+            const auto& block = blocks[inIndex];
+            if (!Internal::DecodeBlock(stored.data() + storedOffsets[inIndex], block.storedSize, decoded.data() + inIndex * blockSize, block.rawSize)) {
+                failed.store(true, std::memory_order_relaxed);
+            }
+        });
+        stored.clear();
+        stored.shrink_to_fit();
+        decodedAll = true;
+        corrupted = failed.load(std::memory_order_relaxed);
+    }
+
+    void CompressedDeserializeStream::DecodeBlock(size_t inIndex)
+    {
+        const auto& block = blocks[inIndex];
+        stored.resize(block.storedSize);
+        decoded.resize(block.rawSize);
+        stream.Seek(static_cast<int64_t>(block.storedLoc) - static_cast<int64_t>(stream.Loc()));
+        stream.ReadArray<uint8_t>(stored.data(), block.storedSize);
+        corrupted = !Internal::DecodeBlock(stored.data(), block.storedSize, decoded.data(), block.rawSize);
+        decodedBlockIndex = inIndex;
+    }
+}
@@ -8,6 +8,8 @@
 #include <pthread.h>
 #endif
 
+#include <limits>
+
 #include <Common/Concurrent.h>
 #include <Common/String.h>
 
@@ -33,99 +35,427 @@ namespace Common {
 #endif
     }
 
+    UniqueTask::UniqueTask()
+        : storage()
+        , ops(nullptr)
+    {
+    }
+
+    UniqueTask::UniqueTask(UniqueTask&& inOther) noexcept
+        : storage()
+        , ops(inOther.ops)
+    {
+        if (ops != nullptr) {
+            ops->relocate(storage, inOther.storage);
+            inOther.ops = nullptr;
+        }
+    }
+
+    UniqueTask::~UniqueTask()
+    {
+        Reset();
+    }
+
+    UniqueTask& UniqueTask::operator=(UniqueTask&& inOther) noexcept
+    {
+        if (this == &inOther) {
+            return *this;
+        }
+        Reset();
+        ops = inOther.ops;
+        if (ops != nullptr) {
+            ops->relocate(storage, inOther.storage);
+            inOther.ops = nullptr;
+        }
+        return *this;
+    }
+
+    void UniqueTask::operator()()
+    {
+        Assert(ops != nullptr);
+        ops->invoke(storage);
+    }
+
+    UniqueTask::operator bool() const
+    {
+        return ops != nullptr;
+    }
+
+    void UniqueTask::Reset()
+    {
+        if (ops != nullptr) {
+            ops->destroy(storage);
+            ops = nullptr;
+        }
+    }
+
+    TaskGroup::TaskGroup()
+        : pendingNum(0)
+    {
+    }
+
+    TaskGroup::~TaskGroup()
+    {
+        Assert(Done());
+    }
+
+    bool TaskGroup::Done() const
+    {
+        return pendingNum.load(std::memory_order_acquire) == 0;
+    }
+
+    TaskGraph::TaskGraph()
+        : pendingPredecessorCapacity(0)
+    {
+    }
+
+    TaskGraph::~TaskGraph() = default;
+
+    TaskGraph::NodeId TaskGraph::Emplace(std::function<void()> inFunc)
+    {
+        auto& node = nodes.emplace_back();
+        node.func = std::move(inFunc);
+        node.predecessorNum = 0;
+        return nodes.size() - 1;
+    }
+
+    void TaskGraph::Precede(NodeId inBefore, NodeId inAfter)
+    {
+        Assert(inBefore < nodes.size() && inAfter < nodes.size() && inBefore != inAfter);
+        nodes[inBefore].successors.emplace_back(inAfter);
+        nodes[inAfter].predecessorNum++;
+    }
+
+    void TaskGraph::Clear()
+    {
+        nodes.clear();
+    }
+
+    size_t TaskGraph::Size() const
+    {
+        return nodes.size();
+    }
+
+    void TaskGraph::PrepareRun()
+    {
+        if (pendingPredecessorCapacity < nodes.size()) {
+            pendingPredecessorNums = std::make_unique<std::atomic<uint32_t>[]>(nodes.size());
+            pendingPredecessorCapacity = nodes.size();
+        }
+        for (size_t i = 0; i < nodes.size(); i++) {
+            pendingPredecessorNums[i].store(nodes[i].predecessorNum, std::memory_order_relaxed);
+        }
+    }
+
+    // worker identity of the calling thread, null for the threads outside any pool
+    static thread_local ThreadPool* currentPool = nullptr;
+    static thread_local size_t currentWorkerIndex = 0;
+
     ThreadPool::ThreadPool(const std::string& name, uint8_t threadNum)
         : stop(false)
+        , injectedTasks(taskQueueCapacity)
+        , wakeEpoch(0)
+        , sleepingNum(0)
+        , waitingNum(0)
+        , submittingNum(0)
     {
+        workerQueues.reserve(threadNum);
+        for (auto i = 0; i < threadNum; i++) {
+            workerQueues.emplace_back(std::make_unique<WorkerQueue>());
+        }
+
         threads.reserve(threadNum);
         for (auto i = 0; i < threadNum; i++) {
             std::string fullName = name + "-" + std::to_string(i);
-            threads.emplace_back(fullName, [this]() -> void {
-                while (true) {
-                    std::function<void()> task;
-                    {
-                        std::unique_lock lock(mutex);
-                        condition.wait(lock, [this]() -> bool { return stop || !tasks.empty(); });
-                        if (stop && tasks.empty()) {
-                            return;
-                        }
-                        task = std::move(tasks.front());
-                        tasks.pop();
-                    }
-                    task();
-                }
+            threads.emplace_back(fullName, [this, i]() -> void {
+                WorkerLoop(i);
             });
         }
     }
 
     ThreadPool::~ThreadPool()
     {
+        stop.store(true, std::memory_order_release);
         {
-            std::unique_lock lock(mutex);
-            stop = true;
+            std::unique_lock lock(sleepMutex);
         }
-        condition.notify_all();
+        sleepCondition.notify_all();
         for (auto& thread : threads) {
             thread.Join();
         }
+        // a thread outside the pool, e.g. a timer posting a poll, may still be waking the workers up for a task which
+        // already ran and let the owner destroy the pool
+        while (submittingNum.load(std::memory_order_acquire) != 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    void ThreadPool::Wait(TaskGroup& inGroup)
+    {
+        // pending tasks are executed while there are any, once the rest of the group is running elsewhere the thread sleeps
+        // with the workers until a task is submitted or a task of some group finishes
+        UniqueTask task;
+        while (true) {
+            const auto epoch = wakeEpoch.load(std::memory_order_seq_cst);
+            if (inGroup.Done()) {
+                return;
+            }
+            if (TryAcquire(task)) {
+                task();
+                task.Reset();
+                continue;
+            }
+
+            std::unique_lock lock(sleepMutex);
+            sleepingNum.fetch_add(1, std::memory_order_seq_cst);
+            waitingNum.fetch_add(1, std::memory_order_seq_cst);
+            sleepCondition.wait(lock, [&]() -> bool {
+                return inGroup.pendingNum.load(std::memory_order_seq_cst) == 0 || wakeEpoch.load(std::memory_order_seq_cst) != epoch;
+            });
+            waitingNum.fetch_sub(1, std::memory_order_seq_cst);
+            sleepingNum.fetch_sub(1, std::memory_order_seq_cst);
+        }
+    }
+
+    void ThreadPool::RunAndWait(TaskGraph& inGraph)
+    {
+        if (inGraph.nodes.empty()) {
+            return;
+        }
+
+        inGraph.PrepareRun();
+        TaskGroup group;
+        bool hasSource = false;
+        for (size_t i = 0; i < inGraph.nodes.size(); i++) {
+            if (inGraph.nodes[i].predecessorNum == 0) {
+                ScheduleGraphNode(inGraph, group, i);
+                hasSource = true;
+            }
+        }
+        AssertWithReason(hasSource, "task graph has no node without predecessors, it must contain a cycle");
+        Wait(group);
     }
 
+    uint8_t ThreadPool::ThreadNum() const
+    {
+        return static_cast<uint8_t>(threads.size());
+    }
+
+    bool ThreadPool::InWorker() const
+    {
+        return currentPool == this;
+    }
+
+    void ThreadPool::Submit(UniqueTask&& inTask)
+    {
+        if (InWorker()) {
+            {
+                auto& queue = *workerQueues[currentWorkerIndex];
+                std::unique_lock lock(queue.mutex);
+                queue.tasks.emplace_back(std::move(inTask));
+            }
+            WakeWorker();
+        } else {
+            submittingNum.fetch_add(1, std::memory_order_relaxed);
+            injectedTasks.Push(std::move(inTask));
+            WakeWorker();
+            submittingNum.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    bool ThreadPool::TryAcquire(UniqueTask& outTask)
+    {
+        const bool inWorker = InWorker();
+        if (inWorker) {
+            auto& queue = *workerQueues[currentWorkerIndex];
+            std::unique_lock lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                outTask = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+                return true;
+            }
+        }
+
+        if (injectedTasks.Size() > 0) {
+            std::unique_lock lock(injectedConsumerMutex);
+            if (injectedTasks.TryPop(outTask)) {
+                return true;
+            }
+        }
+
+        const auto queueNum = workerQueues.size();
+        const auto first = inWorker ? currentWorkerIndex + 1 : 0;
+        for (size_t i = 0; i < queueNum; i++) {
+            const auto victim = (first + i) % queueNum;
+            if (inWorker && victim == currentWorkerIndex) {
+                continue;
+            }
+            auto& queue = *workerQueues[victim];
+            std::unique_lock lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                outTask = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void ThreadPool::WakeWorker()
+    {
+        // pairs with the sleeping worker, either it sees the new epoch or we see it sleeping
+        wakeEpoch.fetch_add(1, std::memory_order_seq_cst);
+        if (sleepingNum.load(std::memory_order_seq_cst) > 0) {
+            {
+                std::unique_lock lock(sleepMutex);
+            }
+            sleepCondition.notify_one();
+        }
+    }
+
+    void ThreadPool::FinishGroupTask(TaskGroup& inGroup)
+    {
+        // pairs with the waiting thread, either it sees the group done or we see it waiting
+        if (inGroup.pendingNum.fetch_sub(1, std::memory_order_seq_cst) == 1 && waitingNum.load(std::memory_order_seq_cst) > 0) {
+            {
+                std::unique_lock lock(sleepMutex);
+            }
+            sleepCondition.notify_all();
+        }
+    }
+
+    void ThreadPool::WorkerLoop(size_t inWorkerIndex)
+    {
+        currentPool = this;
+        currentWorkerIndex = inWorkerIndex;
+
+        UniqueTask task;
+        while (true) {
+            const auto epoch = wakeEpoch.load(std::memory_order_seq_cst);
+            if (TryAcquire(task)) {
+                task();
+                task.Reset();
+                continue;
+            }
+            if (stop.load(std::memory_order_acquire)) {
+                break;
+            }
+
+            std::unique_lock lock(sleepMutex);
+            sleepingNum.fetch_add(1, std::memory_order_seq_cst);
+            sleepCondition.wait(lock, [&]() -> bool {
+                return stop.load(std::memory_order_acquire) || wakeEpoch.load(std::memory_order_seq_cst) != epoch;
+            });
+            sleepingNum.fetch_sub(1, std::memory_order_seq_cst);
+        }
+
+        currentPool = nullptr;
+    }
+
+    void ThreadPool::ScheduleGraphNode(TaskGraph& inGraph, TaskGroup& inGroup, TaskGraph::NodeId inNode)
+    {
+        Run(inGroup, [this, &inGraph, &inGroup, inNode]() -> void {
+            ExecuteGraphNode(inGraph, inGroup, inNode);
+        });
+    }
+
+    void ThreadPool::ExecuteGraphNode(TaskGraph& inGraph, TaskGroup& inGroup, TaskGraph::NodeId inNode)
+    {
+        // the first successor released by a node continues on the same thread, the others are handed to the pool
+        constexpr auto noneNode = std::numeric_limits<TaskGraph::NodeId>::max();
+        for (auto node = inNode; node != noneNode;) {
+            const auto& [func, successors, predecessorNum] = inGraph.nodes[node];
+            if (func) {
+                func();
+            }
+
+            node = noneNode;
+            for (const auto successor : successors) {
+                if (inGraph.pendingPredecessorNums[successor].fetch_sub(1, std::memory_order_acq_rel) != 1) {
+                    continue;
+                }
+                if (node == noneNode) {
+                    node = successor;
+                } else {
+                    ScheduleGraphNode(inGraph, inGroup, successor);
+                }
+            }
+        }
+    }
+
+    static thread_local const WorkerThread* currentWorkerThread = nullptr;
+
     WorkerThread::WorkerThread(const std::string& name)
         : stop(false)
-        , flush(false)
+        , tasks(taskQueueCapacity)
     {
         thread = NamedThread(name, [this]() -> void {
+            currentWorkerThread = this;
             while (true) {
-                bool needNotifyMainThread = false;
-                std::vector<std::function<void()>> tasksToExecute;
-                {
-                    std::unique_lock lock(mutex);
-                    taskCondition.wait(lock, [this]() -> bool { return stop || flush || !tasks.empty(); });
-                    if (stop && tasks.empty()) {
-                        return;
+                UniqueTask task;
+                while (!tasks.TryPop(task)) {
+                    if (!overflowTasks.empty()) {
+                        RunOverflowTasks();
+                        continue;
                     }
-                    if (flush) {
-                        tasksToExecute.reserve(tasks.size());
-                        while (!tasks.empty()) {
-                            tasksToExecute.emplace_back(std::move(tasks.front()));
-                            tasks.pop();
-                        }
-                        flush = false;
-                        needNotifyMainThread = true;
-                    } else {
-                        tasksToExecute.emplace_back(std::move(tasks.front()));
-                        tasks.pop();
+                    if (stop.load(std::memory_order_acquire)) {
+                        currentWorkerThread = nullptr;
+                        return;
                     }
+                    tasks.Wait([this]() -> bool { return stop.load(std::memory_order_acquire); });
                 }
-                for (auto& task : tasksToExecute) {
-                    task();
-                }
-                if (needNotifyMainThread) {
-                    flushCondition.notify_one();
-                }
+                task();
             }
         });
     }
 
     WorkerThread::~WorkerThread()
     {
-        {
-            std::unique_lock lock(mutex);
-            stop = true;
-        }
-        taskCondition.notify_all();
+        stop.store(true, std::memory_order_release);
+        tasks.NotifyConsumer();
         thread.Join();
     }
 
     void WorkerThread::Flush()
     {
-        {
-            std::unique_lock lock(mutex);
-            flush = true;
+        // tasks run in submission order, so all the tasks submitted before are done once this one is, except the spilled
+        // ones which run after the ring, the marker queues itself behind them
+        std::promise<void> done;
+        auto future = done.get_future();
+        PostTask([this, &done]() -> void { FinishFlush(done); });
+        future.wait();
+    }
+
+    bool WorkerThread::InThread() const
+    {
+        return currentWorkerThread == this;
+    }
+
+    void WorkerThread::PostLocal(UniqueTask&& inTask)
+    {
+        // once a task spilled, the later ones follow it to keep the submission order of the thread
+        if (overflowTasks.empty() && tasks.TryPush(std::move(inTask))) {
+            return;
         }
-        taskCondition.notify_one();
-        {
-            std::unique_lock lock(mutex);
-            flushCondition.wait(lock);
+        overflowTasks.emplace_back(std::move(inTask));
+    }
+
+    void WorkerThread::FinishFlush(std::promise<void>& outDone)
+    {
+        if (overflowTasks.empty()) {
+            outDone.set_value();
+            return;
+        }
+        overflowTasks.emplace_back([this, &outDone]() -> void { FinishFlush(outDone); });
+    }
+
+    void WorkerThread::RunOverflowTasks()
+    {
+        // the tasks posted by the overflow tasks go to the ring again, or to a fresh overflow list
+        std::swap(runningOverflowTasks, overflowTasks);
+        for (auto& task : runningOverflowTasks) {
+            task();
         }
+        runningOverflowTasks.clear();
     }
 }
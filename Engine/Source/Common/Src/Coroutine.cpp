@@ -0,0 +1,111 @@
+//
+// Created by johnk on 2026/10/18.
+//
+
+#include <Common/Coroutine.h>
+
+namespace Common::Internal {
+    PollScheduler& PollScheduler::Get()
+    {
+        static PollScheduler scheduler;
+        return scheduler;
+    }
+
+    PollScheduler::PollScheduler()
+        : nextOrder(0)
+        , stop(false)
+    {
+        thread = NamedThread("PollScheduler", [this]() -> void {
+            std::unique_lock lock(mutex);
+            while (!stop) {
+                if (entries.empty()) {
+                    condition.wait(lock);
+                    continue;
+                }
+                if (const auto time = entries.front().time;
+                    std::chrono::steady_clock::now() < time) {
+                    condition.wait_until(lock, time);
+                    continue;
+                }
+                std::pop_heap(entries.begin(), entries.end(), LaterEntry);
+                auto task = std::move(entries.back().task);
+                entries.pop_back();
+
+                // the task only posts the poll to its executor, a new schedule from another thread must not wait on it
+                lock.unlock();
+                task();
+                lock.lock();
+            }
+        });
+    }
+
+    PollScheduler::~PollScheduler()
+    {
+        {
+            std::unique_lock lock(mutex);
+            stop = true;
+        }
+        condition.notify_one();
+        thread.Join();
+    }
+
+    bool PollScheduler::LaterEntry(const Entry& inLhs, const Entry& inRhs)
+    {
+        return inLhs.time != inRhs.time ? inLhs.time > inRhs.time : inLhs.order > inRhs.order;
+    }
+
+    void PollScheduler::Schedule(std::chrono::steady_clock::duration inDelay, UniqueTask&& inTask)
+    {
+        bool earliest;
+        {
+            std::unique_lock lock(mutex);
+            entries.emplace_back(Entry { std::chrono::steady_clock::now() + inDelay, nextOrder++, std::move(inTask) });
+            std::push_heap(entries.begin(), entries.end(), LaterEntry);
+            earliest = entries.front().order == nextOrder - 1;
+        }
+        // the timer thread only needs to recompute its wake up time if the new entry comes first
+        if (earliest) {
+            condition.notify_one();
+        }
+    }
+}
+
+namespace Common {
+    FrameBarrier::FrameBarrier()
+        : signaledNum(0)
+    {
+    }
+
+    FrameBarrier::~FrameBarrier() = default;
+
+    void FrameBarrier::Signal()
+    {
+        // the resume tasks are run outside the lock, a resumed coroutine may wait on the barrier again
+        std::vector<UniqueTask> resumeTasks;
+        {
+            std::unique_lock lock(mutex);
+            signaledNum.fetch_add(1, std::memory_order_relaxed);
+            resumeTasks.swap(waiters);
+        }
+        for (auto& resumeTask : resumeTasks) {
+            resumeTask();
+        }
+    }
+
+    uint64_t FrameBarrier::SignaledNum() const
+    {
+        return signaledNum.load(std::memory_order_relaxed);
+    }
+
+    size_t FrameBarrier::WaitingNum() const
+    {
+        std::unique_lock lock(mutex);
+        return waiters.size();
+    }
+
+    void FrameBarrier::Enqueue(UniqueTask&& inResumeTask)
+    {
+        std::unique_lock lock(mutex);
+        waiters.emplace_back(std::move(inResumeTask));
+    }
+}
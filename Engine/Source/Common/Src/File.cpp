@@ -5,6 +5,7 @@
 #include <fstream>
 #include <cstdio>
 #include <format>
+#include <utility>
 
 #include <rapidjson/filereadstream.h>
 #include <rapidjson/filewritestream.h>
@@ -15,6 +16,15 @@
 #include <Common/File.h>
 #include <Common/FileSystem.h>
 
+#if PLATFORM_WINDOWS
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace Common {
     Result<std::string, std::string> FileUtils::ReadTextFile(const std::string& inFileName)
     {
@@ -93,4 +103,115 @@ namespace Common {
         (void) fclose(file);
         return Ok();
     }
+
+    // the views keep the mappings alive, so the file and mapping handles are closed right after mapping
+    MappedFile::MappedFile(const std::string& inFileName)
+        : valid(false)
+        , data(nullptr)
+        , size(0)
+    {
+#if PLATFORM_WINDOWS
+        HANDLE file = CreateFileA(inFileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return;
+        }
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize)) {
+            CloseHandle(file);
+            return;
+        }
+        size = static_cast<size_t>(fileSize.QuadPart);
+        if (size == 0) {
+            valid = true;
+            CloseHandle(file);
+            return;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping != nullptr) {
+            data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+        valid = data != nullptr;
+#else
+        const int file = open(inFileName.c_str(), O_RDONLY); // NOLINT
+        if (file < 0) {
+            return;
+        }
+        struct stat fileStat {};
+        if (fstat(file, &fileStat) != 0) {
+            close(file);
+            return;
+        }
+        size = static_cast<size_t>(fileStat.st_size);
+        if (size == 0) {
+            valid = true;
+            close(file);
+            return;
+        }
+
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+        close(file);
+        if (mapped != MAP_FAILED) { // NOLINT
+            data = static_cast<const uint8_t*>(mapped);
+            valid = true;
+        }
+#endif
+        if (!valid) {
+            size = 0;
+        }
+    }
+
+    MappedFile::~MappedFile()
+    {
+        Unmap();
+    }
+
+    MappedFile::MappedFile(MappedFile&& inOther) noexcept
+        : valid(std::exchange(inOther.valid, false))
+        , data(std::exchange(inOther.data, nullptr))
+        , size(std::exchange(inOther.size, 0))
+    {
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& inOther) noexcept
+    {
+        if (this != &inOther) {
+            Unmap();
+            valid = std::exchange(inOther.valid, false);
+            data = std::exchange(inOther.data, nullptr);
+            size = std::exchange(inOther.size, 0);
+        }
+        return *this;
+    }
+
+    bool MappedFile::IsValid() const
+    {
+        return valid;
+    }
+
+    const uint8_t* MappedFile::Data() const
+    {
+        return data;
+    }
+
+    size_t MappedFile::Size() const
+    {
+        return size;
+    }
+
+    void MappedFile::Unmap()
+    {
+        if (data != nullptr) {
+#if PLATFORM_WINDOWS
+            UnmapViewOfFile(data);
+#else
+            munmap(const_cast<uint8_t*>(data), size);
+#endif
+        }
+        valid = false;
+        data = nullptr;
+        size = 0;
+    }
 }
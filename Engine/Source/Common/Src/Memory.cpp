@@ -0,0 +1,146 @@
+//
+// Created by johnk on 2026/10/18.
+//
+
+#include <algorithm>
+
+#include <Common/Memory.h>
+#include <Common/Debug.h>
+
+namespace Common {
+    FrameArena::Block::Block(size_t inSize)
+        : memory(new uint8_t[inSize])
+        , size(inSize)
+        , offset(0)
+    {
+    }
+
+    FrameArena::Buffer::Buffer()
+        : currentBlockIndex(0)
+        , currentBlock(nullptr)
+        , allocationNum(0)
+        , allocatedBytes(0)
+        , blockAllocationNum(0)
+    {
+    }
+
+    FrameArena::FrameArena(size_t inBlockSize)
+        : blockSize(inBlockSize)
+        , bufferIndex(0)
+        , lastFrameStats()
+    {
+        Assert(blockSize > 0);
+    }
+
+    FrameArena::~FrameArena() = default;
+
+    void* FrameArena::Allocate(size_t inSize, size_t inAlignment)
+    {
+        Assert(inAlignment > 0 && (inAlignment & (inAlignment - 1)) == 0);
+        auto& buffer = buffers[bufferIndex];
+        buffer.allocationNum.fetch_add(1, std::memory_order_relaxed);
+        buffer.allocatedBytes.fetch_add(inSize, std::memory_order_relaxed);
+
+        if (auto* block = buffer.currentBlock.load(std::memory_order_acquire);
+            block != nullptr) {
+            if (void* result = TryAllocate(*block, inSize, inAlignment);
+                result != nullptr) {
+                return result;
+            }
+        }
+
+        std::unique_lock lock(mutex);
+        // another thread may have moved to a new block while waiting for the lock
+        auto* block = buffer.currentBlock.load(std::memory_order_relaxed);
+        if (block != nullptr) {
+            if (void* result = TryAllocate(*block, inSize, inAlignment);
+                result != nullptr) {
+                return result;
+            }
+        }
+
+        // reuse the blocks recycled from the older frames before going to the heap, blocks too small for this allocation
+        // are skipped for the rest of the frame
+        const auto requiredSize = inSize + inAlignment;
+        for (auto i = block == nullptr ? 0 : buffer.currentBlockIndex + 1; i < buffer.blocks.size(); i++) {
+            auto* recycledBlock = buffer.blocks[i].get();
+            if (recycledBlock->size < requiredSize) {
+                continue;
+            }
+            buffer.currentBlockIndex = i;
+            buffer.currentBlock.store(recycledBlock, std::memory_order_release);
+            return TryAllocate(*recycledBlock, inSize, inAlignment);
+        }
+
+        auto* newBlock = buffer.blocks.emplace_back(std::make_unique<Block>(std::max(blockSize, requiredSize))).get();
+        buffer.blockAllocationNum.fetch_add(1, std::memory_order_relaxed);
+        buffer.currentBlockIndex = buffer.blocks.size() - 1;
+        buffer.currentBlock.store(newBlock, std::memory_order_release);
+        return TryAllocate(*newBlock, inSize, inAlignment);
+    }
+
+    void FrameArena::NextFrame()
+    {
+        std::unique_lock lock(mutex);
+        lastFrameStats = GetStats(buffers[bufferIndex]);
+        bufferIndex = (bufferIndex + 1) % bufferNum;
+
+        auto& buffer = buffers[bufferIndex];
+        for (const auto& block : buffer.blocks) {
+            block->offset.store(0, std::memory_order_relaxed);
+        }
+        buffer.currentBlockIndex = 0;
+        buffer.currentBlock.store(buffer.blocks.empty() ? nullptr : buffer.blocks[0].get(), std::memory_order_release);
+        buffer.allocationNum.store(0, std::memory_order_relaxed);
+        buffer.allocatedBytes.store(0, std::memory_order_relaxed);
+        buffer.blockAllocationNum.store(0, std::memory_order_relaxed);
+    }
+
+    FrameArenaStats FrameArena::CurrentFrameStats() const
+    {
+        return GetStats(buffers[bufferIndex]);
+    }
+
+    FrameArenaStats FrameArena::LastFrameStats() const
+    {
+        std::unique_lock lock(mutex);
+        return lastFrameStats;
+    }
+
+    size_t FrameArena::ReservedBytes() const
+    {
+        std::unique_lock lock(mutex);
+        size_t result = 0;
+        for (const auto& buffer : buffers) {
+            for (const auto& block : buffer.blocks) {
+                result += block->size;
+            }
+        }
+        return result;
+    }
+
+    void* FrameArena::TryAllocate(Block& inBlock, size_t inSize, size_t inAlignment)
+    {
+        const auto base = reinterpret_cast<uintptr_t>(inBlock.memory.get());
+        auto offset = inBlock.offset.load(std::memory_order_relaxed);
+        while (true) {
+            const auto alignedAddress = (base + offset + inAlignment - 1) & ~(inAlignment - 1);
+            const auto newOffset = alignedAddress - base + inSize;
+            if (newOffset > inBlock.size) {
+                return nullptr;
+            }
+            if (inBlock.offset.compare_exchange_weak(offset, newOffset, std::memory_order_relaxed)) {
+                return reinterpret_cast<void*>(alignedAddress);
+            }
+        }
+    }
+
+    FrameArenaStats FrameArena::GetStats(const Buffer& inBuffer)
+    {
+        FrameArenaStats result {};
+        result.allocationNum = inBuffer.allocationNum.load(std::memory_order_relaxed);
+        result.allocatedBytes = inBuffer.allocatedBytes.load(std::memory_order_relaxed);
+        result.blockAllocationNum = inBuffer.blockAllocationNum.load(std::memory_order_relaxed);
+        return result;
+    }
+}
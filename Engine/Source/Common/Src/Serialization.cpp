@@ -5,11 +5,111 @@
 #include <Common/Serialization.h>
 
 namespace Common {
-    BinarySerializeStream::BinarySerializeStream() = default;
+    SerializeStreamContext::~SerializeStreamContext() = default;
+
+    std::unique_ptr<SerializeStreamContext> SerializeStreamContext::Fork() const
+    {
+        QuickFailWithReason("the stream context does not support size counting passes");
+        return nullptr;
+    }
+
+    BinarySerializeStream::BinarySerializeStream()
+        : schemaTable(false)
+    {
+    }
 
     BinarySerializeStream::~BinarySerializeStream() = default;
 
-    BinaryDeserializeStream::BinaryDeserializeStream() = default;
+    bool BinarySerializeStream::Seekable() const
+    {
+        return true;
+    }
+
+    void BinarySerializeStream::EnableSchemaTable()
+    {
+        schemaTable = true;
+    }
+
+    bool BinarySerializeStream::SchemaTableEnabled() const
+    {
+        return schemaTable;
+    }
+
+    SerializeStreamContext* BinarySerializeStream::GetContext() const
+    {
+        return context.get();
+    }
+
+    void BinarySerializeStream::SetContext(std::unique_ptr<SerializeStreamContext>&& inContext)
+    {
+        context = std::move(inContext);
+    }
+
+    SizeCountSerializeStream::SizeCountSerializeStream(BinarySerializeStream& inStream)
+        : endian(inStream.Endian())
+        , pointer(0)
+        , end(0)
+    {
+        if (inStream.SchemaTableEnabled()) {
+            EnableSchemaTable();
+        }
+        if (inStream.GetContext() != nullptr) {
+            SetContext(inStream.GetContext()->Fork());
+        }
+    }
+
+    SizeCountSerializeStream::~SizeCountSerializeStream() = default;
+
+    void SizeCountSerializeStream::Seek(int64_t offset)
+    {
+        pointer += offset;
+    }
+
+    size_t SizeCountSerializeStream::Loc()
+    {
+        return pointer;
+    }
+
+    std::endian SizeCountSerializeStream::Endian()
+    {
+        return endian;
+    }
+
+    size_t SizeCountSerializeStream::Size() const
+    {
+        return end;
+    }
+
+    void SizeCountSerializeStream::WriteInternal(const void* data, const size_t size)
+    {
+        pointer += size;
+        end = std::max(end, pointer);
+    }
+
+    BinaryDeserializeStream::BinaryDeserializeStream()
+        : schemaTable(false)
+    {
+    }
 
     BinaryDeserializeStream::~BinaryDeserializeStream() = default;
+
+    void BinaryDeserializeStream::EnableSchemaTable()
+    {
+        schemaTable = true;
+    }
+
+    bool BinaryDeserializeStream::SchemaTableEnabled() const
+    {
+        return schemaTable;
+    }
+
+    SerializeStreamContext* BinaryDeserializeStream::GetContext() const
+    {
+        return context.get();
+    }
+
+    void BinaryDeserializeStream::SetContext(std::unique_ptr<SerializeStreamContext>&& inContext)
+    {
+        context = std::move(inContext);
+    }
 }
@@ -0,0 +1,177 @@
+//
+// Created by johnk on 2026/10/18.
+//
+
+#include <random>
+
+#include <Test/Test.h>
+
+#include <Common/Compression.h>
+
+using namespace Common;
+
+namespace {
+    // a compressible half followed by a random half, so both the lz4 blocks and the raw stored blocks are covered
+    std::vector<uint8_t> MakeContent(size_t inSize)
+    {
+        std::vector<uint8_t> result(inSize);
+        std::mt19937 random(42); // NOLINT
+        for (size_t i = 0; i < inSize; i++) {
+            result[i] = i < inSize / 2 ? static_cast<uint8_t>(i % 16) : static_cast<uint8_t>(random());
+        }
+        return result;
+    }
+
+    template <std::endian E = std::endian::little>
+    std::vector<uint8_t> Compress(const std::vector<uint8_t>& inContent, size_t inBlockSize)
+    {
+        std::vector<uint8_t> result;
+        MemorySerializeStream<E> memoryStream(result);
+        CompressedSerializeStream stream(memoryStream, inBlockSize);
+        Serializer<std::vector<uint8_t>>::Serialize(stream, inContent);
+        stream.Write<uint32_t>(5);
+        stream.Close();
+        return result;
+    }
+}
+
+TEST(CompressionTest, RoundTripTest)
+{
+    const auto content = MakeContent(40000);
+    const std::vector<size_t> blockSizes = { 1, 7, 4096, CompressedSerializeStream::defaultBlockSize };
+    ThreadPool threadPool("TestThreadPool", 2);
+    for (const auto blockSize : blockSizes) {
+        const auto compressed = Compress(content, blockSize);
+        for (auto* pool : { static_cast<ThreadPool*>(nullptr), &threadPool }) {
+            MemoryDeserializeStream memoryStream(compressed);
+            ASSERT_TRUE(CompressedDeserializeStream::IsCompressed(memoryStream));
+            CompressedDeserializeStream stream(memoryStream, pool);
+            ASSERT_EQ(stream.Size(), sizeof(uint64_t) + content.size() + sizeof(uint32_t));
+
+            std::vector<uint8_t> restored;
+            uint32_t tail;
+            Serializer<std::vector<uint8_t>>::Deserialize(stream, restored);
+            stream.Read<uint32_t>(tail);
+            ASSERT_EQ(restored, content);
+            ASSERT_EQ(tail, 5);
+            ASSERT_EQ(stream.Loc(), stream.Size());
+        }
+    }
+}
+
+TEST(CompressionTest, SeekTest)
+{
+    const auto content = MakeContent(40000);
+    const auto compressed = Compress(content, 4096);
+    ThreadPool threadPool("TestThreadPool", 2);
+    for (auto* pool : { static_cast<ThreadPool*>(nullptr), &threadPool }) {
+        MemoryDeserializeStream memoryStream(compressed);
+        CompressedDeserializeStream stream(memoryStream, pool);
+
+        // skip the size header, then jump forward and backward across blocks
+        for (const size_t index : { 0, 39999, 4095, 4096, 20000, 1 }) {
+            stream.Seek(static_cast<int64_t>(sizeof(uint64_t) + index) - static_cast<int64_t>(stream.Loc()));
+            uint8_t value;
+            stream.Read<uint8_t>(value);
+            ASSERT_EQ(value, content[index]);
+        }
+    }
+}
+
+TEST(CompressionTest, EndianTest)
+{
+    const auto content = MakeContent(1000);
+    const auto compressed = Compress<std::endian::big>(content, 64);
+
+    MemoryDeserializeStream<std::endian::big> memoryStream(compressed);
+    CompressedDeserializeStream stream(memoryStream);
+    ASSERT_EQ(stream.Endian(), std::endian::big);
+
+    std::vector<uint8_t> restored;
+    uint32_t tail;
+    Serializer<std::vector<uint8_t>>::Deserialize(stream, restored);
+    stream.Read<uint32_t>(tail);
+    ASSERT_EQ(restored, content);
+    ASSERT_EQ(tail, 5);
+}
+
+TEST(CompressionTest, UncompressedTest)
+{
+    std::vector<uint8_t> bytes;
+    {
+        MemorySerializeStream stream(bytes);
+        stream.Write<uint32_t>(5);
+    }
+
+    MemoryDeserializeStream stream(bytes);
+    ASSERT_FALSE(CompressedDeserializeStream::IsCompressed(stream));
+    uint32_t value;
+    stream.Read<uint32_t>(value);
+    ASSERT_EQ(value, 5);
+}
+
+TEST(CompressionTest, CorruptedTest)
+{
+    const auto content = MakeContent(40000);
+    const auto compressed = Compress(content, 4096);
+    ThreadPool threadPool("TestThreadPool", 2);
+
+    // a damaged lz4 block is reported by the decode, on demand or at construction
+    auto damaged = compressed;
+    for (auto i = 16; i < 64; i++) {
+        damaged[i] = 0xff;
+    }
+    for (auto* pool : { static_cast<ThreadPool*>(nullptr), &threadPool }) {
+        MemoryDeserializeStream memoryStream(damaged);
+        CompressedDeserializeStream stream(memoryStream, pool);
+        std::vector<uint8_t> restored;
+        Serializer<std::vector<uint8_t>>::Deserialize(stream, restored);
+        ASSERT_TRUE(stream.Corrupted());
+    }
+
+    // a truncated stream fails the block index
+    const std::vector<uint8_t> truncated(compressed.begin(), compressed.begin() + static_cast<ptrdiff_t>(compressed.size() / 2));
+    MemoryDeserializeStream truncatedStream(truncated);
+    CompressedDeserializeStream stream(truncatedStream);
+    ASSERT_TRUE(stream.Corrupted());
+    ASSERT_EQ(stream.Size(), 0);
+    uint32_t value = 1;
+    stream.Read<uint32_t>(value);
+    ASSERT_EQ(value, 0);
+
+    // less than the magic is not compressed
+    const std::vector<uint8_t> tiny = { 1, 2 };
+    MemoryDeserializeStream tinyStream(tiny);
+    ASSERT_FALSE(CompressedDeserializeStream::IsCompressed(tinyStream));
+}
+
+TEST(CompressionTest, CorruptedSizeTest)
+{
+    // a 16 bytes block can not shrink, so it is stored raw and a flipped byte survives the decode
+    std::vector<uint8_t> compressed;
+    {
+        MemorySerializeStream memoryStream(compressed);
+        CompressedSerializeStream stream(memoryStream, 16);
+        FieldSerializer<uint32_t>::Serialize(stream, 5);
+        stream.Close();
+    }
+    ASSERT_EQ(compressed[8], 16);
+    ASSERT_EQ(compressed[12], 16);
+
+    // magic, block size, raw size, stored size, then the field header with its content size at offset 8
+    auto damaged = compressed;
+    damaged[16 + 8 + 6] = 0x01;
+    MemoryDeserializeStream memoryStream(damaged);
+    CompressedDeserializeStream stream(memoryStream);
+    ASSERT_FALSE(stream.Corrupted());
+
+    // the content size no longer matches, so the field skips its remaining bytes by the corrupted size
+    uint32_t value;
+    const auto [success, size] = FieldSerializer<uint32_t>::Deserialize(stream, value);
+    ASSERT_FALSE(success);
+    ASSERT_TRUE(stream.Corrupted());
+    ASSERT_EQ(stream.Loc(), stream.Size());
+
+    stream.Seek(-static_cast<int64_t>(stream.Size()) - 1);
+    ASSERT_EQ(stream.Loc(), 0);
+}
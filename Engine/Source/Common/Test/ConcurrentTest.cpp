@@ -123,3 +123,176 @@ TEST(ConcurrentTest, WorkerThread3)
     syncSignal.wait();
     ASSERT_EQ(value, 10);
 }
+
+TEST(ConcurrentTest, WorkerThreadPostTaskTest)
+{
+    std::vector<uint32_t> values;
+    Common::WorkerThread workerThread("TestWorkerThread");
+    for (auto i = 0; i < 100; i++) {
+        workerThread.PostTask([&values, i]() -> void { values.emplace_back(i); });
+    }
+    workerThread.Flush();
+    ASSERT_EQ(values.size(), 100);
+    for (auto i = 0; i < 100; i++) {
+        ASSERT_EQ(values[i], i);
+    }
+}
+
+TEST(ConcurrentTest, WorkerThreadSelfPostTest)
+{
+    // more tasks than the ring holds, posted by the worker thread itself which is the only one to drain the ring
+    constexpr uint32_t taskNum = Common::WorkerThread::taskQueueCapacity * 3;
+
+    std::vector<uint32_t> values;
+    Common::WorkerThread workerThread("TestWorkerThread");
+    workerThread.PostTask([&]() -> void {
+        for (uint32_t i = 0; i < taskNum; i++) {
+            workerThread.PostTask([&values, i]() -> void { values.emplace_back(i); });
+        }
+    });
+    workerThread.Flush();
+    ASSERT_EQ(values.size(), taskNum);
+    for (uint32_t i = 0; i < taskNum; i++) {
+        ASSERT_EQ(values[i], i);
+    }
+}
+
+TEST(ConcurrentTest, UniqueTaskTest)
+{
+    uint32_t value = 0;
+    Common::UniqueTask smallTask([pointer = std::make_unique<uint32_t>(1), &value]() -> void { value += *pointer; });
+    Common::UniqueTask movedTask = std::move(smallTask);
+    ASSERT_FALSE(static_cast<bool>(smallTask)); // NOLINT
+    movedTask();
+    ASSERT_EQ(value, 1);
+
+    std::array<uint32_t, 32> largeCapture {};
+    largeCapture[31] = 2;
+    movedTask = Common::UniqueTask([largeCapture, &value]() -> void { value += largeCapture[31]; });
+    smallTask = std::move(movedTask);
+    smallTask();
+    ASSERT_EQ(value, 3);
+}
+
+TEST(ConcurrentTest, MpscRingTest)
+{
+    // the ring is much smaller than the pushed values, so the producers have to block on it
+    constexpr uint32_t producerNum = 4;
+    constexpr uint32_t valueNum = 10000;
+    Common::MpscRing<uint32_t> ring(16);
+    std::vector<std::thread> producers;
+    for (auto i = 0; i < producerNum; i++) {
+        producers.emplace_back([&ring]() -> void {
+            for (uint32_t v = 1; v <= valueNum; v++) {
+                ring.Push(std::move(v));
+            }
+        });
+    }
+
+    uint64_t sum = 0;
+    for (auto popped = 0; popped < producerNum * valueNum;) {
+        uint32_t value;
+        if (ring.TryPop(value)) {
+            sum += value;
+            popped++;
+        } else {
+            ring.Wait([]() -> bool { return false; });
+        }
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    ASSERT_TRUE(ring.Empty());
+    ASSERT_EQ(sum, static_cast<uint64_t>(producerNum) * valueNum * (valueNum + 1) / 2);
+}
+
+TEST(ConcurrentTest, ThreadPoolParallelForTest)
+{
+    Common::ThreadPool threadPool("TestThreadPool", 4);
+    std::vector<uint32_t> values(10000, 0);
+    threadPool.ParallelFor(0, values.size(), 64, [&values](size_t i) -> void { values[i] = static_cast<uint32_t>(i); });
+    for (auto i = 0; i < values.size(); i++) {
+        ASSERT_EQ(values[i], i);
+    }
+
+    // the tasks wait on the tasks they spawn, which only works because waiting helps before blocking
+    std::atomic<uint64_t> sum = 0;
+    threadPool.ParallelFor(0, 16, 1, [&](size_t) -> void {
+        threadPool.ParallelFor(0, 100, 8, [&sum](size_t j) -> void { sum += j; });
+    });
+    ASSERT_EQ(sum, 16 * 4950);
+}
+
+TEST(ConcurrentTest, ThreadPoolTaskGroupTest)
+{
+    Common::ThreadPool threadPool("TestThreadPool", 4);
+    Common::TaskGroup group;
+    std::atomic<uint32_t> count = 0;
+    for (auto i = 0; i < 100; i++) {
+        threadPool.Run(group, [&count]() -> void { ++count; });
+    }
+    threadPool.Wait(group);
+    ASSERT_TRUE(group.Done());
+    ASSERT_EQ(count, 100);
+}
+
+TEST(ConcurrentTest, ThreadPoolWaitBlockingTest)
+{
+    // the waiting threads outside the pool find nothing to run while the tasks sleep on the workers, so they block until
+    // the last task of their own group wakes them up
+    Common::ThreadPool threadPool("TestThreadPool", 2);
+    std::atomic<uint32_t> count = 0;
+    std::vector<std::thread> waiters;
+    for (auto i = 0; i < 4; i++) {
+        waiters.emplace_back([&]() -> void {
+            for (auto j = 0; j < 20; j++) {
+                Common::TaskGroup group;
+                threadPool.Run(group, [&count]() -> void {
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+                    ++count;
+                });
+                threadPool.Wait(group);
+                ASSERT_TRUE(group.Done());
+            }
+        });
+    }
+    for (auto& waiter : waiters) {
+        waiter.join();
+    }
+    ASSERT_EQ(count, 80);
+}
+
+TEST(ConcurrentTest, ThreadPoolTaskGraphTest)
+{
+    Common::ThreadPool threadPool("TestThreadPool", 4);
+    std::mutex mutex;
+    std::vector<uint32_t> order;
+    const auto record = [&](uint32_t inValue) -> std::function<void()> {
+        return [&, inValue]() -> void {
+            std::unique_lock lock(mutex);
+            order.emplace_back(inValue);
+        };
+    };
+
+    // 0 -> (1, 2) -> barrier -> 3
+    Common::TaskGraph graph;
+    const auto first = graph.Emplace(record(0));
+    const auto left = graph.Emplace(record(1));
+    const auto right = graph.Emplace(record(2));
+    const auto barrier = graph.Emplace();
+    const auto last = graph.Emplace(record(3));
+    graph.Precede(first, left);
+    graph.Precede(first, right);
+    graph.Precede(left, barrier);
+    graph.Precede(right, barrier);
+    graph.Precede(barrier, last);
+
+    // a graph can be run again once the last run finished
+    for (auto i = 0; i < 10; i++) {
+        order.clear();
+        threadPool.RunAndWait(graph);
+        ASSERT_EQ(order.size(), 4);
+        ASSERT_EQ(order.front(), 0);
+        ASSERT_EQ(order.back(), 3);
+    }
+}
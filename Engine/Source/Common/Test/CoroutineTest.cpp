@@ -0,0 +1,148 @@
+//
+// Created by johnk on 2026/10/18.
+//
+
+#include <Test/Test.h>
+
+#include <Common/Coroutine.h>
+
+namespace {
+    struct TestFence {
+        bool IsSignaled() const { return signaled.load(); }
+
+        std::atomic<bool> signaled = false;
+    };
+
+    Common::CoTask<uint32_t> Add(uint32_t inLhs, uint32_t inRhs)
+    {
+        co_return inLhs + inRhs;
+    }
+
+    Common::CoTask<uint32_t> SumTo(uint32_t inNum)
+    {
+        uint32_t result = 0;
+        for (auto i = 1; i <= inNum; i++) {
+            result = co_await Add(result, i);
+        }
+        co_return result;
+    }
+
+    Common::CoTask<bool> ResumeOnPool(Common::ThreadPool& inThreadPool)
+    {
+        co_await Common::ResumeOn(inThreadPool);
+        co_return inThreadPool.InWorker();
+    }
+
+    Common::CoTask<uint32_t> WaitFutureOnPool(Common::ThreadPool& inThreadPool, std::future<uint32_t> inFuture)
+    {
+        const auto value = co_await Common::WaitFuture(inThreadPool, std::move(inFuture));
+        co_return value + 1;
+    }
+
+    Common::CoTask<bool> WaitFenceOnPool(Common::ThreadPool& inThreadPool, TestFence& inFence)
+    {
+        co_await Common::WaitSignaled(inThreadPool, inFence);
+        co_return inThreadPool.InWorker();
+    }
+
+    Common::CoTask<void> WaitFlagOnPool(Common::ThreadPool& inThreadPool, std::atomic<bool>& inFlag, std::atomic<uint32_t>& outPollNum)
+    {
+        co_await Common::WaitUntil(inThreadPool, [&]() -> bool {
+            ++outPollNum;
+            return inFlag.load();
+        });
+    }
+
+    Common::CoTask<void> CountFrames(Common::ThreadPool& inThreadPool, Common::FrameBarrier& inBarrier, uint32_t inFrameNum, std::atomic<uint32_t>& outCount)
+    {
+        for (auto i = 0; i < inFrameNum; i++) {
+            co_await inBarrier.Wait(inThreadPool);
+            ++outCount;
+        }
+    }
+}
+
+TEST(CoroutineTest, CoTaskTest)
+{
+    ASSERT_EQ(Common::SyncWait(Add(1, 2)), 3);
+    ASSERT_EQ(Common::SyncWait(SumTo(100)), 5050);
+
+    Common::CoTask<uint32_t> task = Add(2, 3);
+    ASSERT_TRUE(task.Valid());
+    ASSERT_FALSE(task.Done());
+    Common::CoTask<uint32_t> moved = std::move(task);
+    ASSERT_FALSE(task.Valid());
+    ASSERT_EQ(Common::SyncWait(std::move(moved)), 5);
+}
+
+TEST(CoroutineTest, ResumeOnTest)
+{
+    Common::ThreadPool threadPool("TestThreadPool", 2);
+    ASSERT_TRUE(Common::SyncWait(ResumeOnPool(threadPool)));
+}
+
+TEST(CoroutineTest, WaitFutureTest)
+{
+    Common::ThreadPool threadPool("TestThreadPool", 2);
+    std::promise<uint32_t> promise;
+    Common::NamedThread thread("TestThread", [&promise]() -> void {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        promise.set_value(41);
+    });
+    ASSERT_EQ(Common::SyncWait(WaitFutureOnPool(threadPool, promise.get_future())), 42);
+    thread.Join();
+}
+
+TEST(CoroutineTest, WaitSignaledTest)
+{
+    Common::ThreadPool threadPool("TestThreadPool", 2);
+    TestFence fence;
+    Common::NamedThread thread("TestThread", [&fence]() -> void {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        fence.signaled = true;
+    });
+    ASSERT_TRUE(Common::SyncWait(WaitFenceOnPool(threadPool, fence)));
+    thread.Join();
+
+    // a signaled fence does not suspend at all
+    ASSERT_FALSE(Common::SyncWait(WaitFenceOnPool(threadPool, fence)));
+}
+
+TEST(CoroutineTest, WaitUntilBackOffTest)
+{
+    // the polls back off up to maxPollDelay, so a 100ms wait takes about a hundred polls instead of keeping a worker busy
+    Common::ThreadPool threadPool("TestThreadPool", 2);
+    std::atomic<bool> flag = false;
+    std::atomic<uint32_t> pollNum = 0;
+    Common::NamedThread thread("TestThread", [&flag]() -> void {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        flag = true;
+    });
+    Common::SyncWait(WaitFlagOnPool(threadPool, flag, pollNum));
+    thread.Join();
+    ASSERT_GT(pollNum, 1);
+    ASSERT_LT(pollNum, 1000);
+}
+
+TEST(CoroutineTest, FrameBarrierTest)
+{
+    Common::ThreadPool threadPool("TestThreadPool", 2);
+    Common::FrameBarrier barrier;
+    std::atomic<uint32_t> count = 0;
+    for (auto i = 0; i < 4; i++) {
+        Common::Spawn(threadPool, CountFrames(threadPool, barrier, 3, count));
+    }
+
+    for (auto frame = 1; frame <= 3; frame++) {
+        while (barrier.WaitingNum() < 4) {
+            std::this_thread::yield();
+        }
+        ASSERT_EQ(count, (frame - 1) * 4);
+        barrier.Signal();
+    }
+    while (count < 12) {
+        std::this_thread::yield();
+    }
+    ASSERT_EQ(barrier.SignaledNum(), 3);
+    ASSERT_EQ(barrier.WaitingNum(), 0);
+}
@@ -28,3 +28,20 @@ TEST(FileTest, ReadMissingJsonFileTest)
     const auto readResult = Common::FileUtils::ReadJsonFile("../Test/Generated/Common/DoesNotExist.json");
     ASSERT_TRUE(readResult.IsErr());
 }
+
+TEST(FileTest, MappedFileTest)
+{
+    static Common::Path file = "../Test/Generated/Common/MappedFileTest.txt";
+
+    ASSERT_TRUE(Common::FileUtils::WriteTextFile(file.Absolute().String(), "hello").IsOk());
+    Common::MappedFile mappedFile(file.Absolute().String());
+    ASSERT_TRUE(mappedFile.IsValid());
+    ASSERT_EQ(std::string(reinterpret_cast<const char*>(mappedFile.Data()), mappedFile.Size()), "hello");
+
+    const Common::MappedFile movedFile = std::move(mappedFile);
+    ASSERT_FALSE(mappedFile.IsValid()); // NOLINT
+    ASSERT_EQ(movedFile.Size(), 5);
+
+    const Common::MappedFile missingFile("../Test/Generated/Common/DoesNotExist.txt");
+    ASSERT_FALSE(missingFile.IsValid());
+}
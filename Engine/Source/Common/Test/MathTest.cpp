@@ -8,6 +8,7 @@
 #include <Common/Math/Matrix.h>
 #include <Common/Math/Quaternion.h>
 #include <Common/Math/Transform.h>
+#include <Common/Math/TransformBatch.h>
 #include <Common/Math/Rect.h>
 #include <Common/Math/Box.h>
 #include <Common/Math/Sphere.h>
@@ -1492,3 +1493,35 @@ TEST(MathTest, QuaternionBackendConsistencyTest)
     ASSERT_FLOAT_EQ(as.Dot(bs), ai.Dot(bi));
     ASSERT_FLOAT_EQ(as.Model(), ai.Model());
 }
+
+TEST(MathTest, TransformBatchTest)
+{
+    // 7 elements to cover one 4-wide iteration and the scalar tail
+    std::vector<FQuat> quats;
+    std::vector<FTransform> transforms;
+    std::vector<FMat4x4> parents;
+    for (auto i = 0; i < 7; i++) {
+        const auto f = static_cast<float>(i);
+        quats.emplace_back(0.5f + f * 0.1f, 0.1f * f, 0.2f - f * 0.05f, 0.3f);
+        transforms.emplace_back(FVec3(1.0f + f, 2.0f, 0.5f * f + 0.5f), quats.back(), FVec3(f, -f, 2.0f * f));
+        parents.emplace_back(FTransform(FVec3(2.0f), quats.back(), FVec3(-f, 1.0f, f)).GetTransformMatrix());
+    }
+
+    std::vector<FMat4x4> rotations(quats.size());
+    std::vector<FMat4x4> matrices(transforms.size());
+    std::vector<FMat4x4> composed(transforms.size());
+    BatchQuatToMatrix(quats, rotations);
+    BatchTransformToMatrix(transforms, matrices);
+    BatchMulAffine(parents, matrices, composed);
+
+    for (auto i = 0; i < 7; i++) {
+        const auto expectedRotation = quats[i].GetRotationMatrix();
+        const auto expectedMatrix = transforms[i].GetTransformMatrix();
+        const auto expectedComposed = parents[i] * expectedMatrix;
+        for (auto j = 0; j < 16; j++) {
+            ASSERT_FLOAT_EQ(rotations[i].data[j], expectedRotation.data[j]);
+            ASSERT_FLOAT_EQ(matrices[i].data[j], expectedMatrix.data[j]);
+            ASSERT_NEAR(composed[i].data[j], expectedComposed.data[j], 1e-4f);
+        }
+    }
+}
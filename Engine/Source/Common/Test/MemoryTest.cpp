@@ -134,3 +134,51 @@ TEST(MemoryTest, WeakRefDeriveTest) // NOLINT
     ASSERT_EQ(live, false);
     ASSERT_EQ(weakRef.Expired(), true);
 }
+
+TEST(MemoryTest, FrameArenaTest) // NOLINT
+{
+    FrameArena arena(1024);
+    auto* first = static_cast<uint8_t*>(arena.Allocate(100, 1));
+    auto* aligned = arena.Allocate(16, 64);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(aligned) % 64, 0);
+    ASSERT_TRUE(first + 100 <= aligned);
+
+    // larger than the block size, served by a dedicated block
+    auto* large = arena.Allocate(4096, 16);
+    ASSERT_TRUE(large != nullptr);
+    ASSERT_EQ(arena.CurrentFrameStats().allocationNum, 3);
+    ASSERT_EQ(arena.CurrentFrameStats().blockAllocationNum, 2);
+
+    for (auto i = 0; i < FrameArena::bufferNum; i++) {
+        arena.NextFrame();
+    }
+    ASSERT_EQ(arena.LastFrameStats().allocationNum, 0);
+    const auto reservedBytes = arena.ReservedBytes();
+
+    // the blocks of the recycled buffer are reused without going to the heap
+    ASSERT_EQ(arena.Allocate(100, 1), first);
+    arena.Allocate(2048, 16);
+    ASSERT_EQ(arena.CurrentFrameStats().blockAllocationNum, 0);
+    ASSERT_EQ(arena.ReservedBytes(), reservedBytes);
+    arena.NextFrame();
+    ASSERT_EQ(arena.LastFrameStats().allocationNum, 2);
+    ASSERT_EQ(arena.LastFrameStats().allocatedBytes, 2148);
+}
+
+TEST(MemoryTest, FrameAllocatorTest) // NOLINT
+{
+    FrameArena arena;
+    FrameVector<uint32_t> vector(arena);
+    FrameUnorderedMap<uint32_t, FrameVector<uint32_t>> map(arena);
+    for (auto i = 0; i < 1000; i++) {
+        vector.emplace_back(i);
+        map.emplace(i % 10, map.get_allocator()).first->second.emplace_back(i);
+    }
+    ASSERT_EQ(vector.size(), 1000);
+    ASSERT_EQ(vector[999], 999);
+    ASSERT_EQ(map.size(), 10);
+    ASSERT_EQ(map.at(3).size(), 100);
+    ASSERT_EQ(map.at(3)[1], 13);
+    ASSERT_TRUE(map.get_allocator() == vector.get_allocator());
+    ASSERT_EQ(arena.CurrentFrameStats().blockAllocationNum, 1);
+}
@@ -3,6 +3,8 @@
 //
 
 #include <Common/Memory.h>
+#include <Common/Math/Vector.h>
+#include <Common/Math/Matrix.h>
 #include <SerializationTest.h>
 
 using namespace Common;
@@ -28,6 +30,44 @@ TEST(SerializationTest, FileStreamTest)
     }
 }
 
+TEST(SerializationTest, BufferedMappedFileStreamTest)
+{
+    static Common::Path fileName = "../Test/Generated/Common/SerializationTest.BufferedMappedFileStreamTest.bin";
+    const std::vector<std::vector<uint32_t>> value = { { 1, 2, 3 }, {}, std::vector<uint32_t>(100, 4) };
+
+    // a window smaller than the content, so headers are patched both in the window and in the flushed file
+    for (const size_t bufferSize : { 1, 16, 1024 }) {
+        std::vector<uint8_t> expected;
+        {
+            MemorySerializeStream stream(expected);
+            stream.Seek(3);
+            stream.Write<uint32_t>(5);
+            Serialize(stream, value);
+        }
+        {
+            BufferedFileSerializeStream stream(fileName.String(), bufferSize);
+            stream.Seek(3);
+            stream.Write<uint32_t>(5);
+            Serialize(stream, value);
+            ASSERT_EQ(stream.Loc(), expected.size());
+        }
+
+        MappedFileDeserializeStream stream(fileName.String());
+        ASSERT_TRUE(stream.IsValid());
+        std::vector<uint8_t> bytes(expected.size());
+        stream.ReadArray<uint8_t>(bytes.data(), bytes.size());
+        ASSERT_EQ(bytes, expected);
+
+        uint32_t restoredValue;
+        std::vector<std::vector<uint32_t>> restored;
+        stream.Seek(-static_cast<int64_t>(bytes.size()) + 3);
+        stream.Read<uint32_t>(restoredValue);
+        ASSERT_EQ(restoredValue, 5);
+        ASSERT_TRUE(Deserialize(stream, restored).first);
+        ASSERT_EQ(restored, value);
+    }
+}
+
 TEST(SerializationTest, ByteStreamTest)
 {
     std::vector<uint8_t> memory;
@@ -77,6 +117,43 @@ TEST(SerializationTest, TypedSerializationTest)
     PerformTypedSerializationTest<std::variant<int, bool, float>>({ true });
 }
 
+TEST(SerializationTest, BulkSerializationTest)
+{
+    // longer than one swap chunk, and not a multiple of the 16 bytes swapped at once
+    std::vector<uint16_t> u16s(3001);
+    std::vector<uint32_t> u32s(3001);
+    std::vector<double> f64s(3001);
+    std::vector<Common::FVec3> positions(3001);
+    for (auto i = 0; i < u16s.size(); i++) {
+        u16s[i] = static_cast<uint16_t>(i * 7919);
+        u32s[i] = static_cast<uint32_t>(i) * 2654435761u;
+        f64s[i] = static_cast<double>(i) * 0.25 - 100.0;
+        positions[i] = Common::FVec3(static_cast<float>(i), static_cast<float>(i) * 2.0f, -static_cast<float>(i));
+    }
+    PerformTypedSerializationTest<std::vector<uint16_t>>(u16s);
+    PerformTypedSerializationTest<std::vector<uint32_t>>(u32s);
+    PerformTypedSerializationTest<std::vector<double>>(f64s);
+    PerformTypedSerializationTest<std::vector<Common::FVec3>>(positions);
+    PerformTypedSerializationTest<std::vector<std::vector<uint8_t>>>({ { 1, 2, 3 }, {}, { 4 } });
+    PerformTypedSerializationTest<std::array<Common::FMat4x4, 2>>({ Common::FMat4x4Consts::identity, Common::FMat4x4Consts::zero });
+    PerformTypedSerializationTest<std::vector<bool>>({ true, false, true });
+
+    // the bulk path keeps the element by element wire format
+    std::vector<uint8_t> bulkBytes;
+    std::vector<uint8_t> elementBytes;
+    {
+        Common::MemorySerializeStream<std::endian::big> stream(bulkBytes);
+        stream.WriteArray<uint32_t>(u32s.data(), u32s.size());
+    }
+    {
+        Common::MemorySerializeStream<std::endian::big> stream(elementBytes);
+        for (const auto value : u32s) {
+            stream.Write<uint32_t>(value);
+        }
+    }
+    ASSERT_EQ(bulkBytes, elementBytes);
+}
+
 TEST(SerializationTest, TypedSerializationWithFileTest)
 {
     static std::string fileName = "../Test/Generated/Common/SerializationTest.TypedSerializationWithFileTest.bin";
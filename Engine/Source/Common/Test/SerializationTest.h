@@ -51,11 +51,28 @@ void PerformTypedSerializationTestWithEndian(const T& inValue)
         []() -> Common::UniquePtr<Common::BinaryDeserializeStream> { return {new Common::BinaryFileDeserializeStream<E>(fileName.String()) }; },
         inValue);
 
+    PerformTypedSerializationTestWithStream<T>(
+        []() -> Common::UniquePtr<Common::BinarySerializeStream> { return {new Common::BufferedFileSerializeStream<E>(fileName.String(), 16) }; },
+        []() -> Common::UniquePtr<Common::BinaryDeserializeStream> { return {new Common::MappedFileDeserializeStream<E>(fileName.String()) }; },
+        inValue);
+
     std::vector<uint8_t> buffer;
     PerformTypedSerializationTestWithStream<T>(
         [&]() -> Common::UniquePtr<Common::BinarySerializeStream> { return {new Common::MemorySerializeStream<E>(buffer) }; },
         [&]() -> Common::UniquePtr<Common::BinaryDeserializeStream> { return {new Common::MemoryDeserializeStream<E>(buffer) }; },
         inValue);
+
+    // the forward-only stream writes the same bytes as the seekable ones
+    std::vector<uint8_t> forwardBuffer;
+    PerformTypedSerializationTestWithStream<T>(
+        [&]() -> Common::UniquePtr<Common::BinarySerializeStream> {
+            return { new Common::SinkSerializeStream<E>([&](const void* inData, size_t inSize) -> void {
+                forwardBuffer.insert(forwardBuffer.end(), static_cast<const uint8_t*>(inData), static_cast<const uint8_t*>(inData) + inSize);
+            }) };
+        },
+        [&]() -> Common::UniquePtr<Common::BinaryDeserializeStream> { return {new Common::MemoryDeserializeStream<E>(forwardBuffer) }; },
+        inValue);
+    ASSERT_EQ(forwardBuffer, buffer);
 }
 
 template <typename T>
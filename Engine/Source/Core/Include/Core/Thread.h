@@ -6,6 +6,8 @@
 
 #include <cstdint>
 
+#include <Common/Memory.h>
+#include <Common/Coroutine.h>
 #include <Core/Api.h>
 
 namespace Core {
@@ -21,6 +23,7 @@ namespace Core {
     class CORE_API ThreadContext {
     public:
         static void SetTag(ThreadTag inTag);
+        // also moves the frame arena of the current thread tag to the next frame and signals its frame barrier
         static void IncFrameNumber();
 
         static ThreadTag Tag();
@@ -32,6 +35,11 @@ namespace Core {
         static bool IsRenderWorkerThread();
         static bool IsGameOrWorkerThread();
         static bool IsRenderOrWorkerThread();
+        // game arena for the game thread and its workers, render arena for the render thread and its workers
+        static Common::FrameArena& FrameArena();
+        // signaled when the game/render thread enters a new frame, e.g. co_await GameFrameBarrier().Wait(executor)
+        static Common::FrameBarrier& GameFrameBarrier();
+        static Common::FrameBarrier& RenderFrameBarrier();
     };
 
     class CORE_API ScopedThreadTag {
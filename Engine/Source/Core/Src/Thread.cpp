@@ -4,12 +4,17 @@
 
 #include <thread>
 
+#include <Common/Debug.h>
 #include <Core/Thread.h>
 
 namespace Core {
     static auto mainThreadId = std::this_thread::get_id();
     static thread_local auto currentTag = std::this_thread::get_id() == mainThreadId ? ThreadTag::game : ThreadTag::unknown;
     static thread_local uint64_t frameNumber = 0;
+    static Common::FrameArena gameFrameArena;
+    static Common::FrameArena renderFrameArena;
+    static Common::FrameBarrier gameFrameBarrier;
+    static Common::FrameBarrier renderFrameBarrier;
 
     void ThreadContext::SetTag(ThreadTag inTag)
     {
@@ -19,6 +24,13 @@ namespace Core {
     void ThreadContext::IncFrameNumber()
     {
         frameNumber++;
+        if (IsGameThread()) {
+            gameFrameArena.NextFrame();
+            gameFrameBarrier.Signal();
+        } else if (IsRenderThread()) {
+            renderFrameArena.NextFrame();
+            renderFrameBarrier.Signal();
+        }
     }
 
     ThreadTag ThreadContext::Tag()
@@ -66,6 +78,25 @@ namespace Core {
         return currentTag == ThreadTag::render || currentTag == ThreadTag::renderWorker;
     }
 
+    Common::FrameArena& ThreadContext::FrameArena()
+    {
+        if (IsGameOrWorkerThread()) {
+            return gameFrameArena;
+        }
+        AssertWithReason(IsRenderOrWorkerThread(), "frame arena is only available on game, render and their worker threads");
+        return renderFrameArena;
+    }
+
+    Common::FrameBarrier& ThreadContext::GameFrameBarrier()
+    {
+        return gameFrameBarrier;
+    }
+
+    Common::FrameBarrier& ThreadContext::RenderFrameBarrier()
+    {
+        return renderFrameBarrier;
+    }
+
     ScopedThreadTag::ScopedThreadTag(ThreadTag inTag)
     {
         tagToRestore = ThreadContext::Tag();
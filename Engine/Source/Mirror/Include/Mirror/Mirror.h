@@ -62,6 +62,7 @@ namespace Mirror {
         const uint32_t moveConstructible : 1;
         const uint32_t moveAssignable : 1;
         const uint32_t equalComparable : 1;
+        const uint32_t triviallyCopyable : 1;
     };
 
     template <typename T> const TypeInfo* GetTypeInfo();
@@ -103,6 +104,9 @@ namespace Mirror {
         using DerefFunc = Any(const void*);
         using SerializeFunc = size_t(const void*, Common::BinarySerializeStream&);
         using DeserializeFunc = std::pair<bool, size_t>(void*, Common::BinaryDeserializeStream&);
+        using SerializeContentFunc = size_t(const void*, Common::BinarySerializeStream&);
+        using DeserializeContentFunc = size_t(void*, Common::BinaryDeserializeStream&);
+        using GetSerializeTypeIdFunc = uint32_t();
         using JsonSerializeFunc = void(const void*, rapidjson::Value&, rapidjson::Document::AllocatorType&);
         using JsonDeserializeFunc = void(void*, const rapidjson::Value&);
         using ToStringFunc = std::string(const void*);
@@ -127,6 +131,9 @@ namespace Mirror {
         template <typename T> static Any Deref(const void* inThis);
         template <typename T> static size_t Serialize(const void* inThis, Common::BinarySerializeStream& inStream);
         template <typename T> static std::pair<bool, size_t> Deserialize(void* inThis, Common::BinaryDeserializeStream& inStream);
+        template <typename T> static size_t SerializeContent(const void* inThis, Common::BinarySerializeStream& inStream);
+        template <typename T> static size_t DeserializeContent(void* inThis, Common::BinaryDeserializeStream& inStream);
+        template <typename T> static uint32_t GetSerializeTypeId();
         template <typename T> static void JsonSerialize(const void* inThis, rapidjson::Value& outJsonValue, rapidjson::Document::AllocatorType& inAllocator);
         template <typename T> static void JsonDeserialize(void* inThis, const rapidjson::Value& inJsonValue);
         template <typename T> static std::string ToString(const void* inThis);
@@ -151,6 +158,9 @@ namespace Mirror {
         DerefFunc* deref;
         SerializeFunc* serialize;
         DeserializeFunc* deserialize;
+        SerializeContentFunc* serializeContent;
+        DeserializeContentFunc* deserializeContent;
+        GetSerializeTypeIdFunc* getSerializeTypeId;
         JsonSerializeFunc* jsonSerialize;
         JsonDeserializeFunc* jsonDeserialize;
         ToStringFunc* toString;
@@ -178,6 +188,9 @@ namespace Mirror {
         &AnyRtti::Deref<T>,
         &AnyRtti::Serialize<T>,
         &AnyRtti::Deserialize<T>,
+        &AnyRtti::SerializeContent<T>,
+        &AnyRtti::DeserializeContent<T>,
+        &AnyRtti::GetSerializeTypeId<T>,
         &AnyRtti::JsonSerialize<T>,
         &AnyRtti::JsonDeserialize<T>,
         &AnyRtti::ToString<T>,
@@ -292,6 +305,11 @@ namespace Mirror {
         size_t Serialize(Common::BinarySerializeStream& inStream) const;
         std::pair<bool, size_t> Deserialize(Common::BinaryDeserializeStream& inStream);
         std::pair<bool, size_t> Deserialize(Common::BinaryDeserializeStream& inStream) const;
+        // the serializer content without the type id and size header of Serialize(), for formats keeping them elsewhere
+        size_t SerializeContent(Common::BinarySerializeStream& inStream) const;
+        size_t DeserializeContent(Common::BinaryDeserializeStream& inStream);
+        size_t DeserializeContent(Common::BinaryDeserializeStream& inStream) const;
+        uint32_t SerializeTypeId() const;
         void JsonSerialize(rapidjson::Value& outJsonValue, rapidjson::Document::AllocatorType& inAllocator) const;
         void JsonDeserialize(const rapidjson::Value& inJsonValue);
         void JsonDeserialize(const rapidjson::Value& inJsonValue) const;
@@ -1947,6 +1965,10 @@ namespace Mirror::Internal {
             }...
         };
     }
+
+    // schema table format of the meta object serializer, used when the stream enabled the schema table
+    MIRROR_API size_t SerializeWithSchemaTable(Common::BinarySerializeStream& inStream, const Class& inClass, const Argument& inObj);
+    MIRROR_API size_t DeserializeWithSchemaTable(Common::BinaryDeserializeStream& inStream, const Class& inClass, const Argument& inObj);
 }
 
 namespace Common { // NOLINT
@@ -1964,17 +1986,90 @@ namespace Common { // NOLINT
         //     |- std::string memberVariableName  : memberVariableNameSize
         //     |- bool sameAsDefaultObject        : sizeof(bool)
         //     |- void* memberVariableContent     : memberVariableEnd - memberVariableLastEnd
+        //
+        // struct (schema table enabled)
+        // uint32_t formatTag                     : sizeof(uint32_t), only before the first instance in the stream
+        // uint32_t schemasOffset                 : sizeof(uint32_t), only for top level instances, 0 if no schemas follow, else instanceSize + 1
+        // instance
+        //     |- uint32_t schemaIndex            : sizeof(uint32_t)
+        //     |- instance baseContent            : only if hasBaseClass
+        //     |- void*[] memberVariableContent   : in schema order
+        //         |- uint32_t contentSize        : sizeof(uint32_t), sameAsDefaultContentSize for default values
+        //         |- void* content               : contentSize, nested instances are written without schemasOffset
+        // schemas                                : only for top level instances, the schemas first used in the instance
+        //     |- uint32_t schemaCount            : sizeof(uint32_t)
+        //     |- schema[]                        : indexed after the schemas of the previous instances
+        //         |- std::string className       : classNameSize
+        //         |- bool hasBaseClass           : sizeof(bool)
+        //         |- uint32_t memberVariableCount : sizeof(uint32_t)
+        //         |- uint32_t[] nameHashAndTypeIds : sizeof(uint32_t) * 2 * memberVariableCount
 
         static size_t SerializeDyn(BinarySerializeStream& stream, const Mirror::Class& clazz, const Mirror::Argument& obj)
         {
+            if (stream.SchemaTableEnabled()) {
+                return Mirror::Internal::SerializeWithSchemaTable(stream, clazz, obj);
+            }
+
             Assert(!clazz.IsTransient());
             const auto& className = clazz.GetName();
             const auto* baseClass = clazz.GetBaseClass();
             const auto& memberVariables = clazz.GetMemberVariables();
             const auto defaultObject = clazz.GetDefaultObject();
+            const auto serializeMemberVariable = [&](BinarySerializeStream& inStream, const Mirror::MemberVariable& inMemberVariable) -> size_t {
+                const bool sameAsDefaultObject = defaultObject.Empty() || !inMemberVariable.GetTypeInfo()->equalComparable
+                    ? false
+                    : inMemberVariable.GetDyn(obj) == inMemberVariable.GetDyn(defaultObject);
+
+                size_t serialized = Serializer<std::string>::Serialize(inStream, inMemberVariable.GetName());
+                serialized += Serializer<bool>::Serialize(inStream, sameAsDefaultObject);
+                if (!sameAsDefaultObject) {
+                    serialized += inMemberVariable.GetDyn(obj).Serialize(inStream);
+                }
+                return serialized;
+            };
+
+            uint64_t memberVariableCount = 0;
+            for (const auto& memberVariable : memberVariables | std::views::values) {
+                memberVariableCount += memberVariable.IsTransient() ? 0 : 1;
+            }
+            std::vector<uint64_t> memberVariableContentEnds;
+            memberVariableContentEnds.reserve(memberVariableCount);
 
             const auto classNameSize = Serializer<std::string>::Serialize(stream, className);
 
+            // forward-only stream, the base class content size and the member variable ends are counted first
+            if (!stream.Seekable()) {
+                uint64_t baseClassContentSize = 0;
+                if (baseClass != nullptr) {
+                    SizeCountSerializeStream sizeCountStream(stream);
+                    baseClassContentSize = SerializeDyn(sizeCountStream, *baseClass, obj);
+                }
+                Serializer<uint64_t>::Serialize(stream, baseClassContentSize);
+                if (baseClass != nullptr) {
+                    SerializeDyn(stream, *baseClass, obj);
+                }
+
+                uint64_t memberVariableContentSize = 0;
+                SizeCountSerializeStream sizeCountStream(stream);
+                for (const auto& memberVariable : memberVariables | std::views::values) {
+                    if (!memberVariable.IsTransient()) {
+                        memberVariableContentSize += serializeMemberVariable(sizeCountStream, memberVariable);
+                        memberVariableContentEnds.emplace_back(memberVariableContentSize);
+                    }
+                }
+
+                Serializer<uint64_t>::Serialize(stream, memberVariableCount);
+                for (const auto& end : memberVariableContentEnds) {
+                    Serializer<uint64_t>::Serialize(stream, end);
+                }
+                for (const auto& memberVariable : memberVariables | std::views::values) {
+                    if (!memberVariable.IsTransient()) {
+                        serializeMemberVariable(stream, memberVariable);
+                    }
+                }
+                return classNameSize + baseClassContentSize + sizeof(uint64_t) * (memberVariableCount + 2) + memberVariableContentSize; // NOLINT
+            }
+
             uint64_t baseClassContentSize = 0;
             stream.Seek(sizeof(uint64_t));
             if (baseClass != nullptr) {
@@ -1985,27 +2080,13 @@ namespace Common { // NOLINT
             Serializer<uint64_t>::Serialize(stream, baseClassContentSize);
             stream.Seek(static_cast<int64_t>(baseClassContentSize));
 
-            const uint64_t memberVariableCount = memberVariables.size();
-            std::vector<uint64_t> memberVariableContentEnds;
-            memberVariableContentEnds.reserve(memberVariableCount);
-
             stream.Seek(static_cast<int64_t>(sizeof(uint64_t) * (memberVariableCount + 1)));
             uint64_t memberVariableContentSize = 0;
             for (const auto& memberVariable : memberVariables | std::views::values) {
-                if (memberVariable.IsTransient()) {
-                    continue;
-                }
-
-                const bool sameAsDefaultObject = defaultObject.Empty() || !memberVariable.GetTypeInfo()->equalComparable
-                    ? false
-                    : memberVariable.GetDyn(obj) == memberVariable.GetDyn(defaultObject);
-
-                memberVariableContentSize += Serializer<std::string>::Serialize(stream, memberVariable.GetName());
-                memberVariableContentSize += Serializer<bool>::Serialize(stream, sameAsDefaultObject);
-                if (!sameAsDefaultObject) {
-                    memberVariableContentSize += memberVariable.GetDyn(obj).Serialize(stream);
+                if (!memberVariable.IsTransient()) {
+                    memberVariableContentSize += serializeMemberVariable(stream, memberVariable);
+                    memberVariableContentEnds.emplace_back(memberVariableContentSize);
                 }
-                memberVariableContentEnds.emplace_back(memberVariableContentSize);
             }
 
             stream.Seek(-static_cast<int64_t>(memberVariableContentSize) - static_cast<int64_t>(sizeof(uint64_t) * (memberVariableCount + 1)));
@@ -2019,6 +2100,10 @@ namespace Common { // NOLINT
 
         static size_t DeserializeDyn(BinaryDeserializeStream& stream, const Mirror::Class& clazz, const Mirror::Argument& obj)
         {
+            if (stream.SchemaTableEnabled()) {
+                return Mirror::Internal::DeserializeWithSchemaTable(stream, clazz, obj);
+            }
+
             Assert(!clazz.IsTransient());
             const auto& className = clazz.GetName();
             const auto* baseClass = clazz.GetBaseClass();
@@ -3009,7 +3094,8 @@ namespace Mirror {
             Common::CppCopyAssignable<T>,
             Common::CppMoveConstructible<T>,
             Common::CppMoveAssignable<T>,
-            Common::EqualComparable<T>
+            Common::EqualComparable<T>,
+            Common::CppTriviallyCopyable<T>
         };
         return &typeInfo;
     }
@@ -3164,6 +3250,38 @@ namespace Mirror {
         return Common::Deserialize<T>(inStream, *static_cast<T*>(inThis));
     }
 
+    template <typename T>
+    size_t AnyRtti::SerializeContent(const void* inThis, Common::BinarySerializeStream& inStream)
+    {
+        if constexpr (Common::Serializable<T>) {
+            return Common::Serializer<T>::Serialize(inStream, *static_cast<const T*>(inThis));
+        } else {
+            QuickFailWithReason("your type is not support serialization");
+            return 0;
+        }
+    }
+
+    template <typename T>
+    size_t AnyRtti::DeserializeContent(void* inThis, Common::BinaryDeserializeStream& inStream)
+    {
+        if constexpr (Common::Serializable<T>) {
+            return Common::Serializer<T>::Deserialize(inStream, *static_cast<T*>(inThis));
+        } else {
+            QuickFailWithReason("your type is not support serialization");
+            return 0;
+        }
+    }
+
+    template <typename T>
+    uint32_t AnyRtti::GetSerializeTypeId()
+    {
+        if constexpr (Common::Serializable<T>) {
+            return static_cast<uint32_t>(Common::Serializer<T>::typeId);
+        } else {
+            return 0;
+        }
+    }
+
     template <typename T>
     void AnyRtti::JsonSerialize(const void* inThis, rapidjson::Value& outJsonValue, rapidjson::Document::AllocatorType& inAllocator)
     {
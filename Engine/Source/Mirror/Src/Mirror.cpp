@@ -5,6 +5,8 @@
 #include <ranges>
 #include <utility>
 #include <sstream>
+#include <limits>
+#include <unordered_set>
 
 #include <Mirror/Mirror.h>
 #include <Mirror/Registry.h>
@@ -642,6 +644,30 @@ namespace Mirror {
         return rtti->deserialize(Data(), inStream);
     }
 
+    size_t Any::SerializeContent(Common::BinarySerializeStream& inStream) const
+    {
+        Assert(!IsArray() && rtti != nullptr);
+        return rtti->serializeContent(Data(), inStream);
+    }
+
+    size_t Any::DeserializeContent(Common::BinaryDeserializeStream& inStream)
+    {
+        Assert(!IsArray() && rtti != nullptr && !IsConstRef());
+        return rtti->deserializeContent(Data(), inStream);
+    }
+
+    size_t Any::DeserializeContent(Common::BinaryDeserializeStream& inStream) const
+    {
+        Assert(!IsArray() && rtti != nullptr && IsNonConstRef());
+        return rtti->deserializeContent(Data(), inStream);
+    }
+
+    uint32_t Any::SerializeTypeId() const
+    {
+        Assert(!IsArray() && rtti != nullptr);
+        return rtti->getSerializeTypeId();
+    }
+
     void Any::JsonSerialize(rapidjson::Value& outJsonValue, rapidjson::Document::AllocatorType& inAllocator) const
     {
         Assert(!IsArray() && rtti != nullptr);
@@ -2599,3 +2625,368 @@ namespace Mirror {
         return rtti->emplace(ref, inIndex, inTempObj);
     }
 } // namespace Mirror
+
+namespace Mirror::Internal {
+    static constexpr uint32_t schemaTableFormatTag = Common::HashUtils::StrCrc32("Mirror::SchemaTable");
+    static constexpr uint32_t sameAsDefaultContentSize = std::numeric_limits<uint32_t>::max();
+
+    struct ClassSchemaWriteEntry {
+        uint32_t index;
+        const Class* clazz;
+        std::vector<const MemberVariable*> memberVariables;
+        std::vector<std::pair<uint32_t, uint32_t>> nameHashAndTypeIds;
+    };
+
+    // the schemas written to a stream so far, the element references stay valid while nested classes insert new ones,
+    // the forks of the size counting passes look up their parent and index their own schemas after the parent's
+    class ClassSchemaWriteTable final : public Common::SerializeStreamContext {
+    public:
+        explicit ClassSchemaWriteTable(const ClassSchemaWriteTable* inParent = nullptr)
+            : parent(inParent)
+            , depth(inParent != nullptr ? inParent->depth : 0)
+        {
+        }
+
+        std::unique_ptr<SerializeStreamContext> Fork() const override
+        {
+            return std::make_unique<ClassSchemaWriteTable>(this);
+        }
+
+        const ClassSchemaWriteEntry* Find(const Class* inClass) const
+        {
+            const auto iter = entries.find(inClass);
+            if (iter != entries.end()) {
+                return &iter->second;
+            }
+            return parent != nullptr ? parent->Find(inClass) : nullptr;
+        }
+
+        uint32_t ParentSize() const
+        {
+            return parent != nullptr ? parent->Size() : 0;
+        }
+
+        uint32_t Size() const
+        {
+            return static_cast<uint32_t>(entries.size()) + ParentSize();
+        }
+
+        const ClassSchemaWriteTable* parent;
+        // nesting level of the instance being written, the schemas are only written at the end of the top level ones
+        uint32_t depth;
+        std::unordered_map<const Class*, ClassSchemaWriteEntry> entries;
+        // own entries in index order
+        std::vector<const ClassSchemaWriteEntry*> orderedEntries;
+    };
+
+    struct ClassSchemaReadEntry {
+        const Class* clazz;
+        bool hasBaseClass;
+        std::vector<std::pair<uint32_t, uint32_t>> nameHashAndTypeIds;
+        // filled at the first instance of the schema, nullptr for the members removed from the class or retyped
+        bool resolved;
+        std::vector<const MemberVariable*> memberVariables;
+    };
+
+    class ClassSchemaReadTable final : public Common::SerializeStreamContext {
+    public:
+        ClassSchemaReadTable()
+            : depth(0)
+        {
+        }
+
+        uint32_t depth;
+        std::vector<ClassSchemaReadEntry> entries;
+    };
+
+    // the format tag is written with the table, before the first reflected class instance of the stream
+    static ClassSchemaWriteTable& GetSchemaWriteTable(Common::BinarySerializeStream& inStream, size_t& outSerialized)
+    {
+        if (inStream.GetContext() == nullptr) {
+            inStream.SetContext(std::make_unique<ClassSchemaWriteTable>());
+            outSerialized += Common::Serializer<uint32_t>::Serialize(inStream, schemaTableFormatTag);
+        }
+        return static_cast<ClassSchemaWriteTable&>(*inStream.GetContext());
+    }
+
+    static ClassSchemaReadTable& GetSchemaReadTable(Common::BinaryDeserializeStream& inStream, size_t& outDeserialized)
+    {
+        if (inStream.GetContext() == nullptr) {
+            inStream.SetContext(std::make_unique<ClassSchemaReadTable>());
+            uint32_t formatTag = 0;
+            outDeserialized += Common::Serializer<uint32_t>::Deserialize(inStream, formatTag);
+            AssertWithReason(formatTag == schemaTableFormatTag, "stream is not written in the schema table format");
+        }
+        return static_cast<ClassSchemaReadTable&>(*inStream.GetContext());
+    }
+
+    static bool SameAsDefaultObject(const MemberVariable& inMemberVariable, const Argument& inObj, const Any& inDefaultObject)
+    {
+        return !inDefaultObject.Empty()
+            && inMemberVariable.GetTypeInfo()->equalComparable
+            && inMemberVariable.GetDyn(inObj) == inMemberVariable.GetDyn(inDefaultObject);
+    }
+
+    static size_t WriteSchemas(Common::BinarySerializeStream& inStream, const ClassSchemaWriteTable& inTable, uint32_t inFirstIndex)
+    {
+        size_t serialized = 0;
+        const auto ownFirstIndex = inFirstIndex - inTable.ParentSize();
+        serialized += Common::Serializer<uint32_t>::Serialize(inStream, static_cast<uint32_t>(inTable.orderedEntries.size() - ownFirstIndex));
+        for (size_t i = ownFirstIndex; i < inTable.orderedEntries.size(); i++) {
+            const auto& entry = *inTable.orderedEntries[i];
+            serialized += Common::Serializer<std::string>::Serialize(inStream, entry.clazz->GetName());
+            serialized += Common::Serializer<bool>::Serialize(inStream, entry.clazz->GetBaseClass() != nullptr);
+            serialized += Common::Serializer<uint32_t>::Serialize(inStream, static_cast<uint32_t>(entry.nameHashAndTypeIds.size()));
+            for (const auto& [nameHash, typeId] : entry.nameHashAndTypeIds) {
+                serialized += Common::Serializer<uint32_t>::Serialize(inStream, nameHash);
+                serialized += Common::Serializer<uint32_t>::Serialize(inStream, typeId);
+            }
+        }
+        return serialized;
+    }
+
+    static size_t ReadSchemas(Common::BinaryDeserializeStream& inStream, ClassSchemaReadTable& inTable)
+    {
+        size_t deserialized = 0;
+        uint32_t schemaCount = 0;
+        deserialized += Common::Serializer<uint32_t>::Deserialize(inStream, schemaCount);
+        for (uint32_t i = 0; i < schemaCount; i++) {
+            std::string className;
+            ClassSchemaReadEntry entry {};
+            uint32_t memberVariableCount = 0;
+            deserialized += Common::Serializer<std::string>::Deserialize(inStream, className);
+            deserialized += Common::Serializer<bool>::Deserialize(inStream, entry.hasBaseClass);
+            deserialized += Common::Serializer<uint32_t>::Deserialize(inStream, memberVariableCount);
+            entry.nameHashAndTypeIds.resize(memberVariableCount);
+            for (auto& [nameHash, typeId] : entry.nameHashAndTypeIds) {
+                deserialized += Common::Serializer<uint32_t>::Deserialize(inStream, nameHash);
+                deserialized += Common::Serializer<uint32_t>::Deserialize(inStream, typeId);
+            }
+            entry.clazz = Class::Find(Id(className));
+            entry.resolved = false;
+            inTable.entries.emplace_back(std::move(entry));
+        }
+        return deserialized;
+    }
+
+    static uint32_t ReadSchemaIndex(Common::BinaryDeserializeStream& inStream, const ClassSchemaReadTable& inTable, size_t& outDeserialized)
+    {
+        uint32_t index = 0;
+        outDeserialized += Common::Serializer<uint32_t>::Deserialize(inStream, index);
+        AssertWithReason(index < inTable.entries.size(), "schema index out of the schema table");
+        return index;
+    }
+
+    static size_t SkipInstance(Common::BinaryDeserializeStream& inStream, ClassSchemaReadTable& inTable);
+
+    // skips the base class and member contents of an instance whose schema index is already read
+    static size_t SkipInstanceContent(Common::BinaryDeserializeStream& inStream, ClassSchemaReadTable& inTable, uint32_t inIndex)
+    {
+        size_t deserialized = 0;
+        if (inTable.entries[inIndex].hasBaseClass) {
+            deserialized += SkipInstance(inStream, inTable);
+        }
+
+        const auto memberVariableCount = inTable.entries[inIndex].nameHashAndTypeIds.size();
+        for (size_t i = 0; i < memberVariableCount; i++) {
+            uint32_t contentSize = 0;
+            deserialized += Common::Serializer<uint32_t>::Deserialize(inStream, contentSize);
+            if (contentSize != sameAsDefaultContentSize) {
+                inStream.Seek(contentSize);
+                deserialized += contentSize;
+            }
+        }
+        return deserialized;
+    }
+
+    static size_t SkipInstance(Common::BinaryDeserializeStream& inStream, ClassSchemaReadTable& inTable)
+    {
+        size_t deserialized = 0;
+        const auto index = ReadSchemaIndex(inStream, inTable, deserialized);
+        return deserialized + SkipInstanceContent(inStream, inTable, index);
+    }
+
+    // maps the schema members to the current members of the class by name hash, members whose serialize type changed
+    // are skipped like removed ones
+    static void ResolveSchema(ClassSchemaReadEntry& inEntry, const Argument& inObj)
+    {
+        std::unordered_map<uint32_t, const MemberVariable*> memberVariables;
+        for (const auto& memberVariable : inEntry.clazz->GetMemberVariables() | std::views::values) {
+            if (!memberVariable.IsTransient()) {
+                memberVariables.emplace(static_cast<uint32_t>(memberVariable.GetId().hash), &memberVariable);
+            }
+        }
+
+        inEntry.memberVariables.reserve(inEntry.nameHashAndTypeIds.size());
+        for (const auto& [nameHash, typeId] : inEntry.nameHashAndTypeIds) {
+            const auto iter = memberVariables.find(nameHash);
+            const bool matched = iter != memberVariables.end() && iter->second->GetDyn(inObj).SerializeTypeId() == typeId;
+            inEntry.memberVariables.emplace_back(matched ? iter->second : nullptr);
+        }
+        inEntry.resolved = true;
+    }
+
+    static size_t SerializeInstance(Common::BinarySerializeStream& inStream, ClassSchemaWriteTable& inTable, const Class& inClass, const Argument& inObj)
+    {
+        Assert(!inClass.IsTransient());
+        const auto* baseClass = inClass.GetBaseClass();
+        const auto defaultObject = inClass.GetDefaultObject();
+
+        const auto* entry = inTable.Find(&inClass);
+        if (entry == nullptr) {
+            auto& newEntry = inTable.entries.emplace(&inClass, ClassSchemaWriteEntry { inTable.Size(), &inClass, {}, {} }).first->second;
+            inTable.orderedEntries.emplace_back(&newEntry);
+            entry = &newEntry;
+
+            std::unordered_set<uint32_t> nameHashes;
+            for (const auto& memberVariable : inClass.GetMemberVariables() | std::views::values) {
+                if (memberVariable.IsTransient()) {
+                    continue;
+                }
+                const auto nameHash = static_cast<uint32_t>(memberVariable.GetId().hash);
+                AssertWithReason(nameHashes.emplace(nameHash).second, "member variable name hash conflict in class schema");
+                newEntry.memberVariables.emplace_back(&memberVariable);
+                newEntry.nameHashAndTypeIds.emplace_back(nameHash, memberVariable.GetDyn(inObj).SerializeTypeId());
+            }
+        }
+
+        size_t serialized = Common::Serializer<uint32_t>::Serialize(inStream, entry->index);
+        if (baseClass != nullptr) {
+            serialized += SerializeInstance(inStream, inTable, *baseClass, inObj);
+        }
+
+        for (const auto* memberVariable : entry->memberVariables) {
+            if (SameAsDefaultObject(*memberVariable, inObj, defaultObject)) {
+                serialized += Common::Serializer<uint32_t>::Serialize(inStream, sameAsDefaultContentSize);
+                continue;
+            }
+
+            if (!inStream.Seekable()) {
+                Common::SizeCountSerializeStream sizeCountStream(inStream);
+                const auto contentSize = memberVariable->GetDyn(inObj).SerializeContent(sizeCountStream);
+                AssertWithReason(contentSize < sameAsDefaultContentSize, "member variable content is too large for schema table format");
+                Common::Serializer<uint32_t>::Serialize(inStream, static_cast<uint32_t>(contentSize));
+                memberVariable->GetDyn(inObj).SerializeContent(inStream);
+                serialized += sizeof(uint32_t) + contentSize;
+                continue;
+            }
+
+            inStream.Seek(sizeof(uint32_t));
+            const auto contentSize = memberVariable->GetDyn(inObj).SerializeContent(inStream);
+            AssertWithReason(contentSize < sameAsDefaultContentSize, "member variable content is too large for schema table format");
+            inStream.Seek(-static_cast<int64_t>(contentSize) - static_cast<int64_t>(sizeof(uint32_t)));
+            Common::Serializer<uint32_t>::Serialize(inStream, static_cast<uint32_t>(contentSize));
+            inStream.Seek(static_cast<int64_t>(contentSize));
+            serialized += sizeof(uint32_t) + contentSize;
+        }
+        return serialized;
+    }
+
+    static size_t DeserializeInstance(Common::BinaryDeserializeStream& inStream, ClassSchemaReadTable& inTable, const Class& inClass, const Argument& inObj)
+    {
+        Assert(!inClass.IsTransient());
+        const auto* baseClass = inClass.GetBaseClass();
+        const auto defaultObject = inClass.GetDefaultObject();
+
+        size_t deserialized = 0;
+        const auto index = ReadSchemaIndex(inStream, inTable, deserialized);
+        if (inTable.entries[index].clazz != &inClass) {
+            // the class of the instance was renamed or replaced, skip it as a whole
+            return deserialized + SkipInstanceContent(inStream, inTable, index);
+        }
+
+        if (inTable.entries[index].hasBaseClass) {
+            deserialized += baseClass != nullptr
+                ? DeserializeInstance(inStream, inTable, *baseClass, inObj)
+                : SkipInstance(inStream, inTable);
+        }
+
+        auto& entry = inTable.entries[index];
+        if (!entry.resolved) {
+            ResolveSchema(entry, inObj);
+        }
+        for (const auto* memberVariable : entry.memberVariables) {
+            uint32_t contentSize = 0;
+            deserialized += Common::Serializer<uint32_t>::Deserialize(inStream, contentSize);
+
+            if (contentSize == sameAsDefaultContentSize) {
+                if (memberVariable != nullptr && !defaultObject.Empty()) {
+                    memberVariable->SetDyn(inObj, memberVariable->GetDyn(defaultObject));
+                }
+                continue;
+            }
+
+            size_t contentDeserialized = 0;
+            if (memberVariable != nullptr) {
+                contentDeserialized = memberVariable->GetDyn(inObj).DeserializeContent(inStream);
+            }
+            inStream.Seek(static_cast<int64_t>(contentSize) - static_cast<int64_t>(contentDeserialized));
+            deserialized += contentSize;
+        }
+        return deserialized;
+    }
+
+    size_t SerializeWithSchemaTable(Common::BinarySerializeStream& inStream, const Class& inClass, const Argument& inObj)
+    {
+        size_t serialized = 0;
+        auto& table = GetSchemaWriteTable(inStream, serialized);
+        if (table.depth > 0) {
+            return serialized + SerializeInstance(inStream, table, inClass, inObj);
+        }
+
+        // top level instance, the schemas first used anywhere inside it are written after its content, so a reader
+        // skipping a member content never misses a schema used again later
+        const auto firstNewIndex = table.Size();
+        table.depth++;
+        size_t contentSize = 0;
+        if (!inStream.Seekable()) {
+            Common::SizeCountSerializeStream sizeCountStream(inStream);
+            auto& countTable = static_cast<ClassSchemaWriteTable&>(*sizeCountStream.GetContext());
+            contentSize = SerializeInstance(sizeCountStream, countTable, inClass, inObj);
+            AssertWithReason(contentSize < std::numeric_limits<uint32_t>::max(), "class instance content is too large for schema table format");
+            Common::Serializer<uint32_t>::Serialize(inStream, countTable.entries.empty() ? 0 : static_cast<uint32_t>(contentSize + 1));
+            SerializeInstance(inStream, table, inClass, inObj);
+        } else {
+            inStream.Seek(sizeof(uint32_t));
+            contentSize = SerializeInstance(inStream, table, inClass, inObj);
+            AssertWithReason(contentSize < std::numeric_limits<uint32_t>::max(), "class instance content is too large for schema table format");
+            inStream.Seek(-static_cast<int64_t>(contentSize) - static_cast<int64_t>(sizeof(uint32_t)));
+            Common::Serializer<uint32_t>::Serialize(inStream, table.Size() == firstNewIndex ? 0 : static_cast<uint32_t>(contentSize + 1));
+            inStream.Seek(static_cast<int64_t>(contentSize));
+        }
+        table.depth--;
+        serialized += sizeof(uint32_t) + contentSize;
+
+        if (table.Size() != firstNewIndex) {
+            serialized += WriteSchemas(inStream, table, firstNewIndex);
+        }
+        return serialized;
+    }
+
+    size_t DeserializeWithSchemaTable(Common::BinaryDeserializeStream& inStream, const Class& inClass, const Argument& inObj)
+    {
+        size_t deserialized = 0;
+        auto& table = GetSchemaReadTable(inStream, deserialized);
+        if (table.depth > 0) {
+            return deserialized + DeserializeInstance(inStream, table, inClass, inObj);
+        }
+
+        // top level instance, the schemas following its content are read ahead of it
+        uint32_t schemasOffset = 0;
+        deserialized += Common::Serializer<uint32_t>::Deserialize(inStream, schemasOffset);
+        size_t schemasSize = 0;
+        if (schemasOffset != 0) {
+            const auto contentSize = static_cast<int64_t>(schemasOffset) - 1;
+            inStream.Seek(contentSize);
+            schemasSize = ReadSchemas(inStream, table);
+            inStream.Seek(-contentSize - static_cast<int64_t>(schemasSize));
+        }
+
+        table.depth++;
+        deserialized += DeserializeInstance(inStream, table, inClass, inObj);
+        table.depth--;
+
+        inStream.Seek(static_cast<int64_t>(schemasSize));
+        return deserialized + schemasSize;
+    }
+}
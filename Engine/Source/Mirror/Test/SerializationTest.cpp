@@ -77,6 +77,33 @@ void PerformJsonSerializationTest(const T& inValue, const std::string& inExceptJ
     }
 }
 
+template <typename T>
+size_t PerformSchemaTableSerializationTest(const T& object, bool inSchemaTable)
+{
+    std::vector<uint8_t> bytes;
+    {
+        Common::MemorySerializeStream stream(bytes);
+        if (inSchemaTable) {
+            stream.EnableSchemaTable();
+        }
+        Serialize(stream, object);
+    }
+
+    {
+        Common::MemoryDeserializeStream stream(bytes);
+        if (inSchemaTable) {
+            stream.EnableSchemaTable();
+        }
+
+        T restored;
+        const auto result = Deserialize(stream, restored);
+        EXPECT_TRUE(result.first);
+        EXPECT_EQ(result.second, bytes.size());
+        EXPECT_EQ(restored, object);
+    }
+    return bytes.size();
+}
+
 TEST(SerializationTest, VariableFileTest)
 {
     static Common::Path fileName = "../Test/Generated/Mirror/SerializationTest.VariableFileSerializationTest.bin";
@@ -139,6 +166,200 @@ TEST(SerializationTest, MetaObjectWithBaseClassTest)
         SerializationTestStruct2 { { 1, 2, "3.0" }, 4.0 });
 }
 
+TEST(SerializationTest, SchemaTableTest)
+{
+    PerformSchemaTableSerializationTest(SerializationTestStruct0 { 1, 2, "3.0" }, true);
+    PerformSchemaTableSerializationTest(SerializationTestStruct2 { { 1, 2, "3.0" }, 4.0 }, true);
+
+    SerializationTestStruct1 obj;
+    obj.a = { 1, 2 };
+    obj.b = { "3", "4" };
+    obj.c = { { 5, "6" }, { 7, "8" } };
+    obj.d = { { false, true }, { true, false } };
+    for (auto i = 0; i < 100; i++) {
+        obj.e.emplace_back(SerializationTestStruct0 { i, static_cast<float>(i), std::to_string(i) });
+    }
+    const auto legacySize = PerformSchemaTableSerializationTest(obj, false);
+    const auto schemaTableSize = PerformSchemaTableSerializationTest(obj, true);
+    ASSERT_LT(schemaTableSize * 2, legacySize);
+}
+
+TEST(SerializationTest, SchemaTableCompatibilityTest)
+{
+    // a schema written by an older SerializationTestStruct0, with a removed member z and a member a of another type
+    std::vector<uint8_t> bytes;
+    {
+        Common::MemorySerializeStream stream(bytes);
+        const auto writeMember = [&]<typename T>(const T& inValue) -> void {
+            Common::Serializer<uint32_t>::Serialize(stream, static_cast<uint32_t>(sizeof(T)));
+            Common::Serializer<T>::Serialize(stream, inValue);
+        };
+
+        Common::Serializer<uint32_t>::Serialize(stream, Common::HashUtils::StrCrc32("Mirror::SchemaTable"));
+        Common::Serializer<uint32_t>::Serialize(stream, sizeof(uint32_t) * 4 + sizeof(double) + sizeof(float) * 2 + 1);
+        Common::Serializer<uint32_t>::Serialize(stream, 0);
+        writeMember(1.0);
+        writeMember(2.0f);
+        writeMember(3.0f);
+        Common::Serializer<uint32_t>::Serialize(stream, 1);
+        Common::Serializer<std::string>::Serialize(stream, "SerializationTestStruct0");
+        Common::Serializer<bool>::Serialize(stream, false);
+        Common::Serializer<uint32_t>::Serialize(stream, 3);
+        Common::Serializer<uint32_t>::Serialize(stream, static_cast<uint32_t>(Id("z").hash));
+        Common::Serializer<uint32_t>::Serialize(stream, static_cast<uint32_t>(Common::Serializer<double>::typeId));
+        Common::Serializer<uint32_t>::Serialize(stream, static_cast<uint32_t>(Id("a").hash));
+        Common::Serializer<uint32_t>::Serialize(stream, static_cast<uint32_t>(Common::Serializer<float>::typeId));
+        Common::Serializer<uint32_t>::Serialize(stream, static_cast<uint32_t>(Id("b").hash));
+        Common::Serializer<uint32_t>::Serialize(stream, static_cast<uint32_t>(Common::Serializer<float>::typeId));
+
+        // the second instance references the schema by index and brings no new schema
+        Common::Serializer<uint32_t>::Serialize(stream, 0);
+        Common::Serializer<uint32_t>::Serialize(stream, 0);
+        writeMember(4.0);
+        writeMember(5.0f);
+        writeMember(6.0f);
+    }
+
+    Common::MemoryDeserializeStream stream(bytes);
+    stream.EnableSchemaTable();
+    SerializationTestStruct0 obj0 { 7, 0.0f, "8" };
+    SerializationTestStruct0 obj1 { 9, 0.0f, "10" };
+    const auto deserialized0 = Common::Serializer<SerializationTestStruct0>::Deserialize(stream, obj0);
+    const auto deserialized1 = Common::Serializer<SerializationTestStruct0>::Deserialize(stream, obj1);
+    ASSERT_EQ(deserialized0 + deserialized1, bytes.size());
+    ASSERT_EQ(obj0, (SerializationTestStruct0 { 7, 3.0f, "8" }));
+    ASSERT_EQ(obj1, (SerializationTestStruct0 { 9, 6.0f, "10" }));
+}
+
+TEST(SerializationTest, SchemaTableRemovedClassMemberTest)
+{
+    // an older SerializationTestStruct1 with a removed member z of SerializationTestStruct0, the first use of the
+    // SerializationTestStruct0 schema is inside the skipped z, it is used again by e and by the following instance
+    const SerializationTestStruct0 value { 1, 2.0f, "3" };
+    std::vector<uint8_t> valueContent;
+    {
+        Common::MemorySerializeStream stream(valueContent);
+        Common::Serializer<uint32_t>::Serialize(stream, 1);
+        Common::Serializer<uint32_t>::Serialize(stream, sizeof(int));
+        Common::Serializer<int>::Serialize(stream, value.a);
+        Common::Serializer<uint32_t>::Serialize(stream, sizeof(float));
+        Common::Serializer<float>::Serialize(stream, value.b);
+        Common::Serializer<uint32_t>::Serialize(stream, sizeof(uint64_t) + value.c.size());
+        Common::Serializer<std::string>::Serialize(stream, value.c);
+    }
+
+    std::vector<uint8_t> bytes;
+    {
+        Common::MemorySerializeStream stream(bytes);
+        const auto writeSchema = [&](const std::string& inClassName, const std::vector<std::pair<std::string, size_t>>& inMembers) -> void {
+            Common::Serializer<std::string>::Serialize(stream, inClassName);
+            Common::Serializer<bool>::Serialize(stream, false);
+            Common::Serializer<uint32_t>::Serialize(stream, static_cast<uint32_t>(inMembers.size()));
+            for (const auto& [name, typeId] : inMembers) {
+                Common::Serializer<uint32_t>::Serialize(stream, static_cast<uint32_t>(Id(name).hash));
+                Common::Serializer<uint32_t>::Serialize(stream, static_cast<uint32_t>(typeId));
+            }
+        };
+
+        const auto zSize = static_cast<uint32_t>(valueContent.size());
+        const auto eSize = static_cast<uint32_t>(sizeof(uint64_t) + valueContent.size());
+        Common::Serializer<uint32_t>::Serialize(stream, Common::HashUtils::StrCrc32("Mirror::SchemaTable"));
+        Common::Serializer<uint32_t>::Serialize(stream, sizeof(uint32_t) * 3 + zSize + eSize + 1);
+        Common::Serializer<uint32_t>::Serialize(stream, 0);
+        Common::Serializer<uint32_t>::Serialize(stream, zSize);
+        stream.WriteArray(valueContent.data(), valueContent.size());
+        Common::Serializer<uint32_t>::Serialize(stream, eSize);
+        Common::Serializer<uint64_t>::Serialize(stream, 1);
+        stream.WriteArray(valueContent.data(), valueContent.size());
+        Common::Serializer<uint32_t>::Serialize(stream, 2);
+        writeSchema("SerializationTestStruct1", {
+            { "z", Common::Serializer<SerializationTestStruct0>::typeId },
+            { "e", Common::Serializer<std::vector<SerializationTestStruct0>>::typeId }
+        });
+        writeSchema("SerializationTestStruct0", {
+            { "a", Common::Serializer<int>::typeId },
+            { "b", Common::Serializer<float>::typeId },
+            { "c", Common::Serializer<std::string>::typeId }
+        });
+
+        Common::Serializer<uint32_t>::Serialize(stream, 0);
+        stream.WriteArray(valueContent.data(), valueContent.size());
+    }
+
+    Common::MemoryDeserializeStream stream(bytes);
+    stream.EnableSchemaTable();
+    SerializationTestStruct1 obj0;
+    obj0.a = { 4 };
+    SerializationTestStruct0 obj1;
+    const auto deserialized0 = Common::Serializer<SerializationTestStruct1>::Deserialize(stream, obj0);
+    const auto deserialized1 = Common::Serializer<SerializationTestStruct0>::Deserialize(stream, obj1);
+    ASSERT_EQ(deserialized0 + deserialized1, bytes.size());
+    ASSERT_EQ(obj0.a, std::vector<int> { 4 });
+    ASSERT_EQ(obj0.e, std::vector<SerializationTestStruct0> { value });
+    ASSERT_EQ(obj1, value);
+
+    // the writer places the schemas the same way, a class first used in a nested member is readable later
+    SerializationTestStruct1 obj2;
+    obj2.e = { value };
+    std::vector<uint8_t> writtenBytes;
+    {
+        Common::MemorySerializeStream writeStream(writtenBytes);
+        writeStream.EnableSchemaTable();
+        Common::Serializer<SerializationTestStruct1>::Serialize(writeStream, obj2);
+        Common::Serializer<SerializationTestStruct0>::Serialize(writeStream, value);
+    }
+    Common::MemoryDeserializeStream readStream(writtenBytes);
+    readStream.EnableSchemaTable();
+    SerializationTestStruct1 obj3;
+    SerializationTestStruct0 obj4;
+    Common::Serializer<SerializationTestStruct1>::Deserialize(readStream, obj3);
+    Common::Serializer<SerializationTestStruct0>::Deserialize(readStream, obj4);
+    ASSERT_EQ(readStream.Loc(), writtenBytes.size());
+    ASSERT_EQ(obj3, obj2);
+    ASSERT_EQ(obj4, value);
+}
+
+template <typename T>
+void PerformForwardOnlySerializationTest(const T& object, bool inSchemaTable)
+{
+    std::vector<uint8_t> bytes;
+    {
+        Common::MemorySerializeStream stream(bytes);
+        if (inSchemaTable) {
+            stream.EnableSchemaTable();
+        }
+        Serialize(stream, object);
+    }
+
+    std::vector<uint8_t> forwardBytes;
+    {
+        Common::SinkSerializeStream stream([&](const void* inData, size_t inSize) -> void {
+            forwardBytes.insert(forwardBytes.end(), static_cast<const uint8_t*>(inData), static_cast<const uint8_t*>(inData) + inSize);
+        });
+        if (inSchemaTable) {
+            stream.EnableSchemaTable();
+        }
+        Serialize(stream, object);
+    }
+    ASSERT_EQ(forwardBytes, bytes);
+}
+
+TEST(SerializationTest, ForwardOnlyStreamTest)
+{
+    SerializationTestStruct1 obj;
+    obj.a = { 1, 2 };
+    obj.b = { "3", "4" };
+    obj.c = { { 5, "6" }, { 7, "8" } };
+    obj.d = { { false, true }, { true, false } };
+    obj.e = { { 1, 2.0f, "3" }, { 4, 5.0f, "6" } };
+
+    for (const auto schemaTable : { false, true }) {
+        PerformForwardOnlySerializationTest(SerializationTestStruct0 { 1, 2, "3.0" }, schemaTable);
+        PerformForwardOnlySerializationTest(SerializationTestStruct2 { { 1, 2, "3.0" }, 4.0 }, schemaTable);
+        PerformForwardOnlySerializationTest(obj, schemaTable);
+    }
+}
+
 TEST(SerializationTest, EnumSerializationTest)
 {
     PerformSerializationTest<SerializationTestEnum>(
@@ -11,6 +11,7 @@
 #include <variant>
 
 #include <Common/Memory.h>
+#include <Core/Thread.h>
 #include <RHI/RHI.h>
 #include <Render/ResourcePool.h>
 #include <Render/RenderCache.h>
@@ -394,10 +395,10 @@ namespace Render {
         void WaitBufferUploadsFinish() const;
         void DevirtualizeViewsCreatedOnImportedResources();
         void DevirtualizeResource(RGResourceRef inResource);
-        void DevirtualizeResources(const std::unordered_set<RGResourceRef>& inResources);
+        void DevirtualizeResources(const Common::FrameUnorderedSet<RGResourceRef>& inResources);
         void DevirtualizeBindGroupsAndViews(const std::vector<RGBindGroupRef>& inBindGroups);
         void DevirtualizeAttachmentViews(const RGRasterPassDesc& inDesc);
-        void FinalizePassResources(const std::unordered_set<RGResourceRef>& inResources);
+        void FinalizePassResources(const Common::FrameUnorderedSet<RGResourceRef>& inResources);
         void FinalizePassBindGroups(const std::vector<RGBindGroupRef>& inBindGroups);
         void TransitionResourcesForCopyPassDesc(RHI::CommonCommandRecorder& inRecoder, const RGCopyPassDesc& inDesc);
         void TransitionResourcesForRasterPassDesc(RHI::CommonCommandRecorder& inRecoder, const RGRasterPassDesc& inDesc);
@@ -415,17 +416,18 @@ namespace Render {
         std::vector<std::unordered_map<RGQueueType, std::vector<RGPassRef>>> asyncTimelines;
         std::unordered_map<RGBufferRef, RGBufferUploadInfo> bufferUploads;
 
-        // execute context
-        std::unordered_map<RGResourceRef, uint32_t> resourceReadCounts;
-        std::unordered_map<RGPassRef, std::unordered_set<RGResourceRef>> passReadsMap;
-        std::unordered_map<RGPassRef, std::unordered_set<RGResourceRef>> passWritesMap;
-        std::unordered_set<RGResourceRef> culledResources;
-        std::unordered_set<RGPassRef> culledPasses;
-        std::unordered_map<RGResourceRef, std::variant<RHI::BufferState, RHI::TextureState>> resourceStates;
+        // execute context, the lookup tables live in the frame arena of the building thread, so the builder is expected to be
+        // executed and destroyed within the frame it was created
+        Common::FrameUnorderedMap<RGResourceRef, uint32_t> resourceReadCounts;
+        Common::FrameUnorderedMap<RGPassRef, Common::FrameUnorderedSet<RGResourceRef>> passReadsMap;
+        Common::FrameUnorderedMap<RGPassRef, Common::FrameUnorderedSet<RGResourceRef>> passWritesMap;
+        Common::FrameUnorderedSet<RGResourceRef> culledResources;
+        Common::FrameUnorderedSet<RGPassRef> culledPasses;
+        Common::FrameUnorderedMap<RGResourceRef, std::variant<RHI::BufferState, RHI::TextureState>> resourceStates;
         std::vector<AsyncTimelineExecuteContext> asyncTimelineExecuteContexts;
-        std::unordered_map<RGResourceRef, std::variant<PooledBufferRef, PooledTextureRef>> devirtualizedResources;
-        std::unordered_map<RGResourceViewRef, std::variant<RHI::BufferView*, RHI::TextureView*>> devirtualizedResourceViews;
-        std::unordered_map<RGBindGroupRef, RHI::BindGroup*> devirtualizedBindGroups;
+        Common::FrameUnorderedMap<RGResourceRef, std::variant<PooledBufferRef, PooledTextureRef>> devirtualizedResources;
+        Common::FrameUnorderedMap<RGResourceViewRef, std::variant<RHI::BufferView*, RHI::TextureView*>> devirtualizedResourceViews;
+        Common::FrameUnorderedMap<RGBindGroupRef, RHI::BindGroup*> devirtualizedBindGroups;
         std::vector<std::future<void>> bufferUploadTasks;
     };
 }
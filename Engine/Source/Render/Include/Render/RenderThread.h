@@ -19,6 +19,8 @@ namespace Render {
         void Stop();
         void Flush() const;
         template <typename F> auto EmplaceTask(F&& inTask);
+        // fire-and-forget, no future is created
+        template <typename F> void PostTask(F&& inTask);
 
     private:
         RenderThread();
@@ -35,7 +37,10 @@ namespace Render {
         void Start();
         void Stop();
         template <typename F> auto EmplaceTask(F&& inTask);
+        template <typename F> void PostTask(F&& inTask);
         template <typename F> void ExecuteTasks(size_t inTaskNum, F&& inTask);
+        // inFunc(i) for i in [inBegin, inEnd) with ThreadTag::renderWorker set, the calling thread takes part
+        template <typename F> void ParallelFor(size_t inBegin, size_t inEnd, size_t inGrainSize, F&& inFunc);
 
     private:
         RenderWorkerThreads();
@@ -52,15 +57,32 @@ namespace Render {
         return thread->EmplaceTask(std::forward<F>(inTask));
     }
 
+    template <typename F>
+    void RenderThread::PostTask(F&& inTask)
+    {
+        Assert(thread != nullptr);
+        thread->PostTask(std::forward<F>(inTask));
+    }
+
     template <typename F>
     auto RenderWorkerThreads::EmplaceTask(F&& inTask)
     {
         using RetType = std::invoke_result_t<F>;
 
         Assert(threads != nullptr);
-        return threads->EmplaceTask([inTask]() -> RetType {
+        return threads->EmplaceTask([task = std::forward<F>(inTask)]() mutable -> RetType {
             Core::ScopedThreadTag tag(Core::ThreadTag::renderWorker);
-            return inTask();
+            return task();
+        });
+    }
+
+    template <typename F>
+    void RenderWorkerThreads::PostTask(F&& inTask)
+    {
+        Assert(threads != nullptr);
+        threads->PostTask([task = std::forward<F>(inTask)]() mutable -> void {
+            Core::ScopedThreadTag tag(Core::ThreadTag::renderWorker);
+            task();
         });
     }
 
@@ -74,4 +96,14 @@ namespace Render {
             reboundTask(inIndex);
         });
     }
+
+    template <typename F>
+    void RenderWorkerThreads::ParallelFor(size_t inBegin, size_t inEnd, size_t inGrainSize, F&& inFunc)
+    {
+        Assert(threads != nullptr);
+        threads->ParallelFor(inBegin, inEnd, inGrainSize, [&inFunc](size_t inIndex) -> void {
+            Core::ScopedThreadTag tag(Core::ThreadTag::renderWorker);
+            inFunc(inIndex);
+        });
+    }
 }
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <span>
+
 #include <Render/Scene.h>
 #include <Render/View.h>
 #include <Render/RenderGraph.h>
@@ -22,7 +24,7 @@ namespace Render {
             const Scene* scene;
             const RHI::Texture* surface;
             Common::UVec2 surfaceExtent;
-            std::vector<View> views;
+            std::span<const View> views;
             RHI::Semaphore* waitSemaphore;
             RHI::Semaphore* signalSemaphore;
             RHI::Fence* signalFence;
@@ -38,7 +40,7 @@ namespace Render {
         const Scene* scene;
         const RHI::Texture* surface;
         Common::UVec2 surfaceExtent;
-        std::vector<View> views;
+        std::span<const View> views;
         RHI::Semaphore* waitSemaphore;
         RHI::Semaphore* signalSemaphore;
         RHI::Fence* signalFence;
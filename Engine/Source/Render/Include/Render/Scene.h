@@ -4,16 +4,55 @@
 
 #pragma once
 
+#include <tuple>
+#include <vector>
+#include <unordered_map>
+
 #include <Common/Debug.h>
 #include <Core/Thread.h>
 #include <Render/SceneProxy/Light.h>
+#include <Render/SceneProxy/Primitive.h>
 
 namespace Render {
+    using SceneEntityId = uint32_t;
+
+    // sparse set of one scene proxy type, proxies are packed in a dense array so renderer stages can walk all of them
+    // linearly, removal swaps the last proxy into the hole
+    template <typename SP>
+    class SceneProxyContainer {
+    public:
+        using EntityId = SceneEntityId;
+
+        SceneProxyContainer();
+
+        template <typename T> SP& Emplace(EntityId inEntity, T&& inSceneProxy);
+        bool Contains(EntityId inEntity) const;
+        SP& Get(EntityId inEntity);
+        const SP& Get(EntityId inEntity) const;
+        void Remove(EntityId inEntity);
+        void Clear();
+        size_t Size() const;
+        bool Empty() const;
+        // proxies[i] belongs to entities[i]
+        std::vector<SP>& Proxies();
+        const std::vector<SP>& Proxies() const;
+        const std::vector<EntityId>& Entities() const;
+        auto begin();
+        auto begin() const;
+        auto end();
+        auto end() const;
+
+    private:
+        std::vector<SP> proxies;
+        std::vector<EntityId> entities;
+        std::unordered_map<EntityId, size_t> indices;
+    };
+
     // Render::Scene is a container of render-thread world data copy.
     // Notice all operations to scene need be down in render-thread.
     class Scene final {
     public:
-        using EntityId = uint32_t;
+        using EntityId = SceneEntityId;
 
         Scene();
         ~Scene();
@@ -22,74 +61,185 @@ namespace Render {
         NonMovable(Scene)
 
         template <typename SP> void Add(EntityId inEntity, SP&& inSceneProxy);
+        template <typename SP> bool Has(EntityId inEntity) const;
         template <typename SP> SP& Get(EntityId inEntity);
         template <typename SP> const SP& Get(EntityId inEntity) const;
         template <typename SP> void Remove(EntityId inEntity);
+        template <typename SP> SceneProxyContainer<SP>& All();
+        template <typename SP> const SceneProxyContainer<SP>& All() const;
 
     private:
-        template <typename SP> using SceneProxyContainer = std::unordered_map<EntityId, LightSceneProxy>;
-
-        template <typename SP> SceneProxyContainer<SP>& GetSceneProxyContainer();
-        template <typename SP> const SceneProxyContainer<SP>& GetSceneProxyContainer() const;
+        // register new scene proxy types here
+        using SceneProxyContainers = std::tuple<
+            SceneProxyContainer<LightSceneProxy>,
+            SceneProxyContainer<PrimitiveSceneProxy>>;
 
-        SceneProxyContainer<LightSceneProxy> lightSceneProxies;
+        SceneProxyContainers sceneProxies;
     };
 }
 
 namespace Render {
     template <typename SP>
-    void Scene::Add(EntityId inEntity, SP&& inSceneProxy)
+    SceneProxyContainer<SP>::SceneProxyContainer() = default;
+
+    template <typename SP>
+    template <typename T>
+    SP& SceneProxyContainer<SP>::Emplace(EntityId inEntity, T&& inSceneProxy)
     {
-        Assert(Core::ThreadContext::IsRenderThread());
-        GetSceneProxyContainer<SP>().emplace(inEntity, std::move(inSceneProxy)); // NOLINT
+        const auto [iter, inserted] = indices.emplace(inEntity, proxies.size());
+        if (!inserted) {
+            auto& sceneProxy = proxies[iter->second];
+            sceneProxy = std::forward<T>(inSceneProxy);
+            return sceneProxy;
+        }
+        entities.emplace_back(inEntity);
+        return proxies.emplace_back(std::forward<T>(inSceneProxy));
     }
 
     template <typename SP>
-    SP& Scene::Get(EntityId inEntity)
+    bool SceneProxyContainer<SP>::Contains(EntityId inEntity) const
+    {
+        return indices.contains(inEntity);
+    }
+
+    template <typename SP>
+    SP& SceneProxyContainer<SP>::Get(EntityId inEntity)
+    {
+        return proxies[indices.at(inEntity)];
+    }
+
+    template <typename SP>
+    const SP& SceneProxyContainer<SP>::Get(EntityId inEntity) const
+    {
+        return proxies[indices.at(inEntity)];
+    }
+
+    template <typename SP>
+    void SceneProxyContainer<SP>::Remove(EntityId inEntity)
+    {
+        const auto iter = indices.find(inEntity);
+        if (iter == indices.end()) {
+            return;
+        }
+
+        const size_t index = iter->second;
+        const size_t lastIndex = proxies.size() - 1;
+        if (index != lastIndex) {
+            proxies[index] = std::move(proxies[lastIndex]);
+            entities[index] = entities[lastIndex];
+            indices.at(entities[index]) = index;
+        }
+        proxies.pop_back();
+        entities.pop_back();
+        indices.erase(iter);
+    }
+
+    template <typename SP>
+    void SceneProxyContainer<SP>::Clear()
+    {
+        proxies.clear();
+        entities.clear();
+        indices.clear();
+    }
+
+    template <typename SP>
+    size_t SceneProxyContainer<SP>::Size() const
+    {
+        return proxies.size();
+    }
+
+    template <typename SP>
+    bool SceneProxyContainer<SP>::Empty() const
+    {
+        return proxies.empty();
+    }
+
+    template <typename SP>
+    std::vector<SP>& SceneProxyContainer<SP>::Proxies()
+    {
+        return proxies;
+    }
+
+    template <typename SP>
+    const std::vector<SP>& SceneProxyContainer<SP>::Proxies() const
+    {
+        return proxies;
+    }
+
+    template <typename SP>
+    const std::vector<typename SceneProxyContainer<SP>::EntityId>& SceneProxyContainer<SP>::Entities() const
+    {
+        return entities;
+    }
+
+    template <typename SP>
+    auto SceneProxyContainer<SP>::begin()
+    {
+        return proxies.begin();
+    }
+
+    template <typename SP>
+    auto SceneProxyContainer<SP>::begin() const
+    {
+        return proxies.begin();
+    }
+
+    template <typename SP>
+    auto SceneProxyContainer<SP>::end()
+    {
+        return proxies.end();
+    }
+
+    template <typename SP>
+    auto SceneProxyContainer<SP>::end() const
+    {
+        return proxies.end();
+    }
+
+    template <typename SP>
+    void Scene::Add(EntityId inEntity, SP&& inSceneProxy)
     {
         Assert(Core::ThreadContext::IsRenderThread());
-        return GetSceneProxyContainer<SP>().at(inEntity);
+        All<std::decay_t<SP>>().Emplace(inEntity, std::forward<SP>(inSceneProxy));
     }
 
     template <typename SP>
-    const SP& Scene::Get(EntityId inEntity) const
+    bool Scene::Has(EntityId inEntity) const
     {
         Assert(Core::ThreadContext::IsRenderThread());
-        return GetSceneProxyContainer<SP>().at(inEntity);
+        return All<SP>().Contains(inEntity);
     }
 
     template <typename SP>
-    void Scene::Remove(EntityId inEntity)
+    SP& Scene::Get(EntityId inEntity)
     {
         Assert(Core::ThreadContext::IsRenderThread());
-        GetSceneProxyContainer<SP>().erase(inEntity);
+        return All<SP>().Get(inEntity);
     }
 
     template <typename SP>
-    Scene::SceneProxyContainer<SP>& Scene::GetSceneProxyContainer()
+    const SP& Scene::Get(EntityId inEntity) const
     {
-        Unimplement();
-        return *static_cast<SceneProxyContainer<SP>*>(nullptr); // NOLINT
+        Assert(Core::ThreadContext::IsRenderThread());
+        return All<SP>().Get(inEntity);
     }
 
     template <typename SP>
-    const Scene::SceneProxyContainer<SP>& Scene::GetSceneProxyContainer() const
+    void Scene::Remove(EntityId inEntity)
     {
-        Unimplement();
-        return *static_cast<const SceneProxyContainer<SP>*>(nullptr); // NOLINT
+        Assert(Core::ThreadContext::IsRenderThread());
+        All<SP>().Remove(inEntity);
     }
-}
 
-namespace Render {
-    template <>
-    inline Scene::SceneProxyContainer<LightSceneProxy>& Scene::GetSceneProxyContainer<LightSceneProxy>()
+    template <typename SP>
+    SceneProxyContainer<SP>& Scene::All()
     {
-        return lightSceneProxies;
+        return std::get<SceneProxyContainer<SP>>(sceneProxies);
     }
 
-    template <>
-    inline const Scene::SceneProxyContainer<LightSceneProxy>& Scene::GetSceneProxyContainer<LightSceneProxy>() const
+    template <typename SP>
+    const SceneProxyContainer<SP>& Scene::All() const
     {
-        return lightSceneProxies;
+        return std::get<SceneProxyContainer<SP>>(sceneProxies);
     }
 }
@@ -13,3 +13,7 @@ namespace Render {
         // TODO
     };
 }
+
+namespace Render {
+    inline PrimitiveSceneProxy::PrimitiveSceneProxy() = default;
+}
@@ -0,0 +1,187 @@
+//
+// Created by johnk on 2026/10/18.
+//
+
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <mutex>
+
+#include <Common/Utility.h>
+#include <Common/Memory.h>
+#include <Common/Math/Matrix.h>
+#include <Render/Scene.h>
+
+namespace Render {
+    // SceneUpdateBuffer records the scene proxy changes of one game frame as typed records in a linear arena, the whole
+    // buffer is submitted to render thread as a single task and applied to Render::Scene in record order. Workers can
+    // fill their own buffers in parallel, and Append() them into the frame buffer before submitting.
+    class SceneUpdateBuffer final {
+    public:
+        using EntityId = Scene::EntityId;
+
+        explicit SceneUpdateBuffer(size_t inBlockSize = defaultBlockSize);
+        ~SceneUpdateBuffer();
+
+        NonCopyable(SceneUpdateBuffer)
+        SceneUpdateBuffer(SceneUpdateBuffer&& inOther) noexcept;
+        SceneUpdateBuffer& operator=(SceneUpdateBuffer&& inOther) noexcept;
+
+        template <typename SP> void Add(EntityId inEntity, SP&& inSceneProxy);
+        template <typename SP> void UpdateTransform(EntityId inEntity, const Common::FMat4x4& inLocalToWorld);
+        // inUpdater is invoked with SP& on render thread
+        template <typename SP, typename F> void UpdateContent(EntityId inEntity, F&& inUpdater);
+        template <typename SP> void Remove(EntityId inEntity);
+
+        // records of inOther are placed after the records of this buffer
+        void Append(SceneUpdateBuffer&& inOther);
+        // must be called on render thread, the buffer is empty after applied
+        void Apply(Scene& inScene);
+        void Reset();
+        size_t Size() const;
+        bool Empty() const;
+
+        static constexpr size_t defaultBlockSize = 64 * 1024;
+
+    private:
+        using ApplyFunc = void(Scene&, void*);
+        using DestructFunc = void(void*);
+
+        struct Record {
+            ApplyFunc* apply;
+            DestructFunc* destruct;
+            void* payload;
+        };
+
+        struct Block {
+            explicit Block(size_t inSize);
+
+            std::vector<std::byte> memory;
+            size_t used;
+        };
+
+        template <typename SP> struct AddRecord;
+        template <typename SP> struct TransformRecord;
+        template <typename SP, typename F> struct ContentRecord;
+        template <typename SP> struct RemoveRecord;
+
+        void* Allocate(size_t inSize, size_t inAlignment);
+        template <typename R, typename... Args> void EmplaceRecord(Args&&... inArgs);
+
+        size_t blockSize;
+        size_t currentBlock;
+        std::vector<Block> blocks;
+        std::vector<Record> records;
+    };
+
+    // Recycles the scene update buffers handed to render thread, so their blocks are reused by the following frames
+    // instead of being allocated every frame. Game thread takes a buffer with Acquire(), render thread gives it back with
+    // Release() once applied. Up to bufferNum buffers are kept, Acquire() only allocates while all of them are in flight.
+    class SceneUpdateBufferPool final {
+    public:
+        static constexpr size_t bufferNum = 3;
+
+        explicit SceneUpdateBufferPool(size_t inBlockSize = SceneUpdateBuffer::defaultBlockSize);
+        ~SceneUpdateBufferPool();
+
+        NonCopyable(SceneUpdateBufferPool)
+        NonMovable(SceneUpdateBufferPool)
+
+        Common::UniquePtr<SceneUpdateBuffer> Acquire();
+        // the buffer is reset, it can be released from any thread
+        void Release(Common::UniquePtr<SceneUpdateBuffer>&& inBuffer);
+        size_t FreeBufferNum() const;
+
+    private:
+        size_t blockSize;
+        mutable std::mutex mutex;
+        std::vector<Common::UniquePtr<SceneUpdateBuffer>> freeBuffers;
+    };
+}
+
+namespace Render {
+    template <typename SP>
+    struct SceneUpdateBuffer::AddRecord {
+        void Apply(Scene& inScene)
+        {
+            inScene.Add<SP>(entity, std::move(sceneProxy));
+        }
+
+        EntityId entity;
+        SP sceneProxy;
+    };
+
+    template <typename SP>
+    struct SceneUpdateBuffer::TransformRecord {
+        void Apply(Scene& inScene) const
+        {
+            inScene.Get<SP>(entity).localToWorld = localToWorld;
+        }
+
+        EntityId entity;
+        Common::FMat4x4 localToWorld;
+    };
+
+    template <typename SP, typename F>
+    struct SceneUpdateBuffer::ContentRecord {
+        void Apply(Scene& inScene)
+        {
+            updater(inScene.Get<SP>(entity));
+        }
+
+        EntityId entity;
+        F updater;
+    };
+
+    template <typename SP>
+    struct SceneUpdateBuffer::RemoveRecord {
+        void Apply(Scene& inScene) const
+        {
+            inScene.Remove<SP>(entity);
+        }
+
+        EntityId entity;
+    };
+
+    template <typename SP>
+    void SceneUpdateBuffer::Add(EntityId inEntity, SP&& inSceneProxy)
+    {
+        using ProxyType = std::decay_t<SP>;
+        EmplaceRecord<AddRecord<ProxyType>>(inEntity, std::forward<SP>(inSceneProxy));
+    }
+
+    template <typename SP>
+    void SceneUpdateBuffer::UpdateTransform(EntityId inEntity, const Common::FMat4x4& inLocalToWorld)
+    {
+        EmplaceRecord<TransformRecord<SP>>(inEntity, inLocalToWorld);
+    }
+
+    template <typename SP, typename F>
+    void SceneUpdateBuffer::UpdateContent(EntityId inEntity, F&& inUpdater)
+    {
+        EmplaceRecord<ContentRecord<SP, std::decay_t<F>>>(inEntity, std::forward<F>(inUpdater));
+    }
+
+    template <typename SP>
+    void SceneUpdateBuffer::Remove(EntityId inEntity)
+    {
+        EmplaceRecord<RemoveRecord<SP>>(inEntity);
+    }
+
+    template <typename R, typename... Args>
+    void SceneUpdateBuffer::EmplaceRecord(Args&&... inArgs)
+    {
+        static_assert(alignof(R) <= alignof(std::max_align_t));
+        void* payload = Allocate(sizeof(R), alignof(R));
+        new(payload) R { std::forward<Args>(inArgs)... };
+
+        Record record {};
+        record.apply = [](Scene& inScene, void* inPayload) -> void { static_cast<R*>(inPayload)->Apply(inScene); };
+        record.destruct = [](void* inPayload) -> void { static_cast<R*>(inPayload)->~R(); };
+        record.payload = payload;
+        records.emplace_back(record);
+    }
+}
@@ -9,7 +9,7 @@
 #include <Common/Container.h>
 
 namespace Render::Internal {
-    static void ComputeReadsWritesForBindGroup(const RGBindGroupDesc& inDesc, std::unordered_set<RGResourceRef>& outReads, std::unordered_set<RGResourceRef>& outWrites)
+    static void ComputeReadsWritesForBindGroup(const RGBindGroupDesc& inDesc, Common::FrameUnorderedSet<RGResourceRef>& outReads, Common::FrameUnorderedSet<RGResourceRef>& outWrites)
     {
         for (const auto& [type, view] : inDesc.items | std::views::values) {
             if (type == RHI::BindingType::uniformBuffer) {
@@ -387,6 +387,15 @@ namespace Render {
     RGBuilder::RGBuilder(RHI::Device& inDevice)
         : executed(false)
         , device(inDevice)
+        , resourceReadCounts(Core::ThreadContext::FrameArena())
+        , passReadsMap(Core::ThreadContext::FrameArena())
+        , passWritesMap(Core::ThreadContext::FrameArena())
+        , culledResources(Core::ThreadContext::FrameArena())
+        , culledPasses(Core::ThreadContext::FrameArena())
+        , resourceStates(Core::ThreadContext::FrameArena())
+        , devirtualizedResources(Core::ThreadContext::FrameArena())
+        , devirtualizedResourceViews(Core::ThreadContext::FrameArena())
+        , devirtualizedBindGroups(Core::ThreadContext::FrameArena())
     {
     }
 
@@ -642,8 +651,8 @@ namespace Render {
             auto* passRef = pass.Get();
             Assert(!passReadsMap.contains(passRef));
             Assert(!passWritesMap.contains(passRef));
-            passReadsMap.emplace(std::make_pair(passRef, std::unordered_set<RGResourceRef> {}));
-            passWritesMap.emplace(std::make_pair(passRef, std::unordered_set<RGResourceRef> {}));
+            passReadsMap.emplace(passRef, passReadsMap.get_allocator());
+            passWritesMap.emplace(passRef, passWritesMap.get_allocator());
             auto& passReads = passReadsMap.at(passRef);
             auto& passWrites = passWritesMap.at(passRef);
 
@@ -692,8 +701,10 @@ namespace Render {
     {
         auto collectQueueReadWrites = [this](const std::vector<RGPassRef>& passes, std::unordered_set<RGResourceRef>& outReads, std::unordered_set<RGResourceRef>& outWrites) -> void {
             for (auto* pass : passes) {
-                Common::SetUtils::GetUnionInplace(outReads, passReadsMap.at(pass));
-                Common::SetUtils::GetUnionInplace(outWrites, passWritesMap.at(pass));
+                const auto& passReads = passReadsMap.at(pass);
+                const auto& passWrites = passWritesMap.at(pass);
+                outReads.insert(passReads.begin(), passReads.end());
+                outWrites.insert(passWrites.begin(), passWrites.end());
             }
         };
 
@@ -927,7 +938,7 @@ namespace Render {
         }
     }
 
-    void RGBuilder::DevirtualizeResources(const std::unordered_set<RGResourceRef>& inResources)
+    void RGBuilder::DevirtualizeResources(const Common::FrameUnorderedSet<RGResourceRef>& inResources)
     {
         for (auto* resource : inResources) {
             DevirtualizeResource(resource);
@@ -982,7 +993,7 @@ namespace Render {
         }
     }
 
-    void RGBuilder::FinalizePassResources(const std::unordered_set<RGResourceRef>& inResources)
+    void RGBuilder::FinalizePassResources(const Common::FrameUnorderedSet<RGResourceRef>& inResources)
     {
         for (auto* resource : inResources) {
             if (auto& readCount = resourceReadCounts.at(resource);
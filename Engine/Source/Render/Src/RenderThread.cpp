@@ -19,7 +19,7 @@ namespace Render {
     {
         Assert(thread == nullptr);
         thread = Common::MakeUnique<Common::WorkerThread>("RenderingThread");
-        thread->EmplaceTask([]() -> void { Core::ThreadContext::SetTag(Core::ThreadTag::render); });
+        thread->PostTask([]() -> void { Core::ThreadContext::SetTag(Core::ThreadTag::render); });
     }
 
     void RenderThread::Stop()
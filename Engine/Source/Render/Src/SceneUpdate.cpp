@@ -0,0 +1,157 @@
+//
+// Created by johnk on 2026/10/18.
+//
+
+#include <algorithm>
+
+#include <Render/SceneUpdate.h>
+
+namespace Render {
+    SceneUpdateBuffer::Block::Block(size_t inSize)
+        : memory(inSize)
+        , used(0)
+    {
+    }
+
+    SceneUpdateBuffer::SceneUpdateBuffer(size_t inBlockSize)
+        : blockSize(inBlockSize)
+        , currentBlock(0)
+    {
+        Assert(blockSize > 0);
+    }
+
+    SceneUpdateBuffer::~SceneUpdateBuffer()
+    {
+        Reset();
+    }
+
+    SceneUpdateBuffer::SceneUpdateBuffer(SceneUpdateBuffer&& inOther) noexcept
+        : blockSize(inOther.blockSize)
+        , currentBlock(inOther.currentBlock)
+        , blocks(std::move(inOther.blocks))
+        , records(std::move(inOther.records))
+    {
+        inOther.currentBlock = 0;
+        inOther.blocks.clear();
+        inOther.records.clear();
+    }
+
+    SceneUpdateBuffer& SceneUpdateBuffer::operator=(SceneUpdateBuffer&& inOther) noexcept
+    {
+        if (this == &inOther) {
+            return *this;
+        }
+        Reset();
+        blockSize = inOther.blockSize;
+        currentBlock = inOther.currentBlock;
+        blocks = std::move(inOther.blocks);
+        records = std::move(inOther.records);
+        inOther.currentBlock = 0;
+        inOther.blocks.clear();
+        inOther.records.clear();
+        return *this;
+    }
+
+    void SceneUpdateBuffer::Append(SceneUpdateBuffer&& inOther)
+    {
+        Assert(this != &inOther);
+        // payloads never move since block memory is not reallocated, only the block handles are transferred
+        blocks.reserve(blocks.size() + inOther.blocks.size());
+        for (auto& block : inOther.blocks) {
+            blocks.emplace_back(std::move(block));
+        }
+        records.insert(records.end(), inOther.records.begin(), inOther.records.end());
+
+        inOther.currentBlock = 0;
+        inOther.blocks.clear();
+        inOther.records.clear();
+    }
+
+    void SceneUpdateBuffer::Apply(Scene& inScene)
+    {
+        Assert(Core::ThreadContext::IsRenderThread());
+        for (const auto& record : records) {
+            record.apply(inScene, record.payload);
+        }
+        Reset();
+    }
+
+    void SceneUpdateBuffer::Reset()
+    {
+        for (const auto& record : records) {
+            record.destruct(record.payload);
+        }
+        records.clear();
+
+        for (auto& block : blocks) {
+            block.used = 0;
+        }
+        currentBlock = 0;
+    }
+
+    size_t SceneUpdateBuffer::Size() const
+    {
+        return records.size();
+    }
+
+    bool SceneUpdateBuffer::Empty() const
+    {
+        return records.empty();
+    }
+
+    void* SceneUpdateBuffer::Allocate(size_t inSize, size_t inAlignment)
+    {
+        for (; currentBlock < blocks.size(); currentBlock++) {
+            auto& block = blocks[currentBlock];
+            const size_t offset = (block.used + inAlignment - 1) / inAlignment * inAlignment;
+            if (offset + inSize <= block.memory.size()) {
+                block.used = offset + inSize;
+                return block.memory.data() + offset;
+            }
+        }
+
+        auto& block = blocks.emplace_back(std::max(blockSize, inSize));
+        block.used = inSize;
+        return block.memory.data();
+    }
+
+    SceneUpdateBufferPool::SceneUpdateBufferPool(size_t inBlockSize)
+        : blockSize(inBlockSize)
+    {
+        freeBuffers.reserve(bufferNum);
+    }
+
+    SceneUpdateBufferPool::~SceneUpdateBufferPool() = default;
+
+    Common::UniquePtr<SceneUpdateBuffer> SceneUpdateBufferPool::Acquire()
+    {
+        std::unique_lock lock(mutex);
+        if (freeBuffers.empty()) {
+            lock.unlock();
+            return Common::MakeUnique<SceneUpdateBuffer>(blockSize);
+        }
+        auto result = std::move(freeBuffers.back());
+        freeBuffers.pop_back();
+        return result;
+    }
+
+    void SceneUpdateBufferPool::Release(Common::UniquePtr<SceneUpdateBuffer>&& inBuffer)
+    {
+        Assert(inBuffer != nullptr);
+        inBuffer->Reset();
+
+        std::unique_lock lock(mutex);
+        if (freeBuffers.size() < bufferNum) {
+            freeBuffers.emplace_back(std::move(inBuffer));
+            return;
+        }
+        lock.unlock();
+        inBuffer.Reset();
+    }
+
+    size_t SceneUpdateBufferPool::FreeBufferNum() const
+    {
+        std::unique_lock lock(mutex);
+        return freeBuffers.size();
+    }
+}
@@ -0,0 +1,42 @@
+//
+// Created by johnk on 2026/10/18.
+//
+
+#include <Test/Test.h>
+
+#include <Render/Scene.h>
+
+using namespace Render;
+
+TEST(SceneTest, SceneProxyContainerTest)
+{
+    Core::ScopedThreadTag tag(Core::ThreadTag::render);
+
+    Scene scene;
+    for (auto i = 1; i <= 4; i++) {
+        LightSceneProxy sceneProxy;
+        sceneProxy.intensity = static_cast<float>(i);
+        scene.Add(i, std::move(sceneProxy));
+    }
+    scene.Add(5, PrimitiveSceneProxy());
+    ASSERT_EQ(scene.All<LightSceneProxy>().Size(), 4);
+    ASSERT_EQ(scene.All<PrimitiveSceneProxy>().Size(), 1);
+
+    scene.Remove<LightSceneProxy>(2);
+    ASSERT_FALSE(scene.Has<LightSceneProxy>(2));
+    ASSERT_EQ(scene.Get<LightSceneProxy>(4).intensity, 4.0f);
+
+    const auto& lights = scene.All<LightSceneProxy>();
+    ASSERT_EQ(lights.Size(), 3);
+    float intensitySum = 0.0f;
+    for (auto i = 0; i < lights.Size(); i++) {
+        ASSERT_EQ(lights.Proxies()[i].intensity, static_cast<float>(lights.Entities()[i]));
+        intensitySum += lights.Proxies()[i].intensity;
+    }
+    ASSERT_EQ(intensitySum, 8.0f);
+
+    scene.Remove<LightSceneProxy>(4);
+    scene.Remove<LightSceneProxy>(4);
+    ASSERT_EQ(lights.Size(), 2);
+    ASSERT_EQ(scene.Get<LightSceneProxy>(3).intensity, 3.0f);
+}
@@ -0,0 +1,89 @@
+//
+// Created by johnk on 2026/10/18.
+//
+
+#include <Test/Test.h>
+
+#include <Render/SceneUpdate.h>
+
+using namespace Render;
+
+TEST(SceneUpdateTest, ApplyInOrderTest)
+{
+    Core::ScopedThreadTag tag(Core::ThreadTag::render);
+
+    Scene scene;
+    SceneUpdateBuffer updates(256);
+    for (auto i = 1; i <= 100; i++) {
+        LightSceneProxy sceneProxy;
+        sceneProxy.type = LightType::point;
+        sceneProxy.intensity = static_cast<float>(i);
+        updates.Add(i, std::move(sceneProxy));
+    }
+    updates.UpdateContent<LightSceneProxy>(1, [](LightSceneProxy& outSceneProxy) -> void {
+        outSceneProxy.radius = 2.0f;
+    });
+    updates.UpdateTransform<LightSceneProxy>(2, Common::FMat4x4Consts::zero);
+    updates.Remove<LightSceneProxy>(3);
+    ASSERT_EQ(updates.Size(), 103);
+
+    updates.Apply(scene);
+    ASSERT_TRUE(updates.Empty());
+    ASSERT_EQ(scene.Get<LightSceneProxy>(100).intensity, 100.0f);
+    ASSERT_EQ(scene.Get<LightSceneProxy>(1).radius, 2.0f);
+    ASSERT_EQ(scene.Get<LightSceneProxy>(2).localToWorld, Common::FMat4x4Consts::zero);
+}
+
+TEST(SceneUpdateTest, AppendTest)
+{
+    Core::ScopedThreadTag tag(Core::ThreadTag::render);
+
+    Scene scene;
+    SceneUpdateBuffer updates;
+    SceneUpdateBuffer workerUpdates;
+    updates.Add(1, LightSceneProxy());
+    workerUpdates.UpdateContent<LightSceneProxy>(1, [](LightSceneProxy& outSceneProxy) -> void {
+        outSceneProxy.intensity = 3.0f;
+    });
+
+    updates.Append(std::move(workerUpdates));
+    ASSERT_TRUE(workerUpdates.Empty()); // NOLINT
+    ASSERT_EQ(updates.Size(), 2);
+
+    updates.Apply(scene);
+    ASSERT_EQ(scene.Get<LightSceneProxy>(1).intensity, 3.0f);
+}
+
+TEST(SceneUpdateTest, PoolRecycleTest)
+{
+    Core::ScopedThreadTag tag(Core::ThreadTag::render);
+
+    Scene scene;
+    SceneUpdateBufferPool pool(256);
+    auto updates = pool.Acquire();
+    for (auto i = 1; i <= 100; i++) {
+        updates->Add(i, LightSceneProxy());
+    }
+    auto* recycled = updates.Get();
+    updates->Apply(scene);
+    pool.Release(std::move(updates));
+    ASSERT_EQ(pool.FreeBufferNum(), 1);
+
+    // the applied buffer comes back empty and is reused instead of a new one
+    updates = pool.Acquire();
+    ASSERT_EQ(updates.Get(), recycled);
+    ASSERT_TRUE(updates->Empty());
+    ASSERT_EQ(pool.FreeBufferNum(), 0);
+    updates->Remove<LightSceneProxy>(1);
+    pool.Release(std::move(updates));
+
+    // buffers beyond the ring size are dropped
+    std::vector<Common::UniquePtr<SceneUpdateBuffer>> inFlight;
+    for (size_t i = 0; i < SceneUpdateBufferPool::bufferNum + 2; i++) {
+        inFlight.emplace_back(pool.Acquire());
+    }
+    for (auto& buffer : inFlight) {
+        pool.Release(std::move(buffer));
+    }
+    ASSERT_EQ(pool.FreeBufferNum(), SceneUpdateBufferPool::bufferNum);
+}
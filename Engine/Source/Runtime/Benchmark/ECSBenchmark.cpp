@@ -0,0 +1,369 @@
+//
+// Created by johnk on 2026/10/18.
+//
+
+#include <cmath>
+#include <string>
+#include <format>
+#include <utility>
+
+#include <benchmark/benchmark.h>
+
+#include <ECSBenchmark.h>
+#include <Mirror/Registry.h>
+#include <Core/Thread.h>
+#include <Runtime/GameThread.h>
+#include <Runtime/System/Transform.h>
+using namespace Runtime;
+
+// MirrorTool does not reflect class templates, so the trivial systems are registered by hand in one fold expression
+template <size_t N>
+class TrivialSystem : public System {
+public:
+    static const Mirror::Class& GetStaticClass()
+    {
+        static const Mirror::Class& clazz = Mirror::Class::Get<TrivialSystem>();
+        return clazz;
+    }
+
+    explicit TrivialSystem(ECRegistry& inRegistry, const SystemSetupContext& inContext)
+        : System(inRegistry, inContext)
+    {
+    }
+
+    ~TrivialSystem() override = default;
+
+    const Mirror::Class& GetClass() const override
+    {
+        return GetStaticClass();
+    }
+
+    void Tick(float inDeltaTimeSeconds) override
+    {
+        benchmark::DoNotOptimize(inDeltaTimeSeconds);
+    }
+};
+
+namespace {
+    constexpr size_t trivialSystemClassNum = 10;
+
+    template <size_t... I>
+    std::vector<SystemClass> RegisterTrivialSystems(std::index_sequence<I...>)
+    {
+        (Mirror::Registry::Get()
+            .Class<TrivialSystem<I>, System>(std::format("TrivialSystem{}", I))
+                .template Constructor<ECRegistry&, const SystemSetupContext&>("TrivialSystem"), ...);
+        return { &TrivialSystem<I>::GetStaticClass()... };
+    }
+
+    const std::vector<SystemClass>& GetTrivialSystemClasses()
+    {
+        static const std::vector<SystemClass> systemClasses = RegisterTrivialSystems(std::make_index_sequence<trivialSystemClassNum>());
+        return systemClasses;
+    }
+}
+
+// The systems do no work, so these benchmarks measure the pure per-tick scheduling overhead of SystemGraphExecutor.
+// A system group can hold each system class only once, so graphs are built from groups of the ten trivial systems,
+// alternating concurrent and sequential groups to cover both fan-out/barrier and chain dependencies.
+namespace {
+    class ScopedGameWorkers {
+    public:
+        ScopedGameWorkers()
+        {
+            GameWorkerThreads::Get().Start();
+        }
+
+        ~ScopedGameWorkers()
+        {
+            GameWorkerThreads::Get().Stop();
+        }
+    };
+
+    SystemGraph MakeTrivialSystemGraph(size_t inSystemNum)
+    {
+        const auto& systemClasses = GetTrivialSystemClasses();
+
+        SystemGraph systemGraph;
+        const size_t groupNum = (inSystemNum + systemClasses.size() - 1) / systemClasses.size();
+        for (size_t i = 0; i < groupNum; i++) {
+            const auto strategy = i % 2 == 0 ? SystemExecuteStrategy::concurrent : SystemExecuteStrategy::sequential;
+            auto& group = systemGraph.AddGroup("Group" + std::to_string(i), strategy);
+            for (size_t j = 0; j < systemClasses.size() && i * systemClasses.size() + j < inSystemNum; j++) {
+                group.EmplaceSystemDyn(systemClasses[j]);
+            }
+        }
+        return systemGraph;
+    }
+
+    void EmplaceMovingEntities(ECRegistry& inRegistry, size_t inEntityNum)
+    {
+        for (size_t i = 0; i < inEntityNum; i++) {
+            const auto entity = inRegistry.Create();
+            inRegistry.Emplace<BenchPosition>(entity);
+            inRegistry.Emplace<BenchVelocity>(entity);
+        }
+    }
+
+    // inTreeNum trees of inTreeSize nodes, node i of a tree is attached to node (i - 1) / inFanOut, returns the roots
+    std::vector<Entity> EmplaceSceneGraph(ECRegistry& inRegistry, size_t inTreeNum, size_t inTreeSize, size_t inFanOut)
+    {
+        std::vector<Entity> roots;
+        std::vector<Entity> nodes;
+        roots.reserve(inTreeNum);
+        nodes.reserve(inTreeSize);
+        for (size_t t = 0; t < inTreeNum; t++) {
+            nodes.clear();
+            for (size_t i = 0; i < inTreeSize; i++) {
+                const auto entity = inRegistry.Create();
+                inRegistry.EmplaceBundle(
+                    entity,
+                    Hierarchy(),
+                    LocalTransform(Common::FTransform(Common::FQuatConsts::identity, Common::FVec3(1.0f, 0.0f, 0.0f))),
+                    WorldTransform());
+                if (i > 0) {
+                    HierarchyOps::AttachToParent(inRegistry, entity, nodes[(i - 1) / inFanOut]);
+                }
+                nodes.emplace_back(entity);
+            }
+            roots.emplace_back(nodes[0]);
+        }
+        return roots;
+    }
+
+    void Move(BenchPosition& inPosition, BenchVelocity& inVelocity)
+    {
+        constexpr float deltaTimeSeconds = 0.0167f;
+        constexpr float damping = 0.99f;
+
+        const float speed = std::sqrt(inVelocity.x * inVelocity.x + inVelocity.y * inVelocity.y + inVelocity.z * inVelocity.z);
+        const float scale = speed > 10.0f ? 10.0f / speed : damping;
+        inVelocity.x *= scale;
+        inVelocity.y *= scale;
+        inVelocity.z *= scale;
+        inPosition.x += inVelocity.x * deltaTimeSeconds;
+        inPosition.y += inVelocity.y * deltaTimeSeconds;
+        inPosition.z += inVelocity.z * deltaTimeSeconds;
+    }
+}
+
+static void SystemGraphExecutorTick(benchmark::State& state)
+{
+    const auto systemNum = static_cast<size_t>(state.range(0));
+    ScopedGameWorkers gameWorkers;
+
+    SystemSetupContext setupContext;
+    setupContext.playType = PlayType::game;
+
+    ECRegistry registry;
+    SystemGraphExecutor executor(registry, MakeTrivialSystemGraph(systemNum), setupContext);
+    for (auto _ : state) {
+        executor.Tick(0.0167f);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(systemNum));
+}
+BENCHMARK(SystemGraphExecutorTick)->Arg(10)->Arg(100)->Arg(1000);
+
+// Each vs ParallelEach over the same 1M-entity registry, the per-entity work is a small integration step so the
+// difference shows how well the chunk batches spread over the game workers
+static void ViewEach(benchmark::State& state)
+{
+    ECRegistry registry;
+    EmplaceMovingEntities(registry, static_cast<size_t>(state.range(0)));
+
+    const auto view = registry.View<BenchPosition, BenchVelocity>();
+    for (auto _ : state) {
+        view.Each([](Entity, BenchPosition& position, BenchVelocity& velocity) -> void {
+            Move(position, velocity);
+        });
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(ViewEach)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+static void ViewParallelEach(benchmark::State& state)
+{
+    ScopedGameWorkers gameWorkers;
+
+    ECRegistry registry;
+    EmplaceMovingEntities(registry, static_cast<size_t>(state.range(0)));
+
+    const auto view = registry.View<BenchPosition, BenchVelocity>();
+    const auto grainSize = static_cast<size_t>(state.range(1));
+    for (auto _ : state) {
+        view.ParallelEach([](Entity, BenchPosition& position, BenchVelocity& velocity) -> void {
+            Move(position, velocity);
+        }, grainSize);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(ViewParallelEach)->Args({ 1000000, 256 })->Args({ 1000000, 1024 })->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// spawning a wave of entities, one archetype migration per component vs a single bundle construction
+static void SpawnPerComponent(benchmark::State& state)
+{
+    const auto entityNum = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        ECRegistry registry;
+        for (size_t i = 0; i < entityNum; i++) {
+            const auto entity = registry.Create();
+            registry.Emplace<BenchPosition>(entity);
+            registry.Emplace<BenchVelocity>(entity);
+        }
+        benchmark::DoNotOptimize(registry.Count());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(SpawnPerComponent)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+static void SpawnBundle(benchmark::State& state)
+{
+    const auto entityNum = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        ECRegistry registry;
+        for (size_t i = 0; i < entityNum; i++) {
+            const auto entity = registry.Create();
+            registry.EmplaceBundle(entity, BenchPosition(), BenchVelocity());
+        }
+        benchmark::DoNotOptimize(registry.Count());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(SpawnBundle)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+static void SpawnCommandBuffer(benchmark::State& state)
+{
+    const auto entityNum = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        ECRegistry registry;
+        auto& commands = registry.Commands();
+        for (size_t i = 0; i < entityNum; i++) {
+            const auto entity = commands.Create();
+            commands.Emplace<BenchPosition>(entity);
+            commands.Emplace<BenchVelocity>(entity);
+        }
+        registry.PlaybackCommands();
+        benchmark::DoNotOptimize(registry.Count());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(SpawnCommandBuffer)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+// 100k-node scene graph, every root moves each tick so the whole graph is propagated level by level
+static void TransformSystemTick(benchmark::State& state)
+{
+    constexpr size_t treeSize = 1000;
+    constexpr size_t fanOut = 4;
+    const auto nodeNum = static_cast<size_t>(state.range(0));
+    ScopedGameWorkers gameWorkers;
+
+    ECRegistry registry;
+    const auto roots = EmplaceSceneGraph(registry, nodeNum / treeSize, treeSize, fanOut);
+
+    SystemSetupContext setupContext;
+    setupContext.playType = PlayType::game;
+    TransformSystem transformSystem(registry, setupContext);
+    transformSystem.Tick(0.0167f);
+
+    // transient containers of a tick come from the game thread frame arena, the arena allocations are the heap allocations
+    // the tick did before adopting it, the block allocations are the ones left
+    auto& frameArena = Core::ThreadContext::FrameArena();
+    size_t arenaAllocationNum = 0;
+    size_t heapAllocationNum = 0;
+    for (auto _ : state) {
+        Core::ThreadContext::IncFrameNumber();
+        for (const auto root : roots) {
+            registry.Update<WorldTransform>(root, [](WorldTransform& outTransform) -> void {
+                outTransform.localToWorld.Translate(Common::FVec3(0.0f, 0.0f, 1.0f));
+            });
+        }
+        transformSystem.Tick(0.0167f);
+        arenaAllocationNum += frameArena.CurrentFrameStats().allocationNum;
+        heapAllocationNum += frameArena.CurrentFrameStats().blockAllocationNum;
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(nodeNum));
+    state.counters["arenaAllocsPerFrame"] = benchmark::Counter(static_cast<double>(arenaAllocationNum), benchmark::Counter::kAvgIterations);
+    state.counters["heapAllocsPerFrame"] = benchmark::Counter(static_cast<double>(heapAllocationNum), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(TransformSystemTick)->Arg(100000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// level snapshot of a 200k-entity registry, the ECArchive path (one serialized buffer per component per entity) vs the
+// columnar snapshot (one blob per archetype column)
+static void SnapshotSaveArchive(benchmark::State& state)
+{
+    ECRegistry registry;
+    EmplaceMovingEntities(registry, static_cast<size_t>(state.range(0)));
+
+    std::vector<uint8_t> bytes;
+    for (auto _ : state) {
+        ECArchive archive;
+        registry.Save(archive);
+        bytes.clear();
+        Common::MemorySerializeStream stream(bytes);
+        Common::Serialize(stream, archive);
+        benchmark::DoNotOptimize(bytes.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(SnapshotSaveArchive)->Arg(200000)->Unit(benchmark::kMillisecond);
+
+static void SnapshotLoadArchive(benchmark::State& state)
+{
+    std::vector<uint8_t> bytes;
+    {
+        ECRegistry registry;
+        EmplaceMovingEntities(registry, static_cast<size_t>(state.range(0)));
+        ECArchive archive;
+        registry.Save(archive);
+        Common::MemorySerializeStream stream(bytes);
+        Common::Serialize(stream, archive);
+    }
+
+    for (auto _ : state) {
+        ECArchive archive;
+        Common::MemoryDeserializeStream stream(bytes);
+        Common::Deserialize(stream, archive);
+        ECRegistry registry;
+        registry.Load(archive);
+        benchmark::DoNotOptimize(registry.Count());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(SnapshotLoadArchive)->Arg(200000)->Unit(benchmark::kMillisecond);
+
+static void SnapshotSaveColumnar(benchmark::State& state)
+{
+    ECRegistry registry;
+    EmplaceMovingEntities(registry, static_cast<size_t>(state.range(0)));
+
+    std::vector<uint8_t> bytes;
+    for (auto _ : state) {
+        registry.SaveColumnar(bytes);
+        benchmark::DoNotOptimize(bytes.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(SnapshotSaveColumnar)->Arg(200000)->Unit(benchmark::kMillisecond);
+
+static void SnapshotLoadColumnar(benchmark::State& state)
+{
+    std::vector<uint8_t> bytes;
+    {
+        ECRegistry registry;
+        EmplaceMovingEntities(registry, static_cast<size_t>(state.range(0)));
+        registry.SaveColumnar(bytes);
+    }
+
+    for (auto _ : state) {
+        ECRegistry registry;
+        if (!registry.LoadColumnar(bytes.data(), bytes.size())) {
+            state.SkipWithError("failed to load the columnar snapshot");
+            break;
+        }
+        benchmark::DoNotOptimize(registry.Count());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(SnapshotLoadColumnar)->Arg(200000)->Unit(benchmark::kMillisecond);
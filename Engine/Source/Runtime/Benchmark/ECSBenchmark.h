@@ -0,0 +1,38 @@
+//
+// Created by johnk on 2026/10/18.
+//
+
+#pragma once
+
+#include <Runtime/Meta.h>
+#include <Runtime/ECS.h>
+
+struct EClass() BenchPosition {
+    EClassBody(BenchPosition)
+
+    BenchPosition()
+        : x(0.0f)
+        , y(0.0f)
+        , z(0.0f)
+    {
+    }
+
+    EProperty() float x;
+    EProperty() float y;
+    EProperty() float z;
+};
+
+struct EClass() BenchVelocity {
+    EClassBody(BenchVelocity)
+
+    BenchVelocity()
+        : x(1.0f)
+        , y(2.0f)
+        , z(3.0f)
+    {
+    }
+
+    EProperty() float x;
+    EProperty() float y;
+    EProperty() float z;
+};
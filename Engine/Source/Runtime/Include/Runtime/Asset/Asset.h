@@ -11,7 +11,9 @@
 
 #include <Common/Memory.h>
 #include <Common/Serialization.h>
+#include <Common/Compression.h>
 #include <Common/Concurrent.h>
+#include <Common/Coroutine.h>
 #include <Common/Concepts.h>
 #include <Core/Uri.h>
 #include <Runtime/Meta.h>
@@ -119,22 +121,29 @@ namespace Runtime {
     };
 
     template <Common::DerivedFrom<Asset> A> using OnAssetLoaded = std::function<void(AssetPtr<A>)>;
-    template <Common::DerivedFrom<Asset> A> using OnSoftAssetLoaded = std::function<void()>;
+    template <Common::DerivedFrom<Asset> A> using OnSoftAssetLoaded = std::function<void(AssetPtr<A>)>;
 
     class RUNTIME_API AssetManager {
     public:
         static AssetManager& Get();
         ~AssetManager();
 
+        // the loads return a null pointer if the asset file is corrupted
         template <Common::DerivedFrom<Asset> A> AssetPtr<A> SyncLoad(const Core::Uri& uri, const Mirror::Class& clazz);
         template <Common::DerivedFrom<Asset> A> void SyncLoadSoft(SoftAssetPtr<A>& softAssetRef, const Mirror::Class& clazz);
         template <Common::DerivedFrom<Asset> A> void AsyncLoad(const Core::Uri& uri, const Mirror::Class& clazz, const OnAssetLoaded<A>& onAssetLoaded);
-        template <Common::DerivedFrom<Asset> A> void AsyncLoadSoft(SoftAssetPtr<A>& softAssetRef, const Mirror::Class& clazz, const OnSoftAssetLoaded<A>& onSoftAssetLoaded);
-        template <Common::DerivedFrom<Asset> A> void Save(const AssetPtr<A>& assetRef);
+        // the loaded asset is only handed to the callback, which runs on the asset thread pool, softAssetRef is not
+        // touched since it may be gone or in use by its owner by then, the owner assigns it on its own thread
+        template <Common::DerivedFrom<Asset> A> void AsyncLoadSoft(const SoftAssetPtr<A>& softAssetRef, const Mirror::Class& clazz, const OnSoftAssetLoaded<A>& onSoftAssetLoaded);
+        // loads on the asset thread pool, the awaiting coroutine continues there once loaded
+        template <Common::DerivedFrom<Asset> A> Common::CoTask<AssetPtr<A>> CoLoad(Core::Uri uri, const Mirror::Class& clazz);
+        // compression is opt-in, it shrinks the files of large and repetitive assets but makes their loads pay the decode
+        template <Common::DerivedFrom<Asset> A> void Save(const AssetPtr<A>& assetRef, bool compress = false);
         template <Common::DerivedFrom<Asset> A> void SaveSoft(const SoftAssetPtr<A>& softAssetRef);
 
     private:
         template <Common::DerivedFrom<Asset> A> AssetPtr<A> LoadInternal(const Core::Uri& uri, const Mirror::Class& clazz);
+        template <Common::DerivedFrom<Asset> A> Common::CoTask<void> AsyncLoadInternal(Core::Uri uri, const Mirror::Class& clazz, OnAssetLoaded<A> onAssetLoaded);
 
         AssetManager();
 
@@ -546,6 +555,9 @@ namespace Runtime {
         }
 
         AssetPtr<A> result = LoadInternal<A>(uri, clazz);
+        if (result == nullptr) {
+            return result;
+        }
         AssetPtr<Asset> tempRef = result.template StaticCast<Asset>();
         if (iter == weakAssetRefs.end()) {
             weakAssetRefs.emplace(std::make_pair(uri, WeakAssetPtr<Asset>(tempRef)));
@@ -564,55 +576,66 @@ namespace Runtime {
     template <Common::DerivedFrom<Asset> A>
     void AssetManager::AsyncLoad(const Core::Uri& uri, const Mirror::Class& clazz, const OnAssetLoaded<A>& onAssetLoaded)
     {
-        threadPool.EmplaceTask([=, this]() -> void {
-            AssetPtr<A> result = nullptr;
-            {
-                std::unique_lock<std::mutex> lock(mutex);
-                auto iter = weakAssetRefs.find(uri);
-                if (iter != weakAssetRefs.end() && !iter->second.Expired()) {
-                    result = iter->second.Lock().StaticCast<A>();
-                }
-            }
-
-            if (result == nullptr) {
-                result = LoadInternal<A>(uri, clazz);
-            }
-
-            AssetPtr<Asset> tempRef = result.template StaticCast<Asset>();
-            {
-                std::unique_lock<std::mutex> lock(mutex);
-                auto iter = weakAssetRefs.find(uri);
-                if (iter == weakAssetRefs.end()) {
-                    weakAssetRefs.emplace(std::make_pair(uri, WeakAssetPtr<Asset>(tempRef)));
-                } else {
-                    iter->second = tempRef;
-                }
-            }
+        Common::Spawn(threadPool, AsyncLoadInternal<A>(uri, clazz, onAssetLoaded));
+    }
 
-            onAssetLoaded(result);
-        });
+    template <Common::DerivedFrom<Asset> A>
+    void AssetManager::AsyncLoadSoft(const SoftAssetPtr<A>& softAssetRef, const Mirror::Class& clazz, const OnSoftAssetLoaded<A>& onSoftAssetLoaded)
+    {
+        // only the uri is captured, the coroutine frame keeps no reference to the soft pointer
+        Common::Spawn(threadPool, AsyncLoadInternal<A>(softAssetRef.Uri(), clazz, onSoftAssetLoaded));
     }
 
     template <Common::DerivedFrom<Asset> A>
-    void AssetManager::AsyncLoadSoft(SoftAssetPtr<A>& softAssetRef, const Mirror::Class& clazz, const OnSoftAssetLoaded<A>& onSoftAssetLoaded)
+    Common::CoTask<AssetPtr<A>> AssetManager::CoLoad(Core::Uri uri, const Mirror::Class& clazz)
     {
-        threadPool.EmplaceTask([this, softAssetRef, onSoftAssetLoaded, clazz]() -> void {
-            AsyncLoad(softAssetRef.Uri(), clazz, [&](AssetPtr<A>& ref) -> void {
-                softAssetRef = ref;
-                onSoftAssetLoaded();
-            });
-        });
+        if (!threadPool.InWorker()) {
+            co_await Common::ResumeOn(threadPool);
+        }
+
+        AssetPtr<A> result = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            auto iter = weakAssetRefs.find(uri);
+            if (iter != weakAssetRefs.end() && !iter->second.Expired()) {
+                result = iter->second.Lock().StaticCast<A>();
+            }
+        }
+
+        if (result == nullptr) {
+            result = LoadInternal<A>(uri, clazz);
+        }
+        if (result == nullptr) {
+            co_return result;
+        }
+
+        AssetPtr<Asset> tempRef = result.template StaticCast<Asset>();
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            auto iter = weakAssetRefs.find(uri);
+            if (iter == weakAssetRefs.end()) {
+                weakAssetRefs.emplace(std::make_pair(uri, WeakAssetPtr<Asset>(tempRef)));
+            } else {
+                iter->second = tempRef;
+            }
+        }
+        co_return result;
     }
 
     template <Common::DerivedFrom<Asset> A>
-    void AssetManager::Save(const AssetPtr<A>& assetRef)
+    void AssetManager::Save(const AssetPtr<A>& assetRef, bool compress)
     {
         Assert(assetRef.Valid());
         const Core::AssetUriParser parser(assetRef.Uri());
-        Common::BinaryFileSerializeStream stream(parser.Parse().Absolute().String());
+        Common::BufferedFileSerializeStream fileStream(parser.Parse().Absolute().String());
 
         const Mirror::Any ref = assetRef->GetClass().Cast(Mirror::ForwardAsArg(*assetRef.Get()));
-        ref.Serialize(stream);
+        if (compress) {
+            Common::CompressedSerializeStream stream(fileStream);
+            ref.Serialize(stream);
+        } else {
+            ref.Serialize(fileStream);
+        }
     }
 
     template <Common::DerivedFrom<Asset> A>
@@ -625,14 +648,33 @@ namespace Runtime {
     AssetPtr<A> AssetManager::LoadInternal(const Core::Uri& uri, const Mirror::Class& clazz)
     {
         const Core::AssetUriParser parser(uri);
-        Common::BinaryFileDeserializeStream stream(parser.Parse().Absolute().String());
+        Common::MappedFileDeserializeStream fileStream(parser.Parse().Absolute().String());
+        AssertWithReason(fileStream.IsValid(), "failed to open the asset file");
 
+        // the compressed files are recognized by their magic, the others are loaded as is
         Mirror::Any ptr = clazz.New(uri);
-        ptr.Deref().Deserialize(stream);
-
         AssetPtr<A> result = Common::SharedPtr<A>(ptr.As<A*>());
+        if (Common::CompressedDeserializeStream::IsCompressed(fileStream)) {
+            Common::CompressedDeserializeStream stream(fileStream, &threadPool);
+            if (stream.Corrupted()) {
+                return nullptr;
+            }
+            ptr.Deref().Deserialize(stream);
+            if (stream.Corrupted()) {
+                return nullptr;
+            }
+        } else {
+            ptr.Deref().Deserialize(fileStream);
+        }
+
         result->SetUri(uri);
         result->PostLoad();
         return result;
     }
+
+    template <Common::DerivedFrom<Asset> A>
+    Common::CoTask<void> AssetManager::AsyncLoadInternal(Core::Uri uri, const Mirror::Class& clazz, OnAssetLoaded<A> onAssetLoaded)
+    {
+        onAssetLoaded(co_await CoLoad<A>(std::move(uri), clazz));
+    }
 }
@@ -17,6 +17,9 @@ namespace Runtime {
         explicit WorldTransform(Common::FTransform inLocalToWorld);
 
         EProperty() Common::FTransform localToWorld;
+        // localToWorld.GetTransformMatrix(), not serialized, TransformSystem keeps it in sync for the world transforms it
+        // writes and for the ones added or changed since its last tick
+        Common::FMat4x4 localToWorldMatrix;
     };
 
     // must be used with Hierarchy and WorldTransform
@@ -4,25 +4,56 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
 #include <set>
+#include <span>
+#include <thread>
 #include <unordered_set>
 #include <unordered_map>
 
+#include <Common/Concurrent.h>
 #include <Common/Delegate.h>
 #include <Common/Utility.h>
 #include <Common/Memory.h>
+#include <Core/Thread.h>
 #include <Mirror/Mirror.h>
 #include <Runtime/Meta.h>
 #include <Runtime/Api.h>
 
 namespace Runtime {
+    // low bits are the slot index in the entity pool, high bits are a generation bumped every time the slot is recycled,
+    // so a stale handle to a destroyed entity never aliases the entity that reuses its slot
     using Entity = uint32_t;
     static constexpr Entity entityNull = 0;
+    static constexpr uint32_t entityIndexBits = 24;
+    static constexpr uint32_t entityIndexMask = (1u << entityIndexBits) - 1;
+    static constexpr uint32_t entityGenerationMask = ~entityIndexMask;
+
+    constexpr uint32_t EntityIndex(Entity inEntity) { return inEntity & entityIndexMask; }
+    constexpr uint32_t EntityGeneration(Entity inEntity) { return inEntity >> entityIndexBits; }
+    constexpr Entity MakeEntity(uint32_t inIndex, uint32_t inGeneration) { return (inGeneration << entityIndexBits) | (inIndex & entityIndexMask); }
 
     using CompClass = const Mirror::Class*;
     using GCompClass = const Mirror::Class*;
     using SystemClass = const Mirror::Class*;
 
+    // monotonic counter of the registry, every component row remembers the tick it was added at and the tick it was last
+    // updated at (Update()/NotifyUpdated()), see ECRegistry::IncChangeTick()
+    using ChangeTick = uint32_t;
+
+    enum class ChangeKind : uint8_t {
+        added,
+        changed,
+        max
+    };
+
     class ECRegistry;
     class Client;
     struct SystemSetupContext;
@@ -30,6 +61,35 @@ namespace Runtime {
     template <typename T>
     concept ECRegistryOrConst = std::is_same_v<std::remove_const_t<T>, ECRegistry>;
 
+    // components (and global components) a system touches while ticking, declared in the system constructor. Inside a
+    // system group, SystemPipeline only orders two systems when their accesses conflict, so independent systems run in
+    // parallel even in a sequential group. A system declaring nothing keeps the meaning of its group strategy: it
+    // conflicts with every system of a sequential group and with none of a concurrent group
+    class RUNTIME_API SystemAccess {
+    public:
+        SystemAccess();
+
+        template <typename C> SystemAccess& Read();
+        template <typename C> SystemAccess& Write();
+        SystemAccess& ReadDyn(CompClass inClass);
+        SystemAccess& WriteDyn(CompClass inClass);
+        // structural changes (creating/destroying entities, emplacing/removing components) need exclusive access, prefer
+        // recording them into ECRegistry::Commands() instead
+        SystemAccess& Exclusive();
+
+        bool Declared() const;
+        bool IsExclusive() const;
+        bool CanRead(CompClass inClass) const;
+        bool CanWrite(CompClass inClass) const;
+        bool ConflictsWith(const SystemAccess& inOther) const;
+
+    private:
+        bool declared;
+        bool exclusive;
+        std::unordered_set<CompClass> reads;
+        std::unordered_set<CompClass> writes;
+    };
+
     class RUNTIME_API EClass() System {
     public:
         EPolyClassBody(System)
@@ -37,90 +97,285 @@ namespace Runtime {
         explicit System(ECRegistry& inRegistry, const SystemSetupContext&);
         virtual ~System();
         virtual void Tick(float inDeltaTimeSeconds);
+        const SystemAccess& GetAccess() const;
 
     protected:
         ECRegistry& registry;
+        SystemAccess access;
     };
 }
 
 namespace Runtime::Internal {
     using ArchetypeId = Mirror::TypeId;
-    using ElemPtr = void*;
+    using CompPtr = void*;
 
     template <typename T> const Mirror::Class* GetClass();
     template <typename T> struct MemberFuncPtrTraits;
 
+    static constexpr size_t defaultParallelGrainSize = 1024;
+
+    // runs inTask(0) ... inTask(inTaskNum - 1) on the game worker threads with ThreadTag::gameWorker set and waits for all of
+    // them, the calling thread takes part, runs inline if the workers are not started
+    RUNTIME_API void ParallelFor(size_t inTaskNum, const std::function<void(size_t)>& inTask);
+
+    // debug access checker, while a system ticks with SystemSetupContext::checkAccess, every registry access made from
+    // the ticking thread is asserted against the access the system declared (systems declaring nothing are not checked)
+    class RUNTIME_API ScopedAccessCheck {
+    public:
+        explicit ScopedAccessCheck(const SystemAccess* inAccess);
+        ~ScopedAccessCheck();
+
+        NonCopyable(ScopedAccessCheck)
+        NonMovable(ScopedAccessCheck)
+
+    private:
+        const SystemAccess* lastAccess;
+    };
+
+    RUNTIME_API void CheckCompAccess(CompClass inClass, bool inWrite);
+    RUNTIME_API void CheckStructuralAccess();
+
     class CompRtti {
     public:
         explicit CompRtti(CompClass inClass);
         void Bind(size_t inOffset);
-        Mirror::Any MoveConstruct(ElemPtr inElem, const Mirror::Any& inOther) const;
-        Mirror::Any MoveAssign(ElemPtr inElem, const Mirror::Any& inOther) const;
-        void Destruct(ElemPtr inElem) const;
-        Mirror::Any Get(ElemPtr inElem) const;
+        Mirror::Any MoveConstruct(CompPtr inComp, const Mirror::Any& inOther) const;
+        Mirror::Any CopyConstruct(CompPtr inComp, const Mirror::Any& inOther) const;
+        Mirror::Any MoveAssign(CompPtr inComp, const Mirror::Any& inOther) const;
+        // move-constructs inSrc into inDst and ends the lifetime of inSrc, a plain memcpy for trivially copyable components
+        void Relocate(CompPtr inDst, CompPtr inSrc) const;
+        // copy-constructs / destructs inNum consecutive components, a single memcpy / nothing for trivially copyable ones
+        void CopyConstructRange(CompPtr inDst, CompPtr inSrc, size_t inNum) const;
+        void DestructRange(CompPtr inComps, size_t inNum) const;
+        void Destruct(CompPtr inComp) const;
+        Mirror::Any Get(CompPtr inComp) const;
         CompClass Class() const;
         size_t Offset() const;
         size_t MemorySize() const;
+        size_t MaskBit() const;
 
     private:
-        using MoveConstructFunc = Mirror::Any(ElemPtr, size_t, const Mirror::Any&);
-        using MoveAssignFunc = Mirror::Any(ElemPtr, size_t, const Mirror::Any&);
-        using DestructorFunc = void(ElemPtr, size_t);
-        using GetFunc = Mirror::Any(ElemPtr, size_t);
-
         CompClass clazz;
-        // runtime, need Bind()
+        bool triviallyCopyable;
+        // the CompMask bit of the class, looked up once so building archetype masks never takes the bit table lock
+        size_t maskBit;
+        // runtime, need Bind(), offset of the component column inside a chunk
         bool bound;
         size_t offset;
     };
 
+    // Entities of an archetype are stored in fixed-size chunks, each chunk holds an entity array followed by one
+    // contiguous column per component (SoA), so iterating one component only touches that component's memory. Rows are
+    // kept dense, row N lives in chunk N / ChunkCapacity() at slot N % ChunkCapacity(), growth allocates a new chunk and
+    // never relocates the existing ones. Copying an archetype shares its chunks (copy-on-write), the first write to a
+    // shared chunk clones that chunk only.
+    class Archetype;
+
+    // cached add/remove transition between two archetypes, columnRemap[i] is the destination column of source column i, or
+    // invalidCompIndex when the destination does not have it
+    struct ArchetypeEdge {
+        static constexpr size_t invalidCompIndex = std::numeric_limits<size_t>::max();
+
+        CompClass clazz;
+        Archetype* target;
+        std::vector<size_t> columnRemap;
+    };
+
+    using ElemIndex = size_t;
+
+    // one bit per component class, bits are assigned process-wide the first time a class is put into a mask, so membership
+    // tests of a whole include/exclude set are a few word operations instead of a lookup per class
+    class RUNTIME_API CompMask {
+    public:
+        CompMask();
+
+        void Set(CompClass inClass);
+        void Set(const CompRtti& inRtti);
+        bool ContainsAll(const CompMask& inOther) const;
+        bool Intersects(const CompMask& inOther) const;
+
+    private:
+        void SetBit(size_t inBit);
+
+        std::vector<uint64_t> words;
+    };
+
     class RUNTIME_API Archetype {
     public:
+        static constexpr size_t chunkSize = 16 * 1024;
+        static constexpr size_t columnAlignment = alignof(std::max_align_t);
+
         explicit Archetype(const std::vector<CompRtti>& inRttiVec);
+        Archetype(const Archetype& inOther);
+        Archetype(Archetype&& inOther) noexcept;
+        ~Archetype();
+        Archetype& operator=(const Archetype& inOther);
+        Archetype& operator=(Archetype&& inOther) noexcept;
 
         bool Contains(CompClass inClazz) const;
-        bool ContainsAll(const std::vector<CompClass>& inClasses) const;
-        bool NotContainsAny(const std::vector<CompClass>& inClasses) const;
-        ElemPtr EmplaceElem(Entity inEntity);
-        ElemPtr EmplaceElem(Entity inEntity, ElemPtr inSrcElem, const std::vector<CompRtti>& inSrcRttiVec);
-        Mirror::Any EmplaceComp(Entity inEntity, CompClass inCompClass, const Mirror::Any& inCompRef);
-        void EraseElem(Entity inEntity);
-        ElemPtr GetElem(Entity inEntity) const;
-        Mirror::Any GetComp(Entity inEntity, CompClass inCompClass);
-        Mirror::Any GetComp(Entity inEntity, CompClass inCompClass) const;
+        bool ContainsAll(const CompMask& inMask) const;
+        bool NotContainsAny(const CompMask& inMask) const;
+        // rows are kept dense, so removing a row moves the last row into the hole, the functions removing rows return the
+        // entity that was moved (entityNull if none) for the caller to update its record
+        ElemIndex EmplaceElem(Entity inEntity);
+        // appends inNum rows at once and returns the first of them, their components are left unconstructed for the caller
+        ElemIndex EmplaceElems(const Entity* inEntities, size_t inNum);
+        // moves row inIndex to inEdge.target and returns its new row there, the shared components are relocated column by
+        // column and the ones the target does not have are destructed
+        ElemIndex MoveElem(ElemIndex inIndex, const ArchetypeEdge& inEdge, Entity& outMovedEntity);
+        Mirror::Any EmplaceComp(ElemIndex inIndex, CompClass inCompClass, const Mirror::ArgumentList& inArgs);
+        void MarkChange(ElemIndex inIndex, CompClass inCompClass, ChangeKind inKind, ChangeTick inTick);
+        void MarkChanges(ElemIndex inBegin, size_t inNum, CompClass inCompClass, ChangeKind inKind, ChangeTick inTick);
+        Entity EraseElem(ElemIndex inIndex);
+        Mirror::Any GetComp(ElemIndex inIndex, CompClass inCompClass);
+        Mirror::Any GetComp(ElemIndex inIndex, CompClass inCompClass) const;
+        Entity GetEntity(ElemIndex inIndex) const;
         size_t Count() const;
-        auto All() const;
         const std::vector<CompRtti>& GetRttiVec() const;
         ArchetypeId Id() const;
         std::vector<CompRtti> NewRttiVecByAdd(const CompRtti& inRtti) const;
         std::vector<CompRtti> NewRttiVecByRemove(const CompRtti& inRtti) const;
 
+        // transition edges, they point into the owning registry and are never copied along with the archetype
+        const ArchetypeEdge* FindAddEdge(CompClass inClazz) const;
+        const ArchetypeEdge* FindRemoveEdge(CompClass inClazz) const;
+        const ArchetypeEdge& EmplaceAddEdge(CompClass inClazz, Archetype& inTarget);
+        const ArchetypeEdge& EmplaceRemoveEdge(CompClass inClazz, Archetype& inTarget);
+        // a bundle edge adds several components at once, it is keyed by the target archetype id, its clazz is nullptr
+        const ArchetypeEdge* FindBundleEdge(ArchetypeId inTargetId) const;
+        const ArchetypeEdge& EmplaceBundleEdge(Archetype& inTarget);
+        ArchetypeEdge MakeEdge(CompClass inClazz, Archetype& inTarget) const;
+
+        // chunk access
+        size_t CompIndex(CompClass inClazz) const;
+        size_t ChunkCapacity() const;
+        size_t ChunkNum() const;
+        size_t ChunkElemNum(size_t inChunkIndex) const;
+        const Entity* ChunkEntities(size_t inChunkIndex) const;
+        // the non-const column access is a write, it detaches the chunk first
+        void* ChunkColumn(size_t inChunkIndex, size_t inCompIndex);
+        const void* ChunkColumn(size_t inChunkIndex, size_t inCompIndex) const;
+        // clones the chunk if it is shared with a copy of this archetype, so writes to it no longer show in the copy, writers
+        // running in parallel may detach the same chunk, one of them clones and the others get the clone
+        void DetachChunk(size_t inChunkIndex);
+        // per row change ticks of a column, and the latest of them which lets a filter skip the whole chunk
+        const ChangeTick* ChunkTicks(size_t inChunkIndex, size_t inCompIndex, ChangeKind inKind) const;
+        ChangeTick ChunkLatestTick(size_t inChunkIndex, size_t inCompIndex, ChangeKind inKind) const;
+
     private:
         using CompRttiIndex = size_t;
-        using ElemIndex = size_t;
+
+        // whoever releases a shared chunk last destructs its components, so the chunk knows its layout and row count
+        struct Chunk {
+            Chunk(std::shared_ptr<const std::vector<CompRtti>> inLayout, size_t inMemorySize, size_t inCapacity);
+            ~Chunk();
+            NonCopyable(Chunk)
+
+            std::shared_ptr<const std::vector<CompRtti>> layout;
+            size_t elemNum;
+            std::vector<uint8_t> memory;
+            // [compIndex][kind][row]
+            std::vector<ChangeTick> ticks;
+            // [compIndex][kind]
+            std::vector<ChangeTick> latestTicks;
+            // set once a copy of the archetype shares the chunk, so an unshared chunk is written without taking the lock
+            std::atomic<bool> shared;
+            // serializes the writers cloning the chunk
+            std::mutex cloneMutex;
+        };
+
+        // owner is only replaced under the cloneMutex of the chunk it holds, the readers load the published pointer
+        struct ChunkSlot {
+            explicit ChunkSlot(std::shared_ptr<Chunk> inOwner);
+            ChunkSlot(const ChunkSlot& inOther);
+            ChunkSlot(ChunkSlot&& inOther) noexcept;
+            ChunkSlot& operator=(const ChunkSlot& inOther);
+            ChunkSlot& operator=(ChunkSlot&& inOther) noexcept;
+
+            Chunk* Get() const;
+            void Reset(std::shared_ptr<Chunk> inOwner);
+
+            std::shared_ptr<Chunk> owner;
+            std::atomic<Chunk*> pointer;
+        };
 
         const CompRtti* FindCompRtti(CompClass clazz) const;
         const CompRtti& GetCompRtti(CompClass clazz) const;
+        void BuildChunkLayout();
         size_t Capacity() const;
-        void Reserve(float inRatio = 1.5f);
-        ElemPtr AllocateNewElemBack();
-        ElemPtr ElemAt(std::vector<uint8_t>& inMemory, size_t inIndex) const;
-        ElemPtr ElemAt(size_t inIndex) const;
+        ElemIndex AllocateNewElemBack();
+        Chunk& WritableChunk(size_t inChunkIndex);
+        void ReleaseChunks();
+        Entity EraseRow(ElemIndex inIndex);
+        // the non-const row accessors are writes, they detach the chunk of the row first
+        Entity& EntityAt(ElemIndex inIndex);
+        const Entity& EntityAt(ElemIndex inIndex) const;
+        CompPtr CompAt(ElemIndex inIndex, const CompRtti& inRtti);
+        CompPtr CompAt(ElemIndex inIndex, const CompRtti& inRtti) const;
+        ChangeTick TickAt(ElemIndex inIndex, size_t inCompIndex, ChangeKind inKind) const;
+        void SetTick(ElemIndex inIndex, size_t inCompIndex, ChangeKind inKind, ChangeTick inTick);
+        void CopyTicks(ElemIndex inIndex, size_t inCompIndex, const Archetype& inSrc, ElemIndex inSrcIndex, size_t inSrcCompIndex);
 
         ArchetypeId id;
         size_t count;
-        size_t elemSize;
+        size_t chunkCapacity;
+        size_t chunkMemorySize;
         std::vector<CompRtti> rttiVec;
         std::unordered_map<CompClass, CompRttiIndex> rttiMap;
-        std::unordered_map<Entity, ElemIndex> entityMap;
-        std::unordered_map<ElemIndex, Entity> elemMap;
-        std::vector<uint8_t> memory;
+        CompMask compMask;
+        // rttiVec with bound offsets, shared with the chunks
+        std::shared_ptr<const std::vector<CompRtti>> chunkLayout;
+        std::vector<ChunkSlot> chunks;
+        std::vector<ArchetypeEdge> addEdges;
+        std::vector<ArchetypeEdge> removeEdges;
+        std::vector<ArchetypeEdge> bundleEdges;
+    };
+
+    // where the components of an entity live
+    struct EntityRecord {
+        Archetype* archetype;
+        ElemIndex elemIndex;
+    };
+
+    struct QueryKey {
+        std::vector<CompClass> includes;
+        std::vector<CompClass> excludes;
+
+        bool operator==(const QueryKey& inRhs) const;
+    };
+
+    struct QueryKeyHash {
+        size_t operator()(const QueryKey& inKey) const;
+    };
+
+    // cached result of an include/exclude set, archetypes are never destroyed while the registry lives, so a query only
+    // needs to test the archetypes created since its last update, the column of every include is resolved once per match
+    class RUNTIME_API Query {
+    public:
+        explicit Query(const QueryKey& inKey);
+
+        void Update(const std::vector<Archetype*>& inArchetypes);
+        size_t MatchNum() const;
+        Archetype* GetMatch(size_t inMatchIndex) const;
+        // columns of the includes (in key order) inside match inMatchIndex
+        const size_t* GetColumns(size_t inMatchIndex) const;
+
+    private:
+        std::vector<CompClass> includes;
+        CompMask includeMask;
+        CompMask excludeMask;
+        size_t evaluatedNum;
+        std::vector<Archetype*> matches;
+        std::vector<size_t> columns;
     };
 
+    // slot array indexed by EntityIndex(), free slots form a doubly linked list threaded through the slot array so both
+    // popping any free slot and claiming a specific one are O(1), alive entities are also kept in a dense array for
+    // linear traversal. Slot 0 is never used so entityNull is never valid
     class EntityPool {
     public:
         using EntityTraverseFunc = std::function<void(Entity)>;
-        using ConstIter = std::set<Entity>::const_iterator;
+        using ConstIter = std::vector<Entity>::const_iterator;
 
         EntityPool();
 
@@ -131,16 +386,32 @@ namespace Runtime::Internal {
         void Free(Entity inEntity);
         void Clear();
         void Each(const EntityTraverseFunc& inFunc) const;
-        void SetArchetype(Entity inEntity, ArchetypeId inArchetypeId);
-        ArchetypeId GetArchetype(Entity inEntity) const;
+        EntityRecord& GetRecord(Entity inEntity);
+        const EntityRecord& GetRecord(Entity inEntity) const;
+        // records point into the archetypes of the owning registry, a copied pool must be rebound to the copied archetypes
+        void RebindArchetypes(std::unordered_map<ArchetypeId, Archetype>& inArchetypes);
         ConstIter Begin() const;
         ConstIter End() const;
 
     private:
-        uint32_t counter;
-        std::set<Entity> free;
-        std::set<Entity> allocated;
-        std::unordered_map<Entity, ArchetypeId> archetypeMap;
+        static constexpr uint32_t invalidIndex = std::numeric_limits<uint32_t>::max();
+
+        struct Slot {
+            Entity entity;
+            uint32_t denseIndex;
+            uint32_t prevFree;
+            uint32_t nextFree;
+            EntityRecord record;
+        };
+
+        void GrowSlots(uint32_t inSlotNum);
+        void LinkFree(uint32_t inIndex);
+        void UnlinkFree(uint32_t inIndex);
+        uint32_t Claim(uint32_t inIndex, Entity inEntity);
+
+        std::vector<Slot> slots;
+        std::vector<Entity> dense;
+        uint32_t freeHead;
     };
 
     class SystemFactory {
@@ -232,21 +503,76 @@ namespace Runtime {
     template <typename... T>
     struct Exclude {};
 
+    // view filters, C must be one of the view components, a row passes when its C was added / updated at or after sinceTick
+    template <typename C>
+    struct Added {
+        static constexpr ChangeKind kind = ChangeKind::added;
+        using CompType = C;
+        ChangeTick sinceTick;
+    };
+
+    template <typename C>
+    struct Changed {
+        static constexpr ChangeKind kind = ChangeKind::changed;
+        using CompType = C;
+        ChangeTick sinceTick;
+    };
+
     template <typename... T>
     class BasicView;
 
     template <ECRegistryOrConst R, typename... C, typename... E>
     class BasicView<R, Exclude<E...>, C...> {
+    private:
+        // a view with a non-const component writes to the chunks it visits, which detaches them from the snapshots
+        static constexpr bool writable = !std::is_const_v<R> && (!std::is_const_v<C> || ...);
+
+        struct ArchetypeSlot {
+            std::conditional_t<writable, Internal::Archetype*, const Internal::Archetype*> archetype;
+            std::array<size_t, sizeof...(C)> compIndices;
+        };
+
     public:
-        using ResultVector = std::vector<std::tuple<Entity, C&...>>;
-        using ConstIter = typename ResultVector::const_iterator;
+        // a view is a lazy range over the matched archetypes, column offsets are resolved once per archetype when the view
+        // is built, so iterating never materializes the result and never does a per-entity lookup
+        class ConstIter {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::tuple<Entity, C&...>;
+            using difference_type = std::ptrdiff_t;
+            using reference = value_type;
+
+            ConstIter();
+            ConstIter(const BasicView& inView, size_t inSlotIndex);
+
+            value_type operator*() const;
+            ConstIter& operator++();
+            ConstIter operator++(int);
+            bool operator==(const ConstIter& inRhs) const;
+
+        private:
+            template <size_t... I> value_type Deref(std::index_sequence<I...>) const;
+            void SkipEmpty();
+
+            const BasicView* view;
+            size_t slotIndex;
+            size_t chunkIndex;
+            size_t elemIndex;
+        };
 
-        explicit BasicView(R& inRegistry);
+        // inFilters are Added<> / Changed<> of the view components, with filters a chunk is skipped when none of its rows
+        // can pass and the rows passing inside a chunk are visited as runs of consecutive rows
+        template <typename... F> explicit BasicView(R& inRegistry, const F&... inFilters);
         NonCopyable(BasicView)
         NonMovable(BasicView)
 
         template <typename F> void Each(F&& inFunc) const;
-        const ResultVector& All() const;
+        // same signature as Each(), rows are split into batches of at most inGrainSize rows (never crossing a chunk) and
+        // the batches run on the game workers, so inFunc must be safe to invoke concurrently
+        template <typename F> void ParallelEach(F&& inFunc, size_t inGrainSize = Internal::defaultParallelGrainSize) const;
+        // F: void(std::span<const Entity>, std::span<C>...), invoked once per chunk (once per run of passing rows with change
+        // filters), all spans have the same size
+        template <typename F> void ForEachChunk(F&& inFunc) const;
         size_t Count() const;
         ConstIter Begin() const;
         ConstIter End() const;
@@ -254,9 +580,32 @@ namespace Runtime {
         ConstIter end() const;
 
     private:
+        struct ParallelBatch {
+            const ArchetypeSlot* slot;
+            size_t chunkIndex;
+            size_t begin;
+            size_t end;
+        };
+        // batches held on the stack by ParallelEach(), more of them spill to the heap
+        static constexpr size_t inlineBatchNum = 64;
+
+        struct ChangeFilter {
+            size_t includeIndex;
+            ChangeKind kind;
+            ChangeTick sinceTick;
+        };
+
+        template <typename T> static constexpr size_t IncludeIndex();
+        template <typename F> static auto MakeRowFunc(F& inFunc);
+        template <size_t... I> static void InvokeChunkFunc(const ArchetypeSlot& inSlot, size_t inChunkIndex, size_t inBegin, size_t inEnd, auto& inFunc, std::index_sequence<I...>);
+        bool ChunkMayPass(const ArchetypeSlot& inSlot, size_t inChunkIndex) const;
+        bool RowPasses(const ArchetypeSlot& inSlot, size_t inChunkIndex, size_t inElemIndex) const;
+        // invokes inFunc with the passing rows of [inBegin, inEnd) split into runs of consecutive rows
+        void InvokeChunkFuncFiltered(const ArchetypeSlot& inSlot, size_t inChunkIndex, size_t inBegin, size_t inEnd, auto& inFunc) const;
         void Evaluate(R& inRegistry);
 
-        ResultVector result;
+        std::vector<ArchetypeSlot> slots;
+        std::vector<ChangeFilter> changeFilters;
     };
 
     template <typename R, typename E, typename... C> using View = BasicView<R, E, C...>;
@@ -288,6 +637,8 @@ namespace Runtime {
         NonMovable(BasicRuntimeView)
 
         template <typename F> void Each(F&& inFunc) const;
+        // rows are split into batches of at most inGrainSize rows (never crossing a chunk) like BasicView::ParallelEach()
+        template <typename F> void ParallelEach(F&& inFunc, size_t inGrainSize = Internal::defaultParallelGrainSize) const;
         size_t Count() const;
         ConstIter Begin() const;
         ConstIter End() const;
@@ -295,15 +646,33 @@ namespace Runtime {
         ConstIter end() const;
 
     private:
-        using ResultVector = std::vector<std::pair<Entity, std::vector<Mirror::Any>>>;
+        using ArchetypePtr = std::conditional_t<std::is_const_v<R>, const Internal::Archetype*, Internal::Archetype*>;
 
-        template <typename F, typename ArgTuple, size_t... I> void InvokeTraverseFuncInternal(F&& inFunc, const std::pair<Entity, std::vector<Mirror::Any>>& inEntityAndComps, std::index_sequence<I...>) const;
-        template <typename C> decltype(auto) GetCompRef(const std::vector<Mirror::Any>& inComps) const;
+        struct ArchetypeSlot {
+            ArchetypePtr archetype;
+            // the column of include i in the archetype is compIndices[firstCompIndex + i]
+            size_t firstCompIndex;
+        };
+
+        struct ParallelBatch {
+            const ArchetypeSlot* slot;
+            size_t chunkIndex;
+            size_t begin;
+            size_t end;
+        };
+        // batches held on the stack by ParallelEach(), more of them spill to the heap
+        static constexpr size_t inlineBatchNum = 64;
+
+        template <typename ArgTuple, size_t... I> std::array<size_t, sizeof...(I)> IncludeIndices(std::index_sequence<I...>) const;
+        template <typename C> auto* ChunkColumn(const ArchetypeSlot& inSlot, size_t inChunkIndex, size_t inIncludeIndex) const;
+        // the column of every argument is resolved once per chunk, then inFunc is invoked for the rows [inBegin, inEnd)
+        template <typename ArgTuple, size_t... I> void InvokeChunkFunc(auto& inFunc, const ArchetypeSlot& inSlot, size_t inChunkIndex, size_t inBegin, size_t inEnd, const std::array<size_t, sizeof...(I)>& inIncludeIndices, std::index_sequence<I...>) const;
         void Evaluate(R& inRegistry, const RuntimeFilter& inFilter);
 
-        std::unordered_map<CompClass, size_t> slotMap;
+        std::unordered_map<CompClass, size_t> includeIndexMap;
+        std::vector<ArchetypeSlot> slots;
+        std::vector<size_t> compIndices;
         ResultEntitiesVector resultEntities;
-        ResultVector result;
     };
 
     using RuntimeView = BasicRuntimeView<ECRegistry>;
@@ -422,6 +791,64 @@ namespace Runtime {
         EProperty() std::unordered_map<GCompClass, std::vector<uint8_t>> globalComps;
     };
 
+    struct DeferredEntity {
+        uint32_t index;
+    };
+
+    // records structural changes to be applied later, safe to record into from concurrently running systems, each thread
+    // appends to its own stream. Playback() sorts the commands by target entity and applies each entity's emplaces as one
+    // bundle, so an entity only migrates archetypes once per batch
+    class RUNTIME_API EntityCommandBuffer {
+    public:
+        EntityCommandBuffer();
+        ~EntityCommandBuffer();
+
+        NonCopyable(EntityCommandBuffer)
+        NonMovable(EntityCommandBuffer)
+
+        DeferredEntity Create();
+        void Destroy(Entity inEntity);
+        template <typename C, typename... Args> void Emplace(Entity inEntity, Args&&... inArgs);
+        template <typename C, typename... Args> void Emplace(DeferredEntity inEntity, Args&&... inArgs);
+        template <typename C> void Remove(Entity inEntity);
+        void EmplaceDyn(CompClass inClass, Entity inEntity, const Mirror::ArgumentList& inArgs);
+        void EmplaceDyn(CompClass inClass, DeferredEntity inEntity, const Mirror::ArgumentList& inArgs);
+        void RemoveDyn(CompClass inClass, Entity inEntity);
+        bool Empty() const;
+        void Clear();
+        void Playback(ECRegistry& inRegistry);
+
+    private:
+        enum class CommandType : uint8_t {
+            create,
+            destroy,
+            emplace,
+            remove,
+            max
+        };
+
+        struct Command {
+            CommandType type;
+            bool deferred;
+            uint32_t target;
+            uint64_t sequence;
+            CompClass clazz;
+            Mirror::Any comp;
+        };
+
+        using Stream = std::vector<Command>;
+
+        void Record(CommandType inType, bool inDeferred, uint32_t inTarget, CompClass inClass, Mirror::Any&& inComp);
+        Stream& GetThreadStream();
+        void ResetStreams();
+
+        uint64_t id;
+        std::atomic<uint32_t> deferredEntityCounter;
+        std::atomic<uint64_t> sequenceCounter;
+        mutable std::mutex mutex;
+        std::unordered_map<std::thread::id, Stream> streams;
+    };
+
     class RUNTIME_API ECRegistry {
     public:
         using EntityTraverseFunc = Internal::EntityPool::EntityTraverseFunc;
@@ -447,6 +874,9 @@ namespace Runtime {
         ECRegistry();
         ~ECRegistry();
 
+        // a copy shares the component chunks copy-on-write and only duplicates the entity table, so copying a registry is a
+        // cheap snapshot (e.g. play in editor, rollback of the last frames), assigning the snapshot back restores it. The
+        // chunk is detached when a write is requested, so component references taken before the copy must not be written
         ECRegistry(const ECRegistry& inOther);
         ECRegistry(ECRegistry&& inOther) noexcept;
         ECRegistry& operator=(const ECRegistry& inOther);
@@ -469,6 +899,8 @@ namespace Runtime {
 
         // component static
         template <typename C, typename... Args> C& Emplace(Entity inEntity, Args&&... inArgs);
+        // constructs all components in the final archetype at once, each component is move constructed from inComps
+        template <typename... C> std::tuple<std::decay_t<C>&...> EmplaceBundle(Entity inEntity, C&&... inComps);
         template <typename C> void Remove(Entity inEntity);
         template <typename C> void NotifyUpdated(Entity inEntity);
         template <typename C, typename F> void Update(Entity inEntity, F&& inFunc);
@@ -478,14 +910,16 @@ namespace Runtime {
         template <typename C> const C* Find(Entity inEntity) const;
         template <typename C> C& Get(Entity inEntity);
         template <typename C> const C& Get(Entity inEntity) const;
-        template <typename... C, typename... E> Runtime::View<ECRegistry, Exclude<E...>, C...> View(Exclude<E...> = {});
-        template <typename... C, typename... E> Runtime::ConstView<ECRegistry, Exclude<E...>, C...> View(Exclude<E...> = {}) const;
-        template <typename... C, typename... E> Runtime::ConstView<ECRegistry, Exclude<E...>, C...> ConstView(Exclude<E...> = {}) const;
+        // inFilters: Added<> / Changed<> of the view components, e.g. View<A, B>(Exclude<> {}, Changed<A> { sinceTick })
+        template <typename... C, typename... E, typename... F> Runtime::View<ECRegistry, Exclude<E...>, C...> View(Exclude<E...> = {}, const F&... inFilters);
+        template <typename... C, typename... E, typename... F> Runtime::ConstView<ECRegistry, Exclude<E...>, C...> View(Exclude<E...> = {}, const F&... inFilters) const;
+        template <typename... C, typename... E, typename... F> Runtime::ConstView<ECRegistry, Exclude<E...>, C...> ConstView(Exclude<E...> = {}, const F&... inFilters) const;
         template <typename C> CompEvents& Events();
         template <typename C> EventsObserver<C> EventsObserver();
 
         // component dynamic
         Mirror::Any EmplaceDyn(CompClass inClass, Entity inEntity, const Mirror::ArgumentList& inArgs);
+        std::vector<Mirror::Any> EmplaceDynBundle(const std::vector<CompClass>& inClasses, Entity inEntity, const std::vector<Mirror::ArgumentList>& inArgs);
         void RemoveDyn(CompClass inClass, Entity inEntity);
         void NotifyUpdatedDyn(CompClass inClass, Entity inEntity);
         void UpdateDyn(CompClass inClass, Entity inEntity, const DynUpdateFunc& inFunc);
@@ -529,12 +963,30 @@ namespace Runtime {
         void GCompEach(const GCompTraverseFunc& inFunc) const;
         size_t GCompCount() const;
 
+        // change tracking, adding a component stamps its added tick and Update()/NotifyUpdated() stamp its changed tick with
+        // the current tick. A system querying "since my last run" keeps the tick returned by IncChangeTick(), called before
+        // building its filtered views, and passes it as sinceTick at its next run
+        ChangeTick GetChangeTick() const;
+        ChangeTick IncChangeTick();
+
         // comp observer
         Runtime::Observer Observer();
 
+        // deferred commands, played back at every system group sync point of a running system graph
+        EntityCommandBuffer& Commands();
+        void PlaybackCommands();
+
         // serialization
         void Save(ECArchive& outArchive) const;
         void Load(const ECArchive& inArchive);
+        // columnar snapshot grouped by archetype, a component schema table followed by contiguous per column blobs, the
+        // trivially copyable columns are stored raw and bulk copied on load, so a snapshot is only loadable by a build
+        // with the same component layouts and byte order, which the header and the schema table check. A load returns
+        // false on such a mismatch or a truncated snapshot. The loaded bytes can be a memory mapped file
+        void SaveColumnar(std::vector<uint8_t>& outBytes) const;
+        bool LoadColumnar(const uint8_t* inData, size_t inSize);
+        void SaveColumnarToFile(const std::string& inFileName) const;
+        bool LoadColumnarFromFile(const std::string& inFileName);
 
         // utils
         void CheckEventsUnbound() const;
@@ -543,6 +995,15 @@ namespace Runtime {
         template <typename... T> friend class BasicView;
         template <ECRegistryOrConst R> friend class BasicRuntimeView;
 
+        const Internal::ArchetypeEdge& GetAddEdge(Internal::Archetype& inArchetype, CompClass inClass);
+        const Internal::ArchetypeEdge& GetRemoveEdge(Internal::Archetype& inArchetype, CompClass inClass);
+        Internal::EntityRecord& MigrateEntity(Entity inEntity, const Internal::ArchetypeEdge& inEdge);
+        void FixMovedRecord(Entity inMovedEntity, Internal::ElemIndex inElemIndex);
+        Internal::Archetype& EmplaceArchetype(Internal::ArchetypeId inId, const std::vector<Internal::CompRtti>& inRttiVec);
+        void RebuildArchetypeList();
+        // inFunc is invoked with the up-to-date query while the query cache is locked
+        template <typename F> void VisitQuery(const Internal::QueryKey& inKey, F&& inFunc) const;
+        Internal::Query& FindOrAddQuery(const Internal::QueryKey& inKey) const;
         void NotifyConstructedDyn(CompClass inClass, Entity inEntity);
         void NotifyRemoveDyn(CompClass inClass, Entity inEntity);
         void GNotifyConstructedDyn(GCompClass inClass);
@@ -551,9 +1012,15 @@ namespace Runtime {
         Internal::EntityPool entities;
         std::unordered_map<GCompClass, Mirror::Any> globalComps;
         std::unordered_map<Internal::ArchetypeId, Internal::Archetype> archetypes;
+        // archetypes in creation order, queries remember how many of them they have tested
+        std::vector<Internal::Archetype*> archetypeList;
+        std::atomic<ChangeTick> changeTick;
         // transients, not copy or move
+        mutable std::mutex queryMutex;
+        mutable std::unordered_map<Internal::QueryKey, Internal::Query, Internal::QueryKeyHash> queries;
         std::unordered_map<CompClass, CompEvents> compEvents;
         std::unordered_map<GCompClass, GCompEvents> globalCompEvents;
+        EntityCommandBuffer commandBuffer;
     };
 
     enum class SystemExecuteStrategy : uint8_t {
@@ -613,9 +1080,13 @@ namespace Runtime {
         std::vector<SystemGroup> systemGroups;
     };
 
-    class SystemPipeline {
+    class RUNTIME_API SystemPipeline {
     public:
         explicit SystemPipeline(const SystemGraph& inGraph);
+        ~SystemPipeline();
+
+        NonCopyable(SystemPipeline)
+        NonMovable(SystemPipeline)
 
     private:
         struct SystemContext {
@@ -630,10 +1101,22 @@ namespace Runtime {
 
         friend class SystemGraphExecutor;
         using ActionFunc = std::function<void(SystemContext&)>;
-
-        void ParallelPerformAction(const ActionFunc& inActionFunc);
+        using SyncFunc = std::function<void()>;
+
+        // the task graph is compiled from the system graph and re-run on the game worker threads for every action,
+        // tasks only dispatch to the action that is currently performing. Groups are separated by a barrier and a sync
+        // task, inside a group a system depends on the earlier systems its access conflicts with, so Compile() runs again
+        // once the systems are built and have declared their access
+        void Compile();
+        void PerformAction(SystemContext& inSystemContext) const;
+        // inSyncFunc runs after each system group finished, before the next group starts
+        void ParallelPerformAction(const ActionFunc& inActionFunc, const SyncFunc& inSyncFunc = {});
+        void PerformSync() const;
 
         std::vector<SystemGroupContext> systemGraph;
+        const ActionFunc* currentAction;
+        const SyncFunc* currentSync;
+        Common::TaskGraph taskGraph;
     };
 
     enum class PlayType : uint8_t {
@@ -647,9 +1130,11 @@ namespace Runtime {
 
         PlayType playType;
         Client* client;
+        // debug builds only, assert when a ticking system touches components outside its declared access
+        bool checkAccess;
     };
 
-    class SystemGraphExecutor {
+    class RUNTIME_API SystemGraphExecutor {
     public:
         explicit SystemGraphExecutor(ECRegistry& inEcRegistry, const SystemGraph& inSystemGraph, const SystemSetupContext& inSetupContext);
         ~SystemGraphExecutor();
@@ -663,6 +1148,7 @@ namespace Runtime {
         ECRegistry& ecRegistry;
         SystemGraph systemGraph;
         SystemPipeline pipeline;
+        bool checkAccess;
     };
 }
 
@@ -686,14 +1172,21 @@ namespace Runtime::Internal {
         using ClassType = const Class;
         using ArgsTupleType = std::tuple<Args...>;
     };
+} // namespace Runtime::Internal
 
-    inline auto Archetype::All() const
+namespace Runtime {
+    template <typename C>
+    SystemAccess& SystemAccess::Read()
     {
-        return elemMap | std::ranges::views::values;
+        return ReadDyn(Internal::GetClass<C>());
+    }
+
+    template <typename C>
+    SystemAccess& SystemAccess::Write()
+    {
+        return WriteDyn(Internal::GetClass<C>());
     }
-} // namespace Runtime::Internal
 
-namespace Runtime {
     template <typename C>
     ScopedUpdater<C>::ScopedUpdater(ECRegistry& inRegistry, Entity inEntity, C& inCompRef)
         : registry(inRegistry)
@@ -745,9 +1238,104 @@ namespace Runtime {
         return globalCompRef.As<T>();
     }
 
+    template <ECRegistryOrConst R, typename... C, typename... E>
+    BasicView<R, Exclude<E...>, C...>::ConstIter::ConstIter()
+        : view(nullptr)
+        , slotIndex(0)
+        , chunkIndex(0)
+        , elemIndex(0)
+    {
+    }
+
+    template <ECRegistryOrConst R, typename... C, typename... E>
+    BasicView<R, Exclude<E...>, C...>::ConstIter::ConstIter(const BasicView& inView, size_t inSlotIndex)
+        : view(&inView)
+        , slotIndex(inSlotIndex)
+        , chunkIndex(0)
+        , elemIndex(0)
+    {
+        SkipEmpty();
+    }
+
+    template <ECRegistryOrConst R, typename... C, typename... E>
+    typename BasicView<R, Exclude<E...>, C...>::ConstIter::value_type BasicView<R, Exclude<E...>, C...>::ConstIter::operator*() const
+    {
+        return Deref(std::index_sequence_for<C...> {});
+    }
+
+    template <ECRegistryOrConst R, typename... C, typename... E>
+    typename BasicView<R, Exclude<E...>, C...>::ConstIter& BasicView<R, Exclude<E...>, C...>::ConstIter::operator++()
+    {
+        elemIndex++;
+        SkipEmpty();
+        return *this;
+    }
+
+    template <ECRegistryOrConst R, typename... C, typename... E>
+    typename BasicView<R, Exclude<E...>, C...>::ConstIter BasicView<R, Exclude<E...>, C...>::ConstIter::operator++(int)
+    {
+        const auto result = *this;
+        ++*this;
+        return result;
+    }
+
+    template <ECRegistryOrConst R, typename... C, typename... E>
+    bool BasicView<R, Exclude<E...>, C...>::ConstIter::operator==(const ConstIter& inRhs) const
+    {
+        return view == inRhs.view
+            && slotIndex == inRhs.slotIndex
+            && chunkIndex == inRhs.chunkIndex
+            && elemIndex == inRhs.elemIndex;
+    }
+
+    template <ECRegistryOrConst R, typename... C, typename... E>
+    template <size_t... I>
+    typename BasicView<R, Exclude<E...>, C...>::ConstIter::value_type BasicView<R, Exclude<E...>, C...>::ConstIter::Deref(std::index_sequence<I...>) const
+    {
+        const auto& [archetype, compIndices] = view->slots[slotIndex];
+        if constexpr (writable) {
+            archetype->DetachChunk(chunkIndex);
+        }
+        return value_type(
+            archetype->ChunkEntities(chunkIndex)[elemIndex],
+            static_cast<C*>(archetype->ChunkColumn(chunkIndex, compIndices[I]))[elemIndex]...);
+    }
+
+    template <ECRegistryOrConst R, typename... C, typename... E>
+    void BasicView<R, Exclude<E...>, C...>::ConstIter::SkipEmpty()
+    {
+        const auto& slots = view->slots;
+        while (slotIndex < slots.size()) {
+            const auto& slot = slots[slotIndex];
+            const auto* archetype = slot.archetype;
+            if (chunkIndex < archetype->ChunkNum()) {
+                if (elemIndex == 0 && !view->ChunkMayPass(slot, chunkIndex)) {
+                    chunkIndex++;
+                    continue;
+                }
+                for (; elemIndex < archetype->ChunkElemNum(chunkIndex); elemIndex++) {
+                    if (view->RowPasses(slot, chunkIndex, elemIndex)) {
+                        return;
+                    }
+                }
+                chunkIndex++;
+                elemIndex = 0;
+                continue;
+            }
+            slotIndex++;
+            chunkIndex = 0;
+            elemIndex = 0;
+        }
+    }
+
     template <ECRegistryOrConst R, typename ... C, typename ... E>
-    BasicView<R, Exclude<E...>, C...>::BasicView(R& inRegistry)
+    template <typename... F>
+    BasicView<R, Exclude<E...>, C...>::BasicView(R& inRegistry, const F&... inFilters)
     {
+        changeFilters.reserve(sizeof...(F));
+        (void) std::initializer_list<int> { ([&]() -> void {
+            changeFilters.emplace_back(ChangeFilter { IncludeIndex<typename F::CompType>(), F::kind, inFilters.sinceTick });
+        }(), 0)... };
         Evaluate(inRegistry);
     }
 
@@ -755,37 +1343,83 @@ namespace Runtime {
     template <typename F>
     void BasicView<R, Exclude<E...>, C...>::Each(F&& inFunc) const
     {
-        for (const auto& entityAndComps : result) {
-            if constexpr (Internal::MemberFuncPtrTraits<decltype(&F::operator())>::ArgSize == 1) {
-                inFunc(std::get<0>(entityAndComps));
-            } else {
-                std::apply(inFunc, entityAndComps);
+        ForEachChunk(MakeRowFunc(inFunc));
+    }
+
+    template <ECRegistryOrConst R, typename... C, typename... E>
+    template <typename F>
+    void BasicView<R, Exclude<E...>, C...>::ParallelEach(F&& inFunc, size_t inGrainSize) const
+    {
+        Assert(inGrainSize > 0);
+        // not taken from the frame arena, a view may be iterated on a thread or at a time without any frame running
+        std::array<std::byte, inlineBatchNum * sizeof(ParallelBatch)> batchMemory;
+        std::pmr::monotonic_buffer_resource batchResource(batchMemory.data(), batchMemory.size());
+        std::pmr::vector<ParallelBatch> batches(&batchResource);
+        for (const auto& slot : slots) {
+            for (size_t chunkIndex = 0; chunkIndex < slot.archetype->ChunkNum(); chunkIndex++) {
+                if (!ChunkMayPass(slot, chunkIndex)) {
+                    continue;
+                }
+                // batches of the same chunk run concurrently, so the chunk is detached up front
+                if constexpr (writable) {
+                    slot.archetype->DetachChunk(chunkIndex);
+                }
+                const auto elemNum = slot.archetype->ChunkElemNum(chunkIndex);
+                for (size_t begin = 0; begin < elemNum; begin += inGrainSize) {
+                    batches.emplace_back(ParallelBatch { &slot, chunkIndex, begin, std::min(begin + inGrainSize, elemNum) });
+                }
             }
         }
+
+        auto rowFunc = MakeRowFunc(inFunc);
+        Internal::ParallelFor(batches.size(), [&](size_t inBatchIndex) -> void {
+            const auto& batch = batches[inBatchIndex];
+            InvokeChunkFuncFiltered(*batch.slot, batch.chunkIndex, batch.begin, batch.end, rowFunc);
+        });
     }
 
     template <ECRegistryOrConst R, typename... C, typename... E>
-    const typename BasicView<R, Exclude<E...>, C...>::ResultVector& BasicView<R, Exclude<E...>, C...>::All() const
+    template <typename F>
+    void BasicView<R, Exclude<E...>, C...>::ForEachChunk(F&& inFunc) const
     {
-        return result;
+        for (const auto& slot : slots) {
+            for (size_t chunkIndex = 0; chunkIndex < slot.archetype->ChunkNum(); chunkIndex++) {
+                InvokeChunkFuncFiltered(slot, chunkIndex, 0, slot.archetype->ChunkElemNum(chunkIndex), inFunc);
+            }
+        }
     }
 
     template <ECRegistryOrConst R, typename ... C, typename ... E>
     size_t BasicView<R, Exclude<E...>, C...>::Count() const
     {
-        return result.size();
+        size_t result = 0;
+        for (const auto& slot : slots) {
+            if (changeFilters.empty()) {
+                result += slot.archetype->Count();
+                continue;
+            }
+            for (size_t chunkIndex = 0; chunkIndex < slot.archetype->ChunkNum(); chunkIndex++) {
+                if (!ChunkMayPass(slot, chunkIndex)) {
+                    continue;
+                }
+                for (size_t i = 0; i < slot.archetype->ChunkElemNum(chunkIndex); i++) {
+                    result += RowPasses(slot, chunkIndex, i) ? 1 : 0;
+                }
+            }
+        }
+        return result;
     }
 
     template <ECRegistryOrConst R, typename ... C, typename ... E>
     typename BasicView<R, Exclude<E...>, C...>::ConstIter BasicView<R, Exclude<E...>, C...>::Begin() const
     {
-        return result.begin();
+        return ConstIter(*this, 0);
     }
 
     template <ECRegistryOrConst R, typename ... C, typename ... E>
     typename BasicView<R, Exclude<E...>, C...>::ConstIter BasicView<R, Exclude<E...>, C...>::End() const
     {
-        return result.end();
+        return ConstIter(*this, slots.size());
     }
 
     template <ECRegistryOrConst R, typename ... C, typename ... E>
@@ -801,32 +1435,113 @@ namespace Runtime {
     }
 
     template <ECRegistryOrConst R, typename... C, typename... E>
-    void BasicView<R, Exclude<E...>, C...>::Evaluate(R& inRegistry)
+    template <typename T>
+    constexpr size_t BasicView<R, Exclude<E...>, C...>::IncludeIndex()
     {
-        std::vector<CompClass> includeCompIds;
-        includeCompIds.reserve(sizeof...(C));
-        (void) std::initializer_list<int> { ([&]() -> void {
-            includeCompIds.emplace_back(Internal::GetClass<std::decay_t<C>>());
-        }(), 0)... };
+        constexpr std::array<bool, sizeof...(C)> matches = { std::is_same_v<std::decay_t<T>, std::decay_t<C>>... };
+        constexpr auto index = static_cast<size_t>(std::ranges::find(matches, true) - matches.begin());
+        static_assert(index < sizeof...(C), "change filters must refer to one of the view components");
+        return index;
+    }
 
-        std::vector<CompClass> excludeCompIds;
-        excludeCompIds.reserve(sizeof...(E));
-        (void) std::initializer_list<int> { ([&]() -> void {
-            excludeCompIds.emplace_back(Internal::GetClass<E>());
-        }(), 0)... };
+    template <ECRegistryOrConst R, typename... C, typename... E>
+    template <typename F>
+    auto BasicView<R, Exclude<E...>, C...>::MakeRowFunc(F& inFunc)
+    {
+        return [&inFunc](std::span<const Entity> inEntities, std::span<C>... inComps) -> void {
+            for (size_t i = 0; i < inEntities.size(); i++) {
+                if constexpr (Internal::MemberFuncPtrTraits<decltype(&F::operator())>::ArgSize == 1) {
+                    inFunc(inEntities[i]);
+                } else {
+                    inFunc(inEntities[i], inComps[i]...);
+                }
+            }
+        };
+    }
 
-        for (auto& archetype : inRegistry.archetypes | std::views::values) {
-            if (!archetype.ContainsAll(includeCompIds) || !archetype.NotContainsAny(excludeCompIds)) {
-                continue;
+    template <ECRegistryOrConst R, typename... C, typename... E>
+    template <size_t... I>
+    void BasicView<R, Exclude<E...>, C...>::InvokeChunkFunc(const ArchetypeSlot& inSlot, size_t inChunkIndex, size_t inBegin, size_t inEnd, auto& inFunc, std::index_sequence<I...>)
+    {
+        auto* archetype = inSlot.archetype;
+        const auto elemNum = inEnd - inBegin;
+        if constexpr (writable) {
+            archetype->DetachChunk(inChunkIndex);
+        }
+        inFunc(
+            std::span<const Entity>(archetype->ChunkEntities(inChunkIndex) + inBegin, elemNum),
+            std::span<C>(static_cast<C*>(archetype->ChunkColumn(inChunkIndex, inSlot.compIndices[I])) + inBegin, elemNum)...);
+    }
+
+    template <ECRegistryOrConst R, typename... C, typename... E>
+    bool BasicView<R, Exclude<E...>, C...>::ChunkMayPass(const ArchetypeSlot& inSlot, size_t inChunkIndex) const
+    {
+        for (const auto& filter : changeFilters) {
+            if (inSlot.archetype->ChunkLatestTick(inChunkIndex, inSlot.compIndices[filter.includeIndex], filter.kind) < filter.sinceTick) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <ECRegistryOrConst R, typename... C, typename... E>
+    bool BasicView<R, Exclude<E...>, C...>::RowPasses(const ArchetypeSlot& inSlot, size_t inChunkIndex, size_t inElemIndex) const
+    {
+        for (const auto& filter : changeFilters) {
+            if (inSlot.archetype->ChunkTicks(inChunkIndex, inSlot.compIndices[filter.includeIndex], filter.kind)[inElemIndex] < filter.sinceTick) {
+                return false;
             }
+        }
+        return true;
+    }
+
+    template <ECRegistryOrConst R, typename... C, typename... E>
+    void BasicView<R, Exclude<E...>, C...>::InvokeChunkFuncFiltered(const ArchetypeSlot& inSlot, size_t inChunkIndex, size_t inBegin, size_t inEnd, auto& inFunc) const
+    {
+        if (changeFilters.empty()) {
+            InvokeChunkFunc(inSlot, inChunkIndex, inBegin, inEnd, inFunc, std::index_sequence_for<C...> {});
+            return;
+        }
+        if (!ChunkMayPass(inSlot, inChunkIndex)) {
+            return;
+        }
 
-            result.reserve(result.size() + archetype.Count());
-            for (auto entity : archetype.All()) {
-                result.emplace_back(entity, inRegistry.template Get<std::decay_t<C>>(entity)...);
+        auto runBegin = inBegin;
+        while (runBegin < inEnd) {
+            while (runBegin < inEnd && !RowPasses(inSlot, inChunkIndex, runBegin)) {
+                runBegin++;
+            }
+            auto runEnd = runBegin;
+            while (runEnd < inEnd && RowPasses(inSlot, inChunkIndex, runEnd)) {
+                runEnd++;
             }
+            if (runBegin < runEnd) {
+                InvokeChunkFunc(inSlot, inChunkIndex, runBegin, runEnd, inFunc, std::index_sequence_for<C...> {});
+            }
+            runBegin = runEnd;
         }
     }
 
+    template <ECRegistryOrConst R, typename... C, typename... E>
+    void BasicView<R, Exclude<E...>, C...>::Evaluate(R& inRegistry)
+    {
+        static const Internal::QueryKey key {
+            { Internal::GetClass<std::decay_t<C>>()... },
+            { Internal::GetClass<E>()... }
+        };
+#if BUILD_CONFIG_DEBUG
+        (void) std::initializer_list<int> { (Internal::CheckCompAccess(Internal::GetClass<std::decay_t<C>>(), !std::is_const_v<R> && !std::is_const_v<C>), 0)... };
+#endif
+
+        inRegistry.VisitQuery(key, [&](const Internal::Query& inQuery) -> void {
+            slots.resize(inQuery.MatchNum());
+            for (size_t i = 0; i < slots.size(); i++) {
+                slots[i].archetype = inQuery.GetMatch(i);
+                std::copy_n(inQuery.GetColumns(i), sizeof...(C), slots[i].compIndices.begin());
+            }
+        });
+    }
+
     template <ECRegistryOrConst R>
     BasicRuntimeView<R>::BasicRuntimeView(R& inRegistry, const RuntimeFilter& inFilter)
     {
@@ -838,10 +1553,44 @@ namespace Runtime {
     void BasicRuntimeView<R>::Each(F&& inFunc) const
     {
         using Traits = Internal::MemberFuncPtrTraits<decltype(&F::operator())>;
+        using ArgTuple = typename Traits::ArgsTupleType;
+        constexpr auto argIndices = std::make_index_sequence<Traits::ArgSize - 1> {};
+
+        const auto includeIndices = IncludeIndices<ArgTuple>(argIndices);
+        for (const auto& slot : slots) {
+            for (size_t chunkIndex = 0; chunkIndex < slot.archetype->ChunkNum(); chunkIndex++) {
+                InvokeChunkFunc<ArgTuple>(inFunc, slot, chunkIndex, 0, slot.archetype->ChunkElemNum(chunkIndex), includeIndices, argIndices);
+            }
+        }
+    }
 
-        for (const auto& pair : result) {
-            InvokeTraverseFuncInternal<F, typename Traits::ArgsTupleType>(std::forward<F>(inFunc), pair, std::make_index_sequence<Traits::ArgSize - 1> {});
+    template <ECRegistryOrConst R>
+    template <typename F>
+    void BasicRuntimeView<R>::ParallelEach(F&& inFunc, size_t inGrainSize) const
+    {
+        using Traits = Internal::MemberFuncPtrTraits<decltype(&F::operator())>;
+        using ArgTuple = typename Traits::ArgsTupleType;
+        constexpr auto argIndices = std::make_index_sequence<Traits::ArgSize - 1> {};
+
+        Assert(inGrainSize > 0);
+        // not taken from the frame arena, a view may be iterated on a thread or at a time without any frame running
+        std::array<std::byte, inlineBatchNum * sizeof(ParallelBatch)> batchMemory;
+        std::pmr::monotonic_buffer_resource batchResource(batchMemory.data(), batchMemory.size());
+        std::pmr::vector<ParallelBatch> batches(&batchResource);
+        for (const auto& slot : slots) {
+            for (size_t chunkIndex = 0; chunkIndex < slot.archetype->ChunkNum(); chunkIndex++) {
+                const auto elemNum = slot.archetype->ChunkElemNum(chunkIndex);
+                for (size_t begin = 0; begin < elemNum; begin += inGrainSize) {
+                    batches.emplace_back(ParallelBatch { &slot, chunkIndex, begin, std::min(begin + inGrainSize, elemNum) });
+                }
+            }
         }
+
+        const auto includeIndices = IncludeIndices<ArgTuple>(argIndices);
+        Internal::ParallelFor(batches.size(), [&](size_t inBatchIndex) -> void {
+            const auto& batch = batches[inBatchIndex];
+            InvokeChunkFunc<ArgTuple>(inFunc, *batch.slot, batch.chunkIndex, batch.begin, batch.end, includeIndices, argIndices);
+        });
     }
 
     template <ECRegistryOrConst R>
@@ -875,48 +1624,81 @@ namespace Runtime {
     }
 
     template <ECRegistryOrConst R>
-    template <typename F, typename ArgTuple, size_t... I>
-    void BasicRuntimeView<R>::InvokeTraverseFuncInternal(F&& inFunc, const std::pair<Entity, std::vector<Mirror::Any>>& inEntityAndComps, std::index_sequence<I...>) const
+    template <typename ArgTuple, size_t... I>
+    std::array<size_t, sizeof...(I)> BasicRuntimeView<R>::IncludeIndices(std::index_sequence<I...>) const
     {
-        inFunc(inEntityAndComps.first, GetCompRef<std::tuple_element_t<I + 1, ArgTuple>>(inEntityAndComps.second)...);
+        return { includeIndexMap.at(Internal::GetClass<std::decay_t<std::tuple_element_t<I + 1, ArgTuple>>>())... };
     }
 
     template <ECRegistryOrConst R>
     template <typename C>
-    decltype(auto) BasicRuntimeView<R>::GetCompRef(const std::vector<Mirror::Any>& inComps) const
+    auto* BasicRuntimeView<R>::ChunkColumn(const ArchetypeSlot& inSlot, size_t inChunkIndex, size_t inIncludeIndex) const
     {
         static_assert(std::is_reference_v<C>);
-        const auto compIndex = slotMap.at(Internal::GetClass<std::decay_t<C>>());
-        return inComps[compIndex].template As<C>();
+        using CompType = std::remove_reference_t<C>;
+        const auto compIndex = compIndices[inSlot.firstCompIndex + inIncludeIndex];
+        // only the columns taken by non-const reference are writes which detach the chunk
+        if constexpr (std::is_const_v<CompType>) {
+            return static_cast<CompType*>(std::as_const(*inSlot.archetype).ChunkColumn(inChunkIndex, compIndex));
+        } else {
+            static_assert(!std::is_const_v<R>, "a const runtime view only gives const component references");
+            return static_cast<CompType*>(inSlot.archetype->ChunkColumn(inChunkIndex, compIndex));
+        }
+    }
+
+    template <ECRegistryOrConst R>
+    template <typename ArgTuple, size_t... I>
+    void BasicRuntimeView<R>::InvokeChunkFunc(auto& inFunc, const ArchetypeSlot& inSlot, size_t inChunkIndex, size_t inBegin, size_t inEnd, const std::array<size_t, sizeof...(I)>& inIncludeIndices, std::index_sequence<I...>) const
+    {
+        const auto* entities = inSlot.archetype->ChunkEntities(inChunkIndex);
+        const std::tuple columns { ChunkColumn<std::tuple_element_t<I + 1, ArgTuple>>(inSlot, inChunkIndex, inIncludeIndices[I])... };
+        for (auto i = inBegin; i < inEnd; i++) {
+            inFunc(entities[i], std::get<I>(columns)[i]...);
+        }
     }
 
     template <ECRegistryOrConst R>
     void BasicRuntimeView<R>::Evaluate(R& inRegistry, const RuntimeFilter& inFilter)
     {
-        const std::vector includes(inFilter.includes.begin(), inFilter.includes.end());
-        const std::vector excludes(inFilter.excludes.begin(), inFilter.excludes.end());
+        // filters are unordered sets, sort the classes so that equal filters share the same cached query
+        Internal::QueryKey key {
+            { inFilter.includes.begin(), inFilter.includes.end() },
+            { inFilter.excludes.begin(), inFilter.excludes.end() }
+        };
+        std::ranges::sort(key.includes);
+        std::ranges::sort(key.excludes);
+        const auto& includes = key.includes;
+#if BUILD_CONFIG_DEBUG
+        for (const auto* clazz : includes) {
+            Internal::CheckCompAccess(clazz, !std::is_const_v<R>);
+        }
+#endif
 
-        slotMap.reserve(includes.size());
-        for (auto i = 0; i < includes.size(); i++) {
-            slotMap.emplace(includes[i], i);
+        includeIndexMap.reserve(includes.size());
+        for (size_t i = 0; i < includes.size(); i++) {
+            includeIndexMap.emplace(includes[i], i);
         }
 
-        for (auto& archetype : inRegistry.archetypes | std::views::values) {
-            if (!archetype.ContainsAll(includes) || !archetype.NotContainsAny(excludes)) {
-                continue;
+        inRegistry.VisitQuery(key, [&](const Internal::Query& inQuery) -> void {
+            slots.resize(inQuery.MatchNum());
+            compIndices.resize(slots.size() * includes.size());
+            for (size_t i = 0; i < slots.size(); i++) {
+                slots[i].archetype = inQuery.GetMatch(i);
+                slots[i].firstCompIndex = i * includes.size();
+                std::copy_n(inQuery.GetColumns(i), includes.size(), compIndices.data() + slots[i].firstCompIndex);
             }
+        });
 
-            resultEntities.reserve(result.size() + archetype.Count());
-            result.reserve(result.size() + archetype.Count());
-            for (const auto entity : archetype.All()) {
-                std::vector<Mirror::Any> comps;
-                comps.reserve(includes.size());
-                for (const auto* clazz : includes) {
-                    comps.emplace_back(archetype.GetComp(entity, clazz));
-                }
-
-                resultEntities.emplace_back(entity);
-                result.emplace_back(entity, std::move(comps));
+        // only the entities are gathered up front, the components are reached through the chunk columns when iterating
+        size_t entityNum = 0;
+        for (const auto& slot : slots) {
+            entityNum += slot.archetype->Count();
+        }
+        resultEntities.reserve(entityNum);
+        for (const auto& slot : slots) {
+            for (size_t chunkIndex = 0; chunkIndex < slot.archetype->ChunkNum(); chunkIndex++) {
+                const auto* entities = slot.archetype->ChunkEntities(chunkIndex);
+                resultEntities.insert(resultEntities.end(), entities, entities + slot.archetype->ChunkElemNum(chunkIndex));
             }
         }
     }
@@ -1069,12 +1851,42 @@ namespace Runtime {
         return removedObserver;
     }
 
+    template <typename C, typename... Args>
+    void EntityCommandBuffer::Emplace(Entity inEntity, Args&&... inArgs)
+    {
+        Record(CommandType::emplace, false, inEntity, Internal::GetClass<C>(), Mirror::Any(C(std::forward<Args>(inArgs)...)));
+    }
+
+    template <typename C, typename... Args>
+    void EntityCommandBuffer::Emplace(DeferredEntity inEntity, Args&&... inArgs)
+    {
+        Record(CommandType::emplace, true, inEntity.index, Internal::GetClass<C>(), Mirror::Any(C(std::forward<Args>(inArgs)...)));
+    }
+
+    template <typename C>
+    void EntityCommandBuffer::Remove(Entity inEntity)
+    {
+        RemoveDyn(Internal::GetClass<C>(), inEntity);
+    }
+
     template <typename C, typename ... Args>
     C& ECRegistry::Emplace(Entity inEntity, Args&&... inArgs)
     {
         return EmplaceDyn(Internal::GetClass<C>(), inEntity, Mirror::ForwardAsArgList(std::forward<Args>(inArgs)...)).template As<C&>();
     }
 
+    template <typename... C>
+    std::tuple<std::decay_t<C>&...> ECRegistry::EmplaceBundle(Entity inEntity, C&&... inComps)
+    {
+        auto compRefs = EmplaceDynBundle(
+            { Internal::GetClass<std::decay_t<C>>()... },
+            inEntity,
+            { Mirror::ForwardAsArgList(std::forward<C>(inComps))... });
+        return [&]<size_t... I>(std::index_sequence<I...>) -> std::tuple<std::decay_t<C>&...> {
+            return { compRefs[I].template As<std::decay_t<C>&>()... };
+        }(std::index_sequence_for<C...> {});
+    }
+
     template <typename C>
     void ECRegistry::Remove(Entity inEntity)
     {
@@ -1126,22 +1938,29 @@ namespace Runtime {
         return GetDyn(Internal::GetClass<C>(), inEntity).template As<const C&>();
     }
 
-    template <typename... C, typename... E>
-    Runtime::View<ECRegistry, Exclude<E...>, C...> ECRegistry::View(Exclude<E...>)
+    template <typename F>
+    void ECRegistry::VisitQuery(const Internal::QueryKey& inKey, F&& inFunc) const
+    {
+        std::unique_lock lock(queryMutex);
+        inFunc(std::as_const(FindOrAddQuery(inKey)));
+    }
+
+    template <typename... C, typename... E, typename... F>
+    Runtime::View<ECRegistry, Exclude<E...>, C...> ECRegistry::View(Exclude<E...>, const F&... inFilters)
     {
-        return Runtime::View<ECRegistry, Exclude<E...>, C...>(*this);
+        return Runtime::View<ECRegistry, Exclude<E...>, C...>(*this, inFilters...);
     }
 
-    template <typename ... C, typename ... E>
-    Runtime::ConstView<ECRegistry, Exclude<E...>, C...> ECRegistry::View(Exclude<E...>) const
+    template <typename ... C, typename ... E, typename... F>
+    Runtime::ConstView<ECRegistry, Exclude<E...>, C...> ECRegistry::View(Exclude<E...>, const F&... inFilters) const
     {
-        return Runtime::ConstView<ECRegistry, Exclude<E...>, C...>(*this);
+        return Runtime::ConstView<ECRegistry, Exclude<E...>, C...>(*this, inFilters...);
     }
 
-    template <typename ... C, typename ... E>
-    Runtime::ConstView<ECRegistry, Exclude<E...>, C...> ECRegistry::ConstView(Exclude<E...>) const
+    template <typename ... C, typename ... E, typename... F>
+    Runtime::ConstView<ECRegistry, Exclude<E...>, C...> ECRegistry::ConstView(Exclude<E...>, const F&... inFilters) const
     {
-        return Runtime::ConstView<ECRegistry, Exclude<E...>, C...>(*this);
+        return Runtime::ConstView<ECRegistry, Exclude<E...>, C...>(*this, inFilters...);
     }
 
     template <typename C>
@@ -4,22 +4,26 @@
 
 #pragma once
 
-#include <functional>
-#include <queue>
 #include <future>
+#include <vector>
 
 #include <Common/Debug.h>
 #include <Common/Concurrent.h>
 #include <Core/Thread.h>
+#include <Runtime/Api.h>
 
 namespace Runtime {
     class GameThread {
     public:
         static GameThread& Get();
 
+        static constexpr size_t taskQueueCapacity = 4096;
+
         ~GameThread();
 
         template <typename F> auto EmplaceTask(F&& inTask);
+        // fire-and-forget, no future is created
+        template <typename F> void PostTask(F&& inTask);
 
     private:
         friend class Engine;
@@ -27,12 +31,17 @@ namespace Runtime {
         GameThread();
 
         void Flush();
-
-        std::mutex mutex;
-        std::queue<std::function<void()>> tasks;
+        // the game thread is the consumer, so posting to itself spills into overflowTasks instead of blocking on a full ring
+        void PostLocal(Common::UniqueTask&& inTask);
+
+        // tasks are drained by the game thread once per frame in Flush()
+        Common::MpscRing<Common::UniqueTask> tasks;
+        // only touched by the game thread, run by Flush() after the ring
+        std::vector<Common::UniqueTask> overflowTasks;
+        std::vector<Common::UniqueTask> runningOverflowTasks;
     };
 
-    class GameWorkerThreads {
+    class RUNTIME_API GameWorkerThreads {
     public:
         static GameWorkerThreads& Get();
 
@@ -40,8 +49,15 @@ namespace Runtime {
 
         void Start();
         void Stop();
+        bool Started() const;
         template <typename F> auto EmplaceTask(F&& inTask);
+        // fire-and-forget, no future is created
+        template <typename F> void PostTask(F&& inTask);
         template <typename F> void ExecuteTasks(size_t inTaskNum, F&& inTask);
+        // inFunc(i) for i in [inBegin, inEnd) with ThreadTag::gameWorker set, the calling thread takes part
+        template <typename F> void ParallelFor(size_t inBegin, size_t inEnd, size_t inGrainSize, F&& inFunc);
+        // runs the graph on the workers and waits for it, the calling thread takes part, the nodes set their own thread tag
+        void RunAndWait(Common::TaskGraph& inGraph) const;
 
     private:
         GameWorkerThreads();
@@ -55,24 +71,42 @@ namespace Runtime {
     auto GameThread::EmplaceTask(F&& inTask)
     {
         using RetType = std::invoke_result_t<F>;
-        auto packagedTask = Common::MakeShared<std::packaged_task<RetType()>>(inTask);
-        auto result = packagedTask->get_future();
-        {
-            std::unique_lock lock(mutex);
-            tasks.emplace([packagedTask]() -> void { (*packagedTask)(); });
-        }
+        std::packaged_task<RetType()> packagedTask(std::forward<F>(inTask));
+        auto result = packagedTask.get_future();
+        PostTask(std::move(packagedTask));
         return result;
     }
 
+    template <typename F>
+    void GameThread::PostTask(F&& inTask)
+    {
+        Common::UniqueTask task(std::forward<F>(inTask));
+        if (Core::ThreadContext::IsGameThread()) {
+            PostLocal(std::move(task));
+            return;
+        }
+        tasks.Push(std::move(task));
+    }
+
     template <typename F>
     auto GameWorkerThreads::EmplaceTask(F&& inTask)
     {
         using RetType = std::invoke_result_t<F>;
 
         Assert(threads != nullptr);
-        return threads->EmplaceTask([inTask]() -> RetType {
+        return threads->EmplaceTask([task = std::forward<F>(inTask)]() mutable -> RetType {
+            Core::ScopedThreadTag tag(Core::ThreadTag::gameWorker);
+            return task();
+        });
+    }
+
+    template <typename F>
+    void GameWorkerThreads::PostTask(F&& inTask)
+    {
+        Assert(threads != nullptr);
+        threads->PostTask([task = std::forward<F>(inTask)]() mutable -> void {
             Core::ScopedThreadTag tag(Core::ThreadTag::gameWorker);
-            return inTask();
+            task();
         });
     }
 
@@ -86,4 +120,14 @@ namespace Runtime {
             reboundTask(inIndex);
         });
     }
+
+    template <typename F>
+    void GameWorkerThreads::ParallelFor(size_t inBegin, size_t inEnd, size_t inGrainSize, F&& inFunc)
+    {
+        Assert(threads != nullptr);
+        threads->ParallelFor(inBegin, inEnd, inGrainSize, [&inFunc](size_t inIndex) -> void {
+            Core::ScopedThreadTag tag(Core::ThreadTag::gameWorker);
+            inFunc(inIndex);
+        });
+    }
 } // namespace Runtime
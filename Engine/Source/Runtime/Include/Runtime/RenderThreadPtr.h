@@ -61,7 +61,7 @@ namespace Runtime {
     RenderThreadPtr<T>::~RenderThreadPtr()
     {
         if (ptr.Valid()) {
-            EngineHolder::Get().GetRenderModule().GetRenderThread().EmplaceTask([transferPtr = std::move(ptr)]() mutable -> void {
+            EngineHolder::Get().GetRenderModule().GetRenderThread().PostTask([transferPtr = std::move(ptr)]() mutable -> void {
                 transferPtr.Reset();
             });
         }
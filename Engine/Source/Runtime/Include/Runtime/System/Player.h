@@ -36,9 +36,9 @@ namespace Runtime {
     template <typename T>
     Entity PlayerSystem::CreatePlayer()
     {
-        const auto& playerStartQuery = registry.View<PlayerStart, WorldTransform>().All();
-        Assert(playerStartQuery.size() == 1);
-        const auto& [playerStartEntity, playerStart, playerStartTransform] = playerStartQuery[0];
+        const auto playerStartView = registry.View<PlayerStart, WorldTransform>();
+        Assert(playerStartView.Count() == 1);
+        const auto& [playerStartEntity, playerStart, playerStartTransform] = *playerStartView.Begin();
 
         const auto playerEntity = registry.Create();
         registry.Emplace<Camera>(playerEntity);
@@ -30,7 +30,8 @@ namespace Runtime {
     private:
         static Common::URect GetPlayerViewport(uint32_t inWidth, uint32_t inHeight, uint8_t inPlayerNum, uint8_t inPlayerIndex);
         template <typename T> Render::View BuildViewForPlayer(Entity inEntity, uint8_t inPlayerNum, uint8_t inPlayerIndex) const;
-        std::vector<Render::View> BuildViews() const;
+        // the views live in the game thread frame arena, which outlives the render thread frame consuming them
+        Common::FrameVector<Render::View> BuildViews() const;
 
         Render::RenderModule& renderModule;
         PlayType playType;
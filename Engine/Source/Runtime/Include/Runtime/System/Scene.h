@@ -4,14 +4,13 @@
 
 #pragma once
 
-#include <optional>
-
 #include <Runtime/ECS.h>
 #include <Runtime/Component/Light.h>
 #include <Runtime/Component/Transform.h>
 #include <Runtime/Component/Scene.h>
 #include <Render/RenderModule.h>
 #include <Render/Scene.h>
+#include <Render/SceneUpdate.h>
 #include <Render/SceneProxy/Light.h>
 #include <Render/SceneProxy/Primitive.h>
 
@@ -33,8 +32,13 @@ namespace Runtime {
         template <typename Component, typename SceneProxy> void QueueUpdateSceneProxyContent(Entity inEntity);
         template <typename SceneProxy> void QueueUpdateSceneProxyTransform(Entity inEntity);
         template <typename SceneProxy> void QueueRemoveSceneProxy(Entity inEntity);
+        void SubmitSceneUpdates();
 
         Render::RenderModule& renderModule;
+        // shared with the submitted tasks, render thread returns the applied buffers even after this system is gone
+        Common::SharedPtr<Render::SceneUpdateBufferPool> sceneUpdatePool;
+        // scene proxy changes of current frame, submitted to render thread as one task at the end of Tick()
+        Common::UniquePtr<Render::SceneUpdateBuffer> sceneUpdates;
         Observer transformUpdatedObserver;
         EventsObserver<DirectionalLight> directionalLightsObserver;
         EventsObserver<PointLight> pointLightsObserver;
@@ -53,13 +57,7 @@ namespace Runtime::Internal {
     template <typename SceneProxy>
     static void UpdateSceneProxyWorldTransform(SceneProxy& outSceneProxy, const WorldTransform& inTransform, bool withScale = true)
     {
-        outSceneProxy.localToWorld = withScale ? inTransform.localToWorld.GetTransformMatrix() : inTransform.localToWorld.GetTransformMatrixNoScale();
-    }
-
-    template <typename T>
-    static std::optional<T> GetOptional(const T* inObj)
-    {
-        return inObj == nullptr ? std::optional<T>() : *inObj;
+        outSceneProxy.localToWorld = withScale ? inTransform.localToWorldMatrix : inTransform.localToWorld.GetTransformMatrixNoScale();
     }
 }
 
@@ -96,47 +94,36 @@ namespace Runtime {
     template <typename Component, typename SceneProxy>
     void SceneSystem::QueueCreateSceneProxy(Entity inEntity)
     {
-        const auto& sceneHolder = registry.GGet<SceneHolder>();
         const auto& component = registry.Get<Component>(inEntity);
         const auto* transform = registry.Find<WorldTransform>(inEntity);
-        renderModule.GetRenderThread().EmplaceTask([scene = sceneHolder.scene.Get(), inEntity, component, transform = Internal::GetOptional(transform)]() -> void {
-            SceneProxy sceneProxy;
-            Internal::UpdateSceneProxyContent(sceneProxy, component);
-            if (transform.has_value()) {
-                Internal::UpdateSceneProxyWorldTransform(sceneProxy, transform.value(), false);
-            }
-            scene->Add<SceneProxy>(inEntity, std::move(sceneProxy));
-        });
+
+        SceneProxy sceneProxy;
+        Internal::UpdateSceneProxyContent(sceneProxy, component);
+        if (transform != nullptr) {
+            Internal::UpdateSceneProxyWorldTransform(sceneProxy, *transform, false);
+        }
+        sceneUpdates->Add(inEntity, std::move(sceneProxy));
     }
 
     template <typename Component, typename SceneProxy>
     void SceneSystem::QueueUpdateSceneProxyContent(Entity inEntity)
     {
-        const auto& sceneHolder = registry.GGet<SceneHolder>();
         const auto& component = registry.Get<Component>(inEntity);
-        renderModule.GetRenderThread().EmplaceTask([scene = sceneHolder.scene.Get(), inEntity, component]() -> void {
-            auto& sceneProxy = scene->Get<SceneProxy>(inEntity);
-            Internal::UpdateSceneProxyContent(sceneProxy, component);
+        sceneUpdates->UpdateContent<SceneProxy>(inEntity, [component](SceneProxy& outSceneProxy) -> void {
+            Internal::UpdateSceneProxyContent(outSceneProxy, component);
         });
     }
 
     template <typename SceneProxy>
     void SceneSystem::QueueUpdateSceneProxyTransform(Entity inEntity)
     {
-        const auto& sceneHolder = registry.GGet<SceneHolder>();
         const auto& transform = registry.Get<WorldTransform>(inEntity);
-        renderModule.GetRenderThread().EmplaceTask([scene = sceneHolder.scene.Get(), inEntity, transform]() -> void {
-            auto& sceneProxy = scene->Get<SceneProxy>(inEntity);
-            Internal::UpdateSceneProxyWorldTransform(sceneProxy, transform, false);
-        });
+        sceneUpdates->UpdateTransform<SceneProxy>(inEntity, transform.localToWorld.GetTransformMatrixNoScale());
     }
 
     template <typename SceneProxy>
     void SceneSystem::QueueRemoveSceneProxy(Entity inEntity)
     {
-        const auto& sceneHolder = registry.GGet<SceneHolder>();
-        renderModule.GetRenderThread().EmplaceTask([scene = sceneHolder.scene.Get(), inEntity]() -> void {
-            scene->Remove<SceneProxy>(inEntity);
-        });
+        sceneUpdates->Remove<SceneProxy>(inEntity);
     }
 }
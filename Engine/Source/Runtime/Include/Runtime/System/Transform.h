@@ -4,6 +4,9 @@
 
 #pragma once
 
+#include <vector>
+
+#include <Common/Memory.h>
 #include <Runtime/Meta.h>
 #include <Runtime/ECS.h>
 #include <Runtime/Component/Transform.h>
@@ -23,7 +26,31 @@ namespace Runtime {
         void Tick(float inDeltaTimeSeconds) override;
 
     private:
-        Observer worldTransformUpdatedObserver;
-        Observer localTransformUpdatedObserver;
+        struct PropagateNode {
+            Entity entity;
+            // index of the parent node in the previous depth level, rootParentIndex for the dirty roots
+            uint32_t parentIndex;
+            // dirty roots only, whether the root's own world transform is recomputed from its parent
+            bool updateSelf;
+            // whether localToWorld holds the node's world matrix, children of an invalid node are not updated
+            bool valid;
+            // resolved on the ticking thread before the level is propagated in parallel, nullptr if the node has none
+            WorldTransform* worldTransform;
+            Common::FMat4x4 localToWorld;
+        };
+
+        static constexpr uint32_t rootParentIndex = UINT32_MAX;
+        static constexpr size_t propagateGrainSize = 256;
+
+        void SyncWorldMatrices(ChangeTick inSinceTick);
+        void UpdateLocalTransforms(const Common::FrameVector<Entity>& inEntities);
+        void CollectDirtyRoots(const Common::FrameUnorderedMap<Entity, bool>& inDirtyEntities);
+        void PropagateWorldTransforms();
+        void PropagateBatch(std::vector<PropagateNode>& ioLevel, size_t inBegin, size_t inEnd, const std::vector<PropagateNode>* inParentLevel, Common::FrameVector<PropagateNode>& outChildren);
+
+        ChangeTick lastChangeTick;
+        // dirty nodes grouped by hierarchy depth below their dirty root, level i + 1 holds the children of level i,
+        // kept between ticks to reuse the allocations
+        std::vector<std::vector<PropagateNode>> levels;
     };
 }
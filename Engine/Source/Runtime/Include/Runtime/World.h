@@ -48,6 +48,8 @@ namespace Runtime {
         Runtime::PlayStatus playStatus;
         SystemSetupContext systemSetupContext;
         ECRegistry ecRegistry;
+        // editor state taken at Play() of an editor world and restored at Stop()
+        std::optional<ECRegistry> editorSnapshot;
         SystemGraph systemGraph;
         std::optional<SystemGraphExecutor> executor;
     };
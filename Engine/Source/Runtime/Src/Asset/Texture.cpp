@@ -227,7 +227,7 @@ namespace Runtime {
                 .SetMipLevels(0, mipLevels)
                 .SetArrayLayers(0, type == TextureType::t3D ? 1 : depthOrArraySize));
 
-        renderModule.GetRenderThread().EmplaceTask([
+        renderModule.GetRenderThread().PostTask([
             device,
             texturePtr = texture.Get(),
             type = type,
@@ -7,10 +7,14 @@
 #include <Runtime/Component/Transform.h>
 
 namespace Runtime {
-    WorldTransform::WorldTransform() = default;
+    WorldTransform::WorldTransform()
+        : localToWorldMatrix(localToWorld.GetTransformMatrix())
+    {
+    }
 
     WorldTransform::WorldTransform(Common::FTransform inLocalToWorld)
         : localToWorld(std::move(inLocalToWorld))
+        , localToWorldMatrix(localToWorld.GetTransformMatrix())
     {
     }
 
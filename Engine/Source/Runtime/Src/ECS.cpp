@@ -2,12 +2,82 @@
 // Created by johnk on 2024/10/31.
 //
 
-#include <taskflow/taskflow.hpp>
+#include <fstream>
 
+
+#include <Common/File.h>
+#include <Common/FileSystem.h>
+#include <Common/Hash.h>
 #include <Core/Thread.h>
 #include <Runtime/ECS.h>
+#include <Runtime/GameThread.h>
 
 namespace Runtime {
+    SystemAccess::SystemAccess()
+        : declared(false)
+        , exclusive(false)
+    {
+    }
+
+    SystemAccess& SystemAccess::ReadDyn(CompClass inClass)
+    {
+        declared = true;
+        reads.emplace(inClass);
+        return *this;
+    }
+
+    SystemAccess& SystemAccess::WriteDyn(CompClass inClass)
+    {
+        declared = true;
+        writes.emplace(inClass);
+        return *this;
+    }
+
+    SystemAccess& SystemAccess::Exclusive()
+    {
+        declared = true;
+        exclusive = true;
+        return *this;
+    }
+
+    bool SystemAccess::Declared() const
+    {
+        return declared;
+    }
+
+    bool SystemAccess::IsExclusive() const
+    {
+        return exclusive;
+    }
+
+    bool SystemAccess::CanRead(CompClass inClass) const
+    {
+        return exclusive || reads.contains(inClass) || writes.contains(inClass);
+    }
+
+    bool SystemAccess::CanWrite(CompClass inClass) const
+    {
+        return exclusive || writes.contains(inClass);
+    }
+
+    bool SystemAccess::ConflictsWith(const SystemAccess& inOther) const
+    {
+        if (exclusive || inOther.exclusive) {
+            return true;
+        }
+        for (const auto* clazz : writes) {
+            if (inOther.reads.contains(clazz) || inOther.writes.contains(clazz)) {
+                return true;
+            }
+        }
+        for (const auto* clazz : inOther.writes) {
+            if (reads.contains(clazz)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
     System::System(ECRegistry& inRegistry, const SystemSetupContext&)
         : registry(inRegistry)
     {
@@ -16,6 +86,11 @@ namespace Runtime {
     System::~System() = default;
 
     void System::Tick(float inDeltaTimeSeconds) {}
+
+    const SystemAccess& System::GetAccess() const
+    {
+        return access;
+    }
 }
 
 namespace Runtime::Internal {
@@ -24,8 +99,111 @@ namespace Runtime::Internal {
         return inClass->GetMetaBoolOr(MetaPresets::globalComp, false);
     }
 
+    // columnar snapshot layout, values are in native byte order, every blob (entity array, component column) starts at a
+    // columnarAlignment aligned offset so it can be read in place from a mapped file:
+    // header | schema table | archetypes (compNum, rowNum, schema indices, entities, columns) | global components
+    // the raw columns can not be swapped without knowing their fields, so a snapshot of the other byte order is rejected,
+    // the byte order mark of the header reads back as columnarByteOrderMark only on a machine of the saving byte order
+    static constexpr uint32_t columnarMagic = 0x4C4F4345; // "ECOL"
+    static constexpr uint32_t columnarVersion = 2;
+    static constexpr uint32_t columnarByteOrderMark = 0x01020304;
+    static constexpr uint32_t columnarAlignment = 16;
+
+    struct ColumnarHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t byteOrderMark;
+        uint32_t schemaNum;
+        uint32_t archetypeNum;
+        uint32_t globalCompNum;
+    };
+
+    template <typename T>
+    static void ColumnarWrite(std::vector<uint8_t>& outBytes, const T& inValue)
+    {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(&inValue);
+        outBytes.insert(outBytes.end(), bytes, bytes + sizeof(T));
+    }
+
+    static void ColumnarWriteBytes(std::vector<uint8_t>& outBytes, const void* inData, size_t inSize)
+    {
+        const auto* bytes = static_cast<const uint8_t*>(inData);
+        outBytes.insert(outBytes.end(), bytes, bytes + inSize);
+    }
+
+    static void ColumnarWritePadding(std::vector<uint8_t>& outBytes)
+    {
+        outBytes.resize(Common::AlignUp<columnarAlignment>(outBytes.size()), 0);
+    }
+
+    class ColumnarReader {
+    public:
+        ColumnarReader(const uint8_t* inData, size_t inSize)
+            : data(inData)
+            , size(inSize)
+            , pointer(0)
+            , failed(false)
+        {
+        }
+
+        // a read past the end returns zeros and marks the reader failed, the caller checks Failed() before using the data
+        template <typename T>
+        T Read()
+        {
+            T result {};
+            if (const auto* bytes = ReadBytes(sizeof(T));
+                bytes != nullptr) {
+                memcpy(&result, bytes, sizeof(T));
+            }
+            return result;
+        }
+
+        const uint8_t* ReadBytes(size_t inSize)
+        {
+            if (failed || inSize > size - pointer) {
+                failed = true;
+                return nullptr;
+            }
+            const auto* result = data + pointer;
+            pointer += inSize;
+            return result;
+        }
+
+        void SkipPadding()
+        {
+            pointer = std::min(Common::AlignUp<columnarAlignment>(pointer), size);
+        }
+
+        bool End() const
+        {
+            return pointer == size;
+        }
+
+        bool Failed() const
+        {
+            return failed;
+        }
+
+    private:
+        const uint8_t* data;
+        size_t size;
+        size_t pointer;
+        bool failed;
+    };
+
+    static size_t GetCompMaskBit(CompClass inClass)
+    {
+        static std::mutex mutex;
+        static std::unordered_map<CompClass, size_t> bits;
+
+        std::unique_lock lock(mutex);
+        return bits.emplace(inClass, bits.size()).first->second;
+    }
+
     CompRtti::CompRtti(CompClass inClass)
         : clazz(inClass)
+        , triviallyCopyable(inClass->GetTypeInfo()->triviallyCopyable)
+        , maskBit(GetCompMaskBit(inClass))
         , bound(false)
         , offset(0)
     {
@@ -37,30 +215,64 @@ namespace Runtime::Internal {
         offset = inOffset;
     }
 
-    Mirror::Any CompRtti::MoveConstruct(ElemPtr inElem, const Mirror::Any& inOther) const
+    Mirror::Any CompRtti::MoveConstruct(CompPtr inComp, const Mirror::Any& inOther) const
+    {
+        return clazz->GetConstructor(Mirror::IdPresets::moveCtor).InplaceNewDyn(inComp, { inOther });
+    }
+
+    Mirror::Any CompRtti::CopyConstruct(CompPtr inComp, const Mirror::Any& inOther) const
     {
-        auto* compBegin = static_cast<uint8_t*>(inElem) + offset;
-        return clazz->InplaceNewDyn(compBegin, { inOther });
+        // the copy constructor is picked by id, the overload resolution of InplaceNewDyn() rates the move constructor
+        // higher for a const reference too, which would move out of the source chunk still shared with a snapshot
+        return clazz->GetConstructor(Mirror::IdPresets::copyCtor).InplaceNewDyn(inComp, { inOther.ConstRef() });
     }
 
-    Mirror::Any CompRtti::MoveAssign(ElemPtr inElem, const Mirror::Any& inOther) const
+    Mirror::Any CompRtti::MoveAssign(CompPtr inComp, const Mirror::Any& inOther) const
     {
-        auto* compBegin = static_cast<uint8_t*>(inElem) + offset;
-        auto compRef = clazz->InplaceGetObject(compBegin);
+        auto compRef = clazz->InplaceGetObject(inComp);
         compRef.MoveAssign(inOther);
         return compRef;
     }
 
-    void CompRtti::Destruct(ElemPtr inElem) const
+    void CompRtti::Relocate(CompPtr inDst, CompPtr inSrc) const
+    {
+        if (triviallyCopyable) {
+            memcpy(inDst, inSrc, MemorySize());
+            return;
+        }
+        MoveConstruct(inDst, Get(inSrc));
+        Destruct(inSrc);
+    }
+
+    void CompRtti::CopyConstructRange(CompPtr inDst, CompPtr inSrc, size_t inNum) const
+    {
+        if (triviallyCopyable) {
+            memcpy(inDst, inSrc, MemorySize() * inNum);
+            return;
+        }
+        for (size_t i = 0; i < inNum; i++) {
+            CopyConstruct(static_cast<uint8_t*>(inDst) + i * MemorySize(), Get(static_cast<uint8_t*>(inSrc) + i * MemorySize()));
+        }
+    }
+
+    void CompRtti::DestructRange(CompPtr inComps, size_t inNum) const
+    {
+        if (triviallyCopyable) {
+            return;
+        }
+        for (size_t i = 0; i < inNum; i++) {
+            Destruct(static_cast<uint8_t*>(inComps) + i * MemorySize());
+        }
+    }
+
+    void CompRtti::Destruct(CompPtr inComp) const
     {
-        auto* compBegin = static_cast<uint8_t*>(inElem) + offset;
-        clazz->DestructDyn(clazz->InplaceGetObject(compBegin));
+        clazz->DestructDyn(clazz->InplaceGetObject(inComp));
     }
 
-    Mirror::Any CompRtti::Get(ElemPtr inElem) const
+    Mirror::Any CompRtti::Get(CompPtr inComp) const
     {
-        auto* compBegin = static_cast<uint8_t*>(inElem) + offset;
-        return clazz->InplaceGetObject(compBegin);
+        return clazz->InplaceGetObject(inComp);
     }
 
     CompClass CompRtti::Class() const
@@ -78,114 +290,252 @@ namespace Runtime::Internal {
         return clazz->SizeOf();
     }
 
+    size_t CompRtti::MaskBit() const
+    {
+        return maskBit;
+    }
+
+    CompMask::CompMask() = default;
+
+    void CompMask::Set(CompClass inClass)
+    {
+        SetBit(GetCompMaskBit(inClass));
+    }
+
+    void CompMask::Set(const CompRtti& inRtti)
+    {
+        SetBit(inRtti.MaskBit());
+    }
+
+    void CompMask::SetBit(size_t inBit)
+    {
+        const auto wordIndex = inBit / 64;
+        if (wordIndex >= words.size()) {
+            words.resize(wordIndex + 1, 0);
+        }
+        words[wordIndex] |= 1ull << (inBit % 64);
+    }
+
+    bool CompMask::ContainsAll(const CompMask& inOther) const
+    {
+        for (size_t i = 0; i < inOther.words.size(); i++) {
+            const auto word = i < words.size() ? words[i] : 0;
+            if ((word & inOther.words[i]) != inOther.words[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool CompMask::Intersects(const CompMask& inOther) const
+    {
+        const auto wordNum = std::min(words.size(), inOther.words.size());
+        for (size_t i = 0; i < wordNum; i++) {
+            if ((words[i] & inOther.words[i]) != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
     Archetype::Archetype(const std::vector<CompRtti>& inRttiVec)
         : id(0)
         , count(0)
-        , elemSize(1)
+        , chunkCapacity(0)
+        , chunkMemorySize(0)
         , rttiVec(inRttiVec)
     {
         rttiMap.reserve(rttiVec.size());
-        for (auto i = 0; i < rttiVec.size(); i++) {
-            auto& rtti = rttiVec[i];
-            const auto clazz = rtti.Class();
+        for (size_t i = 0; i < rttiVec.size(); i++) {
+            const auto clazz = rttiVec[i].Class();
             rttiMap.emplace(clazz, i);
-
+            compMask.Set(rttiVec[i]);
             id += clazz->GetTypeInfo()->id;
-            rtti.Bind(elemSize);
-            elemSize += rtti.MemorySize();
         }
+        BuildChunkLayout();
+        chunkLayout = std::make_shared<const std::vector<CompRtti>>(rttiVec);
     }
 
-    bool Archetype::Contains(CompClass inClazz) const
+    Archetype::Archetype(const Archetype& inOther)
+        : id(inOther.id)
+        , count(inOther.count)
+        , chunkCapacity(inOther.chunkCapacity)
+        , chunkMemorySize(inOther.chunkMemorySize)
+        , rttiVec(inOther.rttiVec)
+        , rttiMap(inOther.rttiMap)
+        , compMask(inOther.compMask)
+        , chunkLayout(inOther.chunkLayout)
+        , chunks(inOther.chunks)
     {
-        for (const auto& rtti : rttiVec) {
-            if (rtti.Class() == inClazz) {
-                return true;
-            }
-        }
-        return false;
     }
 
-    bool Archetype::ContainsAll(const std::vector<CompClass>& inClasses) const
+    Archetype::Archetype(Archetype&& inOther) noexcept
+        : id(inOther.id)
+        , count(std::exchange(inOther.count, 0))
+        , chunkCapacity(inOther.chunkCapacity)
+        , chunkMemorySize(inOther.chunkMemorySize)
+        , rttiVec(std::move(inOther.rttiVec))
+        , rttiMap(std::move(inOther.rttiMap))
+        , compMask(std::move(inOther.compMask))
+        , chunkLayout(std::move(inOther.chunkLayout))
+        , chunks(std::move(inOther.chunks))
+        , addEdges(std::move(inOther.addEdges))
+        , removeEdges(std::move(inOther.removeEdges))
+        , bundleEdges(std::move(inOther.bundleEdges))
     {
-        for (const auto& clazz : inClasses) {
-            if (!Contains(clazz)) {
-                return false;
-            }
+    }
+
+    Archetype::~Archetype()
+    {
+        ReleaseChunks();
+    }
+
+    Archetype& Archetype::operator=(const Archetype& inOther)
+    {
+        if (this == &inOther) {
+            return *this;
         }
-        return true;
+
+        ReleaseChunks();
+        id = inOther.id;
+        count = inOther.count;
+        chunkCapacity = inOther.chunkCapacity;
+        chunkMemorySize = inOther.chunkMemorySize;
+        rttiVec = inOther.rttiVec;
+        rttiMap = inOther.rttiMap;
+        compMask = inOther.compMask;
+        chunkLayout = inOther.chunkLayout;
+        chunks = inOther.chunks;
+        addEdges.clear();
+        removeEdges.clear();
+        bundleEdges.clear();
+        return *this;
     }
 
-    bool Archetype::NotContainsAny(const std::vector<CompClass>& inClasses) const
+    Archetype& Archetype::operator=(Archetype&& inOther) noexcept
     {
-        for (const auto& clazz : inClasses) {
-            if (Contains(clazz)) {
-                return false;
-            }
+        if (this == &inOther) {
+            return *this;
         }
-        return true;
+
+        ReleaseChunks();
+        id = inOther.id;
+        count = std::exchange(inOther.count, 0);
+        chunkCapacity = inOther.chunkCapacity;
+        chunkMemorySize = inOther.chunkMemorySize;
+        rttiVec = std::move(inOther.rttiVec);
+        rttiMap = std::move(inOther.rttiMap);
+        compMask = std::move(inOther.compMask);
+        chunkLayout = std::move(inOther.chunkLayout);
+        chunks = std::move(inOther.chunks);
+        addEdges = std::move(inOther.addEdges);
+        removeEdges = std::move(inOther.removeEdges);
+        bundleEdges = std::move(inOther.bundleEdges);
+        return *this;
+    }
+
+    bool Archetype::Contains(CompClass inClazz) const
+    {
+        return rttiMap.contains(inClazz);
     }
 
-    ElemPtr Archetype::EmplaceElem(Entity inEntity)
+    bool Archetype::ContainsAll(const CompMask& inMask) const
     {
-        ElemPtr result = AllocateNewElemBack();
-        auto backElem = count - 1;
-        entityMap.emplace(inEntity, backElem);
-        elemMap.emplace(backElem, inEntity);
-        return result;
+        return compMask.ContainsAll(inMask);
     }
 
-    ElemPtr Archetype::EmplaceElem(Entity inEntity, ElemPtr inSrcElem, const std::vector<CompRtti>& inSrcRttiVec)
+    bool Archetype::NotContainsAny(const CompMask& inMask) const
     {
-        ElemPtr newElem = EmplaceElem(inEntity);
-        for (const auto& srcRtti : inSrcRttiVec) {
-            const auto* newRtti = FindCompRtti(srcRtti.Class());
-            if (newRtti == nullptr) {
-                continue;
+        return !compMask.Intersects(inMask);
+    }
+
+    ElemIndex Archetype::EmplaceElem(Entity inEntity)
+    {
+        const auto elemIndex = AllocateNewElemBack();
+        EntityAt(elemIndex) = inEntity;
+        return elemIndex;
+    }
+
+    ElemIndex Archetype::EmplaceElems(const Entity* inEntities, size_t inNum)
+    {
+        const auto begin = count;
+        chunks.reserve((count + inNum + chunkCapacity - 1) / chunkCapacity);
+        for (size_t i = 0; i < inNum;) {
+            // fill the rest of the last chunk, or a new one, with a single copy
+            const auto elemIndex = AllocateNewElemBack();
+            const auto elemNum = std::min(inNum - i, chunkCapacity - elemIndex % chunkCapacity);
+            memcpy(&EntityAt(elemIndex), inEntities + i, elemNum * sizeof(Entity));
+            WritableChunk(elemIndex / chunkCapacity).elemNum += elemNum - 1;
+            count += elemNum - 1;
+            i += elemNum;
+        }
+        return begin;
+    }
+
+    ElemIndex Archetype::MoveElem(ElemIndex inIndex, const ArchetypeEdge& inEdge, Entity& outMovedEntity)
+    {
+        auto& target = *inEdge.target;
+        const auto elemIndex = inIndex;
+        const auto targetElemIndex = target.EmplaceElem(EntityAt(elemIndex));
+
+        for (size_t i = 0; i < rttiVec.size(); i++) {
+            const auto& rtti = rttiVec[i];
+            const auto targetCompIndex = inEdge.columnRemap[i];
+            if (targetCompIndex == ArchetypeEdge::invalidCompIndex) {
+                rtti.Destruct(CompAt(elemIndex, rtti));
+            } else {
+                const auto& targetRtti = target.rttiVec[targetCompIndex];
+                rtti.Relocate(target.CompAt(targetElemIndex, targetRtti), CompAt(elemIndex, rtti));
+                target.CopyTicks(targetElemIndex, targetCompIndex, *this, elemIndex, i);
             }
-            newRtti->MoveConstruct(newElem, srcRtti.Get(inSrcElem));
         }
-        return newElem;
+        outMovedEntity = EraseRow(elemIndex);
+        return targetElemIndex;
     }
 
-    Mirror::Any Archetype::EmplaceComp(Entity inEntity, CompClass inCompClass, const Mirror::Any& inCompRef) // NOLINT
+    Mirror::Any Archetype::EmplaceComp(ElemIndex inIndex, CompClass inCompClass, const Mirror::ArgumentList& inArgs) // NOLINT
     {
-        ElemPtr elem = ElemAt(entityMap.at(inEntity));
-        return GetCompRtti(inCompClass).MoveConstruct(elem, inCompRef);
+        const auto& rtti = GetCompRtti(inCompClass);
+        return inCompClass->InplaceNewDyn(CompAt(inIndex, rtti), inArgs);
     }
 
-    void Archetype::EraseElem(Entity inEntity)
+    void Archetype::MarkChange(ElemIndex inIndex, CompClass inCompClass, ChangeKind inKind, ChangeTick inTick)
+    {
+        SetTick(inIndex, CompIndex(inCompClass), inKind, inTick);
+    }
+
+    void Archetype::MarkChanges(ElemIndex inBegin, size_t inNum, CompClass inCompClass, ChangeKind inKind, ChangeTick inTick)
+    {
+        const auto compIndex = CompIndex(inCompClass);
+        for (auto i = inBegin; i < inBegin + inNum; i++) {
+            SetTick(i, compIndex, inKind, inTick);
+        }
+    }
+
+    Entity Archetype::EraseElem(ElemIndex inIndex)
     {
-        const auto elemIndex = entityMap.at(inEntity);
-        ElemPtr elem = ElemAt(elemIndex);
-        const auto lastElemIndex = count - 1;
-        const auto entityToLastElem = elemMap.at(lastElemIndex);
-        ElemPtr lastElem = ElemAt(lastElemIndex);
         for (const auto& rtti : rttiVec) {
-            rtti.MoveAssign(elem, rtti.Get(lastElem));
+            rtti.Destruct(CompAt(inIndex, rtti));
         }
-        entityMap.at(entityToLastElem) = elemIndex;
-        entityMap.erase(inEntity);
-        elemMap.at(elemIndex) = entityToLastElem;
-        elemMap.erase(lastElemIndex);
-        count--;
+        return EraseRow(inIndex);
     }
 
-    ElemPtr Archetype::GetElem(Entity inEntity) const
+    Mirror::Any Archetype::GetComp(ElemIndex inIndex, CompClass inCompClass)
     {
-        return ElemAt(entityMap.at(inEntity));
+        const auto& rtti = GetCompRtti(inCompClass);
+        return rtti.Get(CompAt(inIndex, rtti));
     }
 
-    Mirror::Any Archetype::GetComp(Entity inEntity, CompClass inCompClass)
+    Mirror::Any Archetype::GetComp(ElemIndex inIndex, CompClass inCompClass) const
     {
-        ElemPtr element = GetElem(inEntity);
-        return GetCompRtti(inCompClass).Get(element);
+        const auto& rtti = GetCompRtti(inCompClass);
+        return rtti.Get(CompAt(inIndex, rtti)).ConstRef();
     }
 
-    Mirror::Any Archetype::GetComp(Entity inEntity, CompClass inCompClass) const
+    Entity Archetype::GetEntity(ElemIndex inIndex) const
     {
-        ElemPtr element = GetElem(inEntity);
-        return GetCompRtti(inCompClass).Get(element).ConstRef();
+        Assert(inIndex < count);
+        return EntityAt(inIndex);
     }
 
     size_t Archetype::Count() const
@@ -219,6 +569,108 @@ namespace Runtime::Internal {
         return result;
     }
 
+    const ArchetypeEdge* Archetype::FindAddEdge(CompClass inClazz) const
+    {
+        for (const auto& edge : addEdges) {
+            if (edge.clazz == inClazz) {
+                return &edge;
+            }
+        }
+        return nullptr;
+    }
+
+    const ArchetypeEdge* Archetype::FindRemoveEdge(CompClass inClazz) const
+    {
+        for (const auto& edge : removeEdges) {
+            if (edge.clazz == inClazz) {
+                return &edge;
+            }
+        }
+        return nullptr;
+    }
+
+    const ArchetypeEdge& Archetype::EmplaceAddEdge(CompClass inClazz, Archetype& inTarget)
+    {
+        Assert(FindAddEdge(inClazz) == nullptr);
+        return addEdges.emplace_back(MakeEdge(inClazz, inTarget));
+    }
+
+    const ArchetypeEdge& Archetype::EmplaceRemoveEdge(CompClass inClazz, Archetype& inTarget)
+    {
+        Assert(FindRemoveEdge(inClazz) == nullptr);
+        return removeEdges.emplace_back(MakeEdge(inClazz, inTarget));
+    }
+
+    const ArchetypeEdge* Archetype::FindBundleEdge(ArchetypeId inTargetId) const
+    {
+        for (const auto& edge : bundleEdges) {
+            if (edge.target->Id() == inTargetId) {
+                return &edge;
+            }
+        }
+        return nullptr;
+    }
+
+    const ArchetypeEdge& Archetype::EmplaceBundleEdge(Archetype& inTarget)
+    {
+        Assert(FindBundleEdge(inTarget.Id()) == nullptr);
+        return bundleEdges.emplace_back(MakeEdge(nullptr, inTarget));
+    }
+
+    size_t Archetype::CompIndex(CompClass inClazz) const
+    {
+        Assert(rttiMap.contains(inClazz));
+        return rttiMap.at(inClazz);
+    }
+
+    size_t Archetype::ChunkCapacity() const
+    {
+        return chunkCapacity;
+    }
+
+    size_t Archetype::ChunkNum() const
+    {
+        return (count + chunkCapacity - 1) / chunkCapacity;
+    }
+
+    size_t Archetype::ChunkElemNum(size_t inChunkIndex) const
+    {
+        Assert(inChunkIndex < ChunkNum());
+        return std::min(chunkCapacity, count - inChunkIndex * chunkCapacity);
+    }
+
+    const Entity* Archetype::ChunkEntities(size_t inChunkIndex) const
+    {
+        return reinterpret_cast<const Entity*>(chunks[inChunkIndex].Get()->memory.data());
+    }
+
+    void* Archetype::ChunkColumn(size_t inChunkIndex, size_t inCompIndex)
+    {
+        return WritableChunk(inChunkIndex).memory.data() + rttiVec[inCompIndex].Offset();
+    }
+
+    const void* Archetype::ChunkColumn(size_t inChunkIndex, size_t inCompIndex) const
+    {
+        return chunks[inChunkIndex].Get()->memory.data() + rttiVec[inCompIndex].Offset();
+    }
+
+    void Archetype::DetachChunk(size_t inChunkIndex)
+    {
+        (void) WritableChunk(inChunkIndex);
+    }
+
+    const ChangeTick* Archetype::ChunkTicks(size_t inChunkIndex, size_t inCompIndex, ChangeKind inKind) const
+    {
+        const auto kindNum = static_cast<size_t>(ChangeKind::max);
+        return chunks[inChunkIndex].Get()->ticks.data() + (inCompIndex * kindNum + static_cast<size_t>(inKind)) * chunkCapacity;
+    }
+
+    ChangeTick Archetype::ChunkLatestTick(size_t inChunkIndex, size_t inCompIndex, ChangeKind inKind) const
+    {
+        const auto kindNum = static_cast<size_t>(ChangeKind::max);
+        return chunks[inChunkIndex].Get()->latestTicks[inCompIndex * kindNum + static_cast<size_t>(inKind)];
+    }
+
     const CompRtti* Archetype::FindCompRtti(CompClass clazz) const
     {
         const auto iter = rttiMap.find(clazz);
@@ -231,132 +683,440 @@ namespace Runtime::Internal {
         return rttiVec[rttiMap.at(clazz)];
     }
 
-    ElemPtr Archetype::ElemAt(std::vector<uint8_t>& inMemory, size_t inIndex) const // NOLINT
+    void Archetype::BuildChunkLayout()
+    {
+        size_t elemMemorySize = sizeof(Entity);
+        for (const auto& rtti : rttiVec) {
+            elemMemorySize += rtti.MemorySize();
+        }
+
+        // columns start at aligned offsets, so shrink the capacity until the padded layout fits into one chunk, an
+        // element larger than a chunk gets an oversized chunk that holds exactly one element
+        chunkCapacity = std::max(chunkSize / elemMemorySize, static_cast<size_t>(1));
+        while (true) {
+            size_t offset = Common::AlignUp<columnAlignment>(sizeof(Entity) * chunkCapacity);
+            for (auto& rtti : rttiVec) {
+                rtti.Bind(offset);
+                offset = Common::AlignUp<columnAlignment>(offset + rtti.MemorySize() * chunkCapacity);
+            }
+            chunkMemorySize = offset;
+
+            if (chunkMemorySize <= chunkSize || chunkCapacity == 1) {
+                break;
+            }
+            chunkCapacity--;
+        }
+    }
+
+    size_t Archetype::Capacity() const
     {
-        return inMemory.data() + (inIndex * elemSize);
+        return chunks.size() * chunkCapacity;
     }
 
-    ElemPtr Archetype::ElemAt(size_t inIndex) const
+    Archetype::Chunk::Chunk(std::shared_ptr<const std::vector<CompRtti>> inLayout, size_t inMemorySize, size_t inCapacity)
+        : layout(std::move(inLayout))
+        , elemNum(0)
+        , memory(inMemorySize)
+        , ticks(layout->size() * static_cast<size_t>(ChangeKind::max) * inCapacity, 0)
+        , latestTicks(layout->size() * static_cast<size_t>(ChangeKind::max), 0)
+        , shared(false)
     {
-        return ElemAt(const_cast<std::vector<uint8_t>&>(memory), inIndex);
     }
 
-    size_t Archetype::Capacity() const
+    Archetype::Chunk::~Chunk()
+    {
+        for (const auto& rtti : *layout) {
+            rtti.DestructRange(memory.data() + rtti.Offset(), elemNum);
+        }
+    }
+
+    ElemIndex Archetype::AllocateNewElemBack()
+    {
+        if (Count() == Capacity()) {
+            chunks.emplace_back(std::make_shared<Chunk>(chunkLayout, chunkMemorySize, chunkCapacity));
+        }
+        WritableChunk(count / chunkCapacity).elemNum++;
+        return count++;
+    }
+
+    Archetype::ChunkSlot::ChunkSlot(std::shared_ptr<Chunk> inOwner)
+        : owner(std::move(inOwner))
+        , pointer(owner.get())
+    {
+    }
+
+    Archetype::ChunkSlot::ChunkSlot(const ChunkSlot& inOther)
+        : owner(inOther.owner)
+        , pointer(owner.get())
+    {
+        owner->shared.store(true, std::memory_order_release);
+    }
+
+    Archetype::ChunkSlot::ChunkSlot(ChunkSlot&& inOther) noexcept
+        : owner(std::move(inOther.owner))
+        , pointer(owner.get())
+    {
+        inOther.pointer.store(nullptr, std::memory_order_relaxed);
+    }
+
+    Archetype::ChunkSlot& Archetype::ChunkSlot::operator=(const ChunkSlot& inOther)
+    {
+        if (this != &inOther) {
+            Reset(inOther.owner);
+            owner->shared.store(true, std::memory_order_release);
+        }
+        return *this;
+    }
+
+    Archetype::ChunkSlot& Archetype::ChunkSlot::operator=(ChunkSlot&& inOther) noexcept
     {
-        return memory.size() / elemSize;
+        if (this != &inOther) {
+            Reset(std::move(inOther.owner));
+            inOther.pointer.store(nullptr, std::memory_order_relaxed);
+        }
+        return *this;
+    }
+
+    Archetype::Chunk* Archetype::ChunkSlot::Get() const
+    {
+        return pointer.load(std::memory_order_acquire);
     }
 
-    void Archetype::Reserve(float inRatio)
+    void Archetype::ChunkSlot::Reset(std::shared_ptr<Chunk> inOwner)
     {
-        Assert(inRatio > 1.0f);
-        const size_t newCapacity = static_cast<size_t>(std::ceil(static_cast<float>(std::max(Capacity(), static_cast<size_t>(1))) * inRatio));
-        std::vector<uint8_t> newMemory(newCapacity * elemSize);
+        owner = std::move(inOwner);
+        pointer.store(owner.get(), std::memory_order_release);
+    }
 
-        for (auto i = 0; i < count; i++) {
-            for (const auto& rtti : rttiVec) {
-                void* dstElem = ElemAt(newMemory, i);
-                void* srcElem = ElemAt(i);
-                rtti.MoveConstruct(dstElem, rtti.Get(srcElem));
-                rtti.Destruct(srcElem);
+    Archetype::Chunk& Archetype::WritableChunk(size_t inChunkIndex)
+    {
+        // the writers of a system group may hit the same shared chunk in parallel, the first one to take the lock clones
+        // it and publishes the clone, the others see the slot moved on and write to the clone
+        auto& slot = chunks[inChunkIndex];
+        auto* chunk = slot.Get();
+        if (!chunk->shared.load(std::memory_order_acquire)) {
+            return *chunk;
+        }
+
+        std::scoped_lock lock(chunk->cloneMutex);
+        if (auto* current = slot.Get(); current != chunk) {
+            return *current;
+        }
+        if (slot.owner.use_count() == 1) {
+            chunk->shared.store(false, std::memory_order_release);
+            return *chunk;
+        }
+
+        auto clone = std::make_shared<Chunk>(chunkLayout, chunkMemorySize, chunkCapacity);
+        memcpy(clone->memory.data(), chunk->memory.data(), chunk->elemNum * sizeof(Entity));
+        for (const auto& rtti : rttiVec) {
+            rtti.CopyConstructRange(clone->memory.data() + rtti.Offset(), chunk->memory.data() + rtti.Offset(), chunk->elemNum);
+        }
+        clone->elemNum = chunk->elemNum;
+        clone->ticks = chunk->ticks;
+        clone->latestTicks = chunk->latestTicks;
+        // the copies still hold the old chunk, so it and its lock outlive this scope
+        slot.Reset(std::move(clone));
+        return *slot.Get();
+    }
+
+    void Archetype::ReleaseChunks()
+    {
+        count = 0;
+        chunks.clear();
+    }
+
+    Entity Archetype::EraseRow(ElemIndex inIndex)
+    {
+        // components of inIndex are already destructed or relocated, fill the hole with the last row
+        Entity movedEntity = entityNull;
+        const auto lastElemIndex = count - 1;
+        if (inIndex != lastElemIndex) {
+            movedEntity = EntityAt(lastElemIndex);
+            for (size_t i = 0; i < rttiVec.size(); i++) {
+                const auto& rtti = rttiVec[i];
+                rtti.Relocate(CompAt(inIndex, rtti), CompAt(lastElemIndex, rtti));
+                CopyTicks(inIndex, i, *this, lastElemIndex, i);
             }
+            EntityAt(inIndex) = movedEntity;
+        }
+        WritableChunk(lastElemIndex / chunkCapacity).elemNum--;
+        count--;
+
+        // keep at most one spare chunk around to avoid allocation ping-pong at a chunk boundary
+        if (chunks.size() > ChunkNum() + 1) {
+            chunks.pop_back();
         }
-        memory = std::move(newMemory);
+        return movedEntity;
     }
 
-    void* Archetype::AllocateNewElemBack()
+    ArchetypeEdge Archetype::MakeEdge(CompClass inClazz, Archetype& inTarget) const
     {
-        if (Count() == Capacity()) {
-            Reserve();
+        ArchetypeEdge result { inClazz, &inTarget, {} };
+        result.columnRemap.reserve(rttiVec.size());
+        for (const auto& rtti : rttiVec) {
+            const auto iter = inTarget.rttiMap.find(rtti.Class());
+            result.columnRemap.emplace_back(iter == inTarget.rttiMap.end() ? ArchetypeEdge::invalidCompIndex : iter->second);
         }
-        count++;
-        return ElemAt(count - 1);
+        return result;
+    }
+
+    Entity& Archetype::EntityAt(ElemIndex inIndex)
+    {
+        auto* entities = reinterpret_cast<Entity*>(WritableChunk(inIndex / chunkCapacity).memory.data());
+        return entities[inIndex % chunkCapacity];
+    }
+
+    const Entity& Archetype::EntityAt(ElemIndex inIndex) const
+    {
+        return ChunkEntities(inIndex / chunkCapacity)[inIndex % chunkCapacity];
+    }
+
+    CompPtr Archetype::CompAt(ElemIndex inIndex, const CompRtti& inRtti)
+    {
+        auto* column = WritableChunk(inIndex / chunkCapacity).memory.data() + inRtti.Offset();
+        return column + (inIndex % chunkCapacity) * inRtti.MemorySize();
+    }
+
+    CompPtr Archetype::CompAt(ElemIndex inIndex, const CompRtti& inRtti) const
+    {
+        // read only, the pointer is only non-const to fit Mirror::Any
+        auto* column = const_cast<uint8_t*>(chunks[inIndex / chunkCapacity].Get()->memory.data()) + inRtti.Offset();
+        return column + (inIndex % chunkCapacity) * inRtti.MemorySize();
+    }
+
+    ChangeTick Archetype::TickAt(ElemIndex inIndex, size_t inCompIndex, ChangeKind inKind) const
+    {
+        return ChunkTicks(inIndex / chunkCapacity, inCompIndex, inKind)[inIndex % chunkCapacity];
+    }
+
+    void Archetype::SetTick(ElemIndex inIndex, size_t inCompIndex, ChangeKind inKind, ChangeTick inTick)
+    {
+        // the latest tick of a chunk only grows, rows leaving the chunk keep it conservative, never wrong
+        auto& chunk = WritableChunk(inIndex / chunkCapacity);
+        const auto tickColumn = inCompIndex * static_cast<size_t>(ChangeKind::max) + static_cast<size_t>(inKind);
+        chunk.ticks[tickColumn * chunkCapacity + inIndex % chunkCapacity] = inTick;
+        chunk.latestTicks[tickColumn] = std::max(chunk.latestTicks[tickColumn], inTick);
+    }
+
+    void Archetype::CopyTicks(ElemIndex inIndex, size_t inCompIndex, const Archetype& inSrc, ElemIndex inSrcIndex, size_t inSrcCompIndex)
+    {
+        SetTick(inIndex, inCompIndex, ChangeKind::added, inSrc.TickAt(inSrcIndex, inSrcCompIndex, ChangeKind::added));
+        SetTick(inIndex, inCompIndex, ChangeKind::changed, inSrc.TickAt(inSrcIndex, inSrcCompIndex, ChangeKind::changed));
     }
 
     EntityPool::EntityPool()
-        : counter(1)
+        : freeHead(0)
     {
+        Clear();
     }
 
     size_t EntityPool::Count() const
     {
-        return allocated.size();
+        return dense.size();
     }
 
     bool EntityPool::Valid(Entity inEntity) const
     {
-        return allocated.contains(inEntity);
+        const auto index = EntityIndex(inEntity);
+        return index != 0
+            && index < slots.size()
+            && slots[index].entity == inEntity
+            && slots[index].denseIndex != invalidIndex;
     }
 
     Entity EntityPool::Allocate()
     {
-        Entity result = entityNull;
-        if (!free.empty()) {
-            result = *free.begin();
-            free.erase(result);
-        } else {
-            result = counter++;
+        if (freeHead == 0) {
+            GrowSlots(static_cast<uint32_t>(slots.size()) + 1);
         }
-        allocated.emplace(result);
-        SetArchetype(result, 0);
-        return result;
+        const auto index = freeHead;
+        return dense[Claim(index, slots[index].entity)];
     }
 
     void EntityPool::Allocate(Entity inEntity)
     {
-        if (inEntity < counter) {
-            Assert(free.contains(inEntity));
-            free.erase(inEntity);
-        } else {
-            for (uint32_t i = counter; i < inEntity; i++) {
-                free.emplace(i);
+        const auto index = EntityIndex(inEntity);
+        Assert(index != 0);
+        if (index >= slots.size()) {
+            GrowSlots(index + 1);
+        }
+        Assert(slots[index].denseIndex == invalidIndex);
+        Claim(index, inEntity);
+    }
+
+    void EntityPool::Free(Entity inEntity)
+    {
+        Assert(Valid(inEntity));
+        const auto index = EntityIndex(inEntity);
+        auto& slot = slots[index];
+
+        const auto lastEntity = dense.back();
+        dense[slot.denseIndex] = lastEntity;
+        slots[EntityIndex(lastEntity)].denseIndex = slot.denseIndex;
+        dense.pop_back();
+
+        slot.entity = MakeEntity(index, EntityGeneration(inEntity) + 1);
+        slot.denseIndex = invalidIndex;
+        slot.record = { nullptr, 0 };
+        LinkFree(index);
+    }
+
+    void EntityPool::Clear()
+    {
+        slots.clear();
+        dense.clear();
+        freeHead = 0;
+        // slot 0 is reserved for entityNull and never linked into the free list
+        slots.emplace_back(Slot { entityNull, invalidIndex, 0, 0, { nullptr, 0 } });
+    }
+
+    void EntityPool::Each(const EntityTraverseFunc& inFunc) const
+    {
+        for (const auto& entity : dense) {
+            inFunc(entity);
+        }
+    }
+
+    EntityRecord& EntityPool::GetRecord(Entity inEntity)
+    {
+        Assert(Valid(inEntity));
+        return slots[EntityIndex(inEntity)].record;
+    }
+
+    const EntityRecord& EntityPool::GetRecord(Entity inEntity) const
+    {
+        Assert(Valid(inEntity));
+        return slots[EntityIndex(inEntity)].record;
+    }
+
+    void EntityPool::RebindArchetypes(std::unordered_map<ArchetypeId, Archetype>& inArchetypes)
+    {
+        // every row belongs to exactly one record, walking the rows saves a map lookup per entity
+        for (auto& archetype : inArchetypes | std::views::values) {
+            for (size_t chunkIndex = 0; chunkIndex < archetype.ChunkNum(); chunkIndex++) {
+                const auto* entities = archetype.ChunkEntities(chunkIndex);
+                for (size_t i = 0; i < archetype.ChunkElemNum(chunkIndex); i++) {
+                    slots[EntityIndex(entities[i])].record.archetype = &archetype;
+                }
             }
-            counter = inEntity + 1;
         }
-        allocated.emplace(inEntity);
-        SetArchetype(inEntity, 0);
     }
 
-    void EntityPool::Free(Entity inEntity)
+    void EntityPool::GrowSlots(uint32_t inSlotNum)
+    {
+        Assert(inSlotNum - 1 <= entityIndexMask);
+        const auto oldSlotNum = static_cast<uint32_t>(slots.size());
+        slots.reserve(inSlotNum);
+        // link the new slots in reverse so the lowest index is popped first
+        for (auto i = oldSlotNum; i < inSlotNum; i++) {
+            slots.emplace_back(Slot { MakeEntity(i, 0), invalidIndex, 0, 0, { nullptr, 0 } });
+        }
+        for (auto i = inSlotNum; i > oldSlotNum; i--) {
+            LinkFree(i - 1);
+        }
+    }
+
+    void EntityPool::LinkFree(uint32_t inIndex)
+    {
+        auto& slot = slots[inIndex];
+        slot.prevFree = 0;
+        slot.nextFree = freeHead;
+        if (freeHead != 0) {
+            slots[freeHead].prevFree = inIndex;
+        }
+        freeHead = inIndex;
+    }
+
+    void EntityPool::UnlinkFree(uint32_t inIndex)
+    {
+        auto& slot = slots[inIndex];
+        if (slot.prevFree != 0) {
+            slots[slot.prevFree].nextFree = slot.nextFree;
+        } else {
+            Assert(freeHead == inIndex);
+            freeHead = slot.nextFree;
+        }
+        if (slot.nextFree != 0) {
+            slots[slot.nextFree].prevFree = slot.prevFree;
+        }
+        slot.prevFree = 0;
+        slot.nextFree = 0;
+    }
+
+    uint32_t EntityPool::Claim(uint32_t inIndex, Entity inEntity)
+    {
+        UnlinkFree(inIndex);
+        auto& slot = slots[inIndex];
+        slot.entity = inEntity;
+        slot.denseIndex = static_cast<uint32_t>(dense.size());
+        slot.record = { nullptr, 0 };
+        dense.emplace_back(inEntity);
+        return slot.denseIndex;
+    }
+
+    EntityPool::ConstIter EntityPool::Begin() const
+    {
+        return dense.begin();
+    }
+
+    EntityPool::ConstIter EntityPool::End() const
+    {
+        return dense.end();
+    }
+
+    bool QueryKey::operator==(const QueryKey& inRhs) const
     {
-        Assert(Valid(inEntity));
-        allocated.erase(inEntity);
-        free.emplace(inEntity);
-        archetypeMap.erase(inEntity);
+        return includes == inRhs.includes && excludes == inRhs.excludes;
     }
 
-    void EntityPool::Clear()
+    size_t QueryKeyHash::operator()(const QueryKey& inKey) const
     {
-        counter = 1;
-        free.clear();
-        allocated.clear();
-        archetypeMap.clear();
+        const auto includesHash = Common::HashUtils::CityHash(inKey.includes.data(), inKey.includes.size() * sizeof(CompClass));
+        const auto excludesHash = Common::HashUtils::CityHash(inKey.excludes.data(), inKey.excludes.size() * sizeof(CompClass));
+        return includesHash * 31 + excludesHash;
     }
 
-    void EntityPool::Each(const EntityTraverseFunc& inFunc) const
+    Query::Query(const QueryKey& inKey)
+        : includes(inKey.includes)
+        , evaluatedNum(0)
     {
-        for (const auto& entity : allocated) {
-            inFunc(entity);
+        for (const auto* clazz : inKey.includes) {
+            includeMask.Set(clazz);
+        }
+        for (const auto* clazz : inKey.excludes) {
+            excludeMask.Set(clazz);
         }
     }
 
-    void EntityPool::SetArchetype(Entity inEntity, ArchetypeId inArchetypeId)
+    void Query::Update(const std::vector<Archetype*>& inArchetypes)
     {
-        archetypeMap[inEntity] = inArchetypeId;
+        for (; evaluatedNum < inArchetypes.size(); evaluatedNum++) {
+            auto* archetype = inArchetypes[evaluatedNum];
+            if (!archetype->ContainsAll(includeMask) || !archetype->NotContainsAny(excludeMask)) {
+                continue;
+            }
+
+            matches.emplace_back(archetype);
+            for (const auto* clazz : includes) {
+                columns.emplace_back(archetype->CompIndex(clazz));
+            }
+        }
     }
 
-    ArchetypeId EntityPool::GetArchetype(Entity inEntity) const
+    size_t Query::MatchNum() const
     {
-        return archetypeMap.at(inEntity);
+        return matches.size();
     }
 
-    EntityPool::ConstIter EntityPool::Begin() const
+    Archetype* Query::GetMatch(size_t inMatchIndex) const
     {
-        return allocated.begin();
+        return matches[inMatchIndex];
     }
 
-    EntityPool::ConstIter EntityPool::End() const
+    const size_t* Query::GetColumns(size_t inMatchIndex) const
     {
-        return allocated.end();
+        return columns.data() + inMatchIndex * includes.size();
     }
 
     SystemFactory::SystemFactory(SystemClass inClass)
@@ -402,6 +1162,55 @@ namespace Runtime::Internal {
             arguments.emplace(id.name, member.GetDyn(clazz->GetDefaultObject()));
         }
     }
+
+    static thread_local const SystemAccess* currentAccess = nullptr;
+
+    ScopedAccessCheck::ScopedAccessCheck(const SystemAccess* inAccess)
+        : lastAccess(currentAccess)
+    {
+        currentAccess = inAccess;
+    }
+
+    ScopedAccessCheck::~ScopedAccessCheck()
+    {
+        currentAccess = lastAccess;
+    }
+
+    void CheckCompAccess(CompClass inClass, bool inWrite)
+    {
+        if (currentAccess == nullptr || !currentAccess->Declared()) {
+            return;
+        }
+        AssertWithReason(inWrite ? currentAccess->CanWrite(inClass) : currentAccess->CanRead(inClass), "system accesses a component out of its declared access");
+    }
+
+    void CheckStructuralAccess()
+    {
+        if (currentAccess == nullptr || !currentAccess->Declared()) {
+            return;
+        }
+        AssertWithReason(currentAccess->IsExclusive(), "structural change from a system without exclusive access, record it into ECRegistry::Commands() instead");
+    }
+
+    void ParallelFor(size_t inTaskNum, const std::function<void(size_t)>& inTask)
+    {
+        auto& gameWorkers = GameWorkerThreads::Get();
+        if (inTaskNum <= 1 || !gameWorkers.Started()) {
+            for (size_t i = 0; i < inTaskNum; i++) {
+                inTask(i);
+            }
+            return;
+        }
+
+        // the batches belong to the calling system, they may run on a worker which is co-running another system
+        // a system calling this may itself run on a game worker, the pool's wait executes tasks before blocking, so
+        // the worker helps with the batches rather than starving the pool
+        const auto* callerAccess = currentAccess;
+        gameWorkers.ParallelFor(0, inTaskNum, 1, [&](size_t inIndex) -> void {
+            ScopedAccessCheck accessCheck(callerAccess);
+            inTask(inIndex);
+        });
+    }
 } // namespace Runtime::Internal
 
 namespace Runtime {
@@ -629,9 +1438,171 @@ namespace Runtime {
         return removedObserver;
     }
 
+    EntityCommandBuffer::EntityCommandBuffer()
+        : id(0)
+        , deferredEntityCounter(0)
+        , sequenceCounter(0)
+    {
+        ResetStreams();
+    }
+
+    EntityCommandBuffer::~EntityCommandBuffer() = default;
+
+    DeferredEntity EntityCommandBuffer::Create()
+    {
+        const DeferredEntity result { deferredEntityCounter++ };
+        Record(CommandType::create, true, result.index, nullptr, {});
+        return result;
+    }
+
+    void EntityCommandBuffer::Destroy(Entity inEntity)
+    {
+        Record(CommandType::destroy, false, inEntity, nullptr, {});
+    }
+
+    void EntityCommandBuffer::EmplaceDyn(CompClass inClass, Entity inEntity, const Mirror::ArgumentList& inArgs)
+    {
+        Record(CommandType::emplace, false, inEntity, inClass, inClass->ConstructDyn(inArgs));
+    }
+
+    void EntityCommandBuffer::EmplaceDyn(CompClass inClass, DeferredEntity inEntity, const Mirror::ArgumentList& inArgs)
+    {
+        Record(CommandType::emplace, true, inEntity.index, inClass, inClass->ConstructDyn(inArgs));
+    }
+
+    void EntityCommandBuffer::RemoveDyn(CompClass inClass, Entity inEntity)
+    {
+        Record(CommandType::remove, false, inEntity, inClass, {});
+    }
+
+    bool EntityCommandBuffer::Empty() const
+    {
+        std::unique_lock lock(mutex);
+        for (const auto& stream : streams | std::views::values) {
+            if (!stream.empty()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void EntityCommandBuffer::Clear()
+    {
+        std::unique_lock lock(mutex);
+        ResetStreams();
+    }
+
+    void EntityCommandBuffer::Playback(ECRegistry& inRegistry)
+    {
+        std::vector<Command> commands;
+        {
+            std::unique_lock lock(mutex);
+            size_t commandNum = 0;
+            for (const auto& stream : streams | std::views::values) {
+                commandNum += stream.size();
+            }
+            commands.reserve(commandNum);
+            for (auto& stream : streams | std::views::values) {
+                std::ranges::move(stream, std::back_inserter(commands));
+            }
+            ResetStreams();
+        }
+
+        // real entities first, then deferred ones, each entity's commands stay in recording order
+        std::ranges::sort(commands, [](const Command& inLhs, const Command& inRhs) -> bool {
+            return std::tie(inLhs.deferred, inLhs.target, inLhs.sequence) < std::tie(inRhs.deferred, inRhs.target, inRhs.sequence);
+        });
+
+        std::vector<CompClass> bundleClasses;
+        std::vector<Mirror::ArgumentList> bundleArgs;
+        for (auto begin = commands.begin(); begin != commands.end();) {
+            const auto end = std::find_if(begin, commands.end(), [&](const Command& inCommand) -> bool {
+                return inCommand.deferred != begin->deferred || inCommand.target != begin->target;
+            });
+
+            Entity entity = begin->deferred ? entityNull : begin->target;
+            const auto flushBundle = [&]() -> void {
+                if (!bundleClasses.empty()) {
+                    inRegistry.EmplaceDynBundle(bundleClasses, entity, bundleArgs);
+                    bundleClasses.clear();
+                    bundleArgs.clear();
+                }
+            };
+
+            for (auto iter = begin; iter != end; ++iter) {
+                auto& command = *iter;
+                if (command.type == CommandType::create) {
+                    entity = inRegistry.Create();
+                } else if (command.type == CommandType::destroy) {
+                    // commands recorded after a destroy have nothing to apply to
+                    bundleClasses.clear();
+                    bundleArgs.clear();
+                    if (inRegistry.Valid(entity)) {
+                        inRegistry.Destroy(entity);
+                    }
+                    break;
+                } else if (command.type == CommandType::emplace) {
+                    // emplacing a pending class again replaces it, a bundle never holds a class twice
+                    Assert(entity != entityNull);
+                    const auto pending = std::ranges::find(bundleClasses, command.clazz);
+                    if (pending != bundleClasses.end()) {
+                        bundleArgs[pending - bundleClasses.begin()] = Mirror::ArgumentList { command.comp.Ref() };
+                    } else {
+                        bundleClasses.emplace_back(command.clazz);
+                        bundleArgs.emplace_back(Mirror::ArgumentList { command.comp.Ref() });
+                    }
+                } else if (command.type == CommandType::remove) {
+                    const auto pending = std::ranges::find(bundleClasses, command.clazz);
+                    if (pending != bundleClasses.end()) {
+                        bundleArgs.erase(bundleArgs.begin() + (pending - bundleClasses.begin()));
+                        bundleClasses.erase(pending);
+                    } else {
+                        flushBundle();
+                        inRegistry.RemoveDyn(command.clazz, entity);
+                    }
+                } else {
+                    QuickFail();
+                }
+            }
+            flushBundle();
+            begin = end;
+        }
+    }
+
+    void EntityCommandBuffer::Record(CommandType inType, bool inDeferred, uint32_t inTarget, CompClass inClass, Mirror::Any&& inComp)
+    {
+        GetThreadStream().emplace_back(Command { inType, inDeferred, inTarget, sequenceCounter++, inClass, std::move(inComp) });
+    }
+
+    EntityCommandBuffer::Stream& EntityCommandBuffer::GetThreadStream()
+    {
+        // a thread keeps recording into the same buffer in most cases, so cache its stream and skip the lock, the buffer
+        // id changes whenever the streams are reset, which invalidates the cache
+        thread_local uint64_t cachedBufferId = 0;
+        thread_local Stream* cachedStream = nullptr;
+        if (cachedBufferId == id) {
+            return *cachedStream;
+        }
+
+        std::unique_lock lock(mutex);
+        auto& stream = streams[std::this_thread::get_id()];
+        cachedBufferId = id;
+        cachedStream = &stream;
+        return stream;
+    }
+
+    void EntityCommandBuffer::ResetStreams()
+    {
+        static std::atomic<uint64_t> bufferIdCounter = 1;
+        streams.clear();
+        id = bufferIdCounter++;
+        deferredEntityCounter = 0;
+    }
+
     ECRegistry::ECRegistry()
+        : changeTick(1)
     {
-        archetypes.emplace(0, Internal::Archetype({}));
+        EmplaceArchetype(0, {});
     }
 
     ECRegistry::~ECRegistry()
@@ -643,13 +1614,18 @@ namespace Runtime {
         : entities(inOther.entities)
         , globalComps(inOther.globalComps)
         , archetypes(inOther.archetypes)
+        , changeTick(inOther.changeTick.load())
     {
+        entities.RebindArchetypes(archetypes);
+        RebuildArchetypeList();
     }
 
     ECRegistry::ECRegistry(ECRegistry&& inOther) noexcept
         : entities(std::move(inOther.entities))
         , globalComps(std::move(inOther.globalComps))
         , archetypes(std::move(inOther.archetypes))
+        , archetypeList(std::move(inOther.archetypeList))
+        , changeTick(inOther.changeTick.load())
     {
     }
 
@@ -658,6 +1634,9 @@ namespace Runtime {
         entities = inOther.entities;
         globalComps = inOther.globalComps;
         archetypes = inOther.archetypes;
+        changeTick = inOther.changeTick.load();
+        entities.RebindArchetypes(archetypes);
+        RebuildArchetypeList();
         return *this;
     }
 
@@ -666,26 +1645,44 @@ namespace Runtime {
         entities = std::move(inOther.entities);
         globalComps = std::move(inOther.globalComps);
         archetypes = std::move(inOther.archetypes);
+        archetypeList = std::move(inOther.archetypeList);
+        changeTick = inOther.changeTick.load();
+        {
+            std::unique_lock lock(queryMutex);
+            queries.clear();
+        }
         return *this;
     }
 
     Entity ECRegistry::Create()
     {
+#if BUILD_CONFIG_DEBUG
+        Internal::CheckStructuralAccess();
+#endif
         const Entity result = entities.Allocate();
-        archetypes.at(entities.GetArchetype(result)).EmplaceElem(result);
+        auto& root = archetypes.at(0);
+        entities.GetRecord(result) = { &root, root.EmplaceElem(result) };
         return result;
     }
 
     void ECRegistry::Create(Entity inEntity)
     {
+#if BUILD_CONFIG_DEBUG
+        Internal::CheckStructuralAccess();
+#endif
         entities.Allocate(inEntity);
-        archetypes.at(entities.GetArchetype(inEntity)).EmplaceElem(inEntity);
+        auto& root = archetypes.at(0);
+        entities.GetRecord(inEntity) = { &root, root.EmplaceElem(inEntity) };
     }
 
     void ECRegistry::Destroy(Entity inEntity)
     {
+#if BUILD_CONFIG_DEBUG
+        Internal::CheckStructuralAccess();
+#endif
         Assert(Valid(inEntity));
-        archetypes.at(entities.GetArchetype(inEntity)).EraseElem(inEntity);
+        const auto& record = entities.GetRecord(inEntity);
+        FixMovedRecord(record.archetype->EraseElem(record.elemIndex), record.elemIndex);
         entities.Free(inEntity);
     }
 
@@ -704,7 +1701,13 @@ namespace Runtime {
         entities.Clear();
         globalComps.clear();
         archetypes.clear();
-        archetypes.emplace(0, Internal::Archetype({}));
+        archetypeList.clear();
+        {
+            std::unique_lock lock(queryMutex);
+            queries.clear();
+        }
+        EmplaceArchetype(0, {});
+        commandBuffer.Clear();
     }
 
     void ECRegistry::Each(const EntityTraverseFunc& inFunc) const
@@ -734,8 +1737,7 @@ namespace Runtime {
 
     void ECRegistry::CompEach(Entity inEntity, const CompTraverseFunc& inFunc) const
     {
-        const Internal::ArchetypeId archetypeId = entities.GetArchetype(inEntity);
-        const Internal::Archetype& archetype = archetypes.at(archetypeId);
+        const Internal::Archetype& archetype = *entities.GetRecord(inEntity).archetype;
         for (const auto& compRtti : archetype.GetRttiVec()) {
             inFunc(compRtti.Class());
         }
@@ -743,8 +1745,7 @@ namespace Runtime {
 
     size_t ECRegistry::CompCount(Entity inEntity) const
     {
-        const Internal::ArchetypeId archetypeId = entities.GetArchetype(inEntity);
-        const Internal::Archetype& archetype = archetypes.at(archetypeId);
+        const Internal::Archetype& archetype = *entities.GetRecord(inEntity).archetype;
         return archetype.GetRttiVec().size();
     }
 
@@ -768,8 +1769,95 @@ namespace Runtime {
         return Runtime::EventsObserverDyn { *this, inClass };
     }
 
+    const Internal::ArchetypeEdge& ECRegistry::GetAddEdge(Internal::Archetype& inArchetype, CompClass inClass)
+    {
+        if (const auto* edge = inArchetype.FindAddEdge(inClass)) {
+            return *edge;
+        }
+
+        const Internal::ArchetypeId newArchetypeId = inArchetype.Id() + inClass->GetTypeInfo()->id;
+        const auto iter = archetypes.find(newArchetypeId);
+        auto& newArchetype = iter != archetypes.end()
+            ? iter->second
+            : EmplaceArchetype(newArchetypeId, inArchetype.NewRttiVecByAdd(Internal::CompRtti(inClass)));
+        if (newArchetype.FindRemoveEdge(inClass) == nullptr) {
+            newArchetype.EmplaceRemoveEdge(inClass, inArchetype);
+        }
+        return inArchetype.EmplaceAddEdge(inClass, newArchetype);
+    }
+
+    const Internal::ArchetypeEdge& ECRegistry::GetRemoveEdge(Internal::Archetype& inArchetype, CompClass inClass)
+    {
+        if (const auto* edge = inArchetype.FindRemoveEdge(inClass)) {
+            return *edge;
+        }
+
+        const Internal::ArchetypeId newArchetypeId = inArchetype.Id() - inClass->GetTypeInfo()->id;
+        const auto iter = archetypes.find(newArchetypeId);
+        auto& newArchetype = iter != archetypes.end()
+            ? iter->second
+            : EmplaceArchetype(newArchetypeId, inArchetype.NewRttiVecByRemove(Internal::CompRtti(inClass)));
+        if (newArchetype.FindAddEdge(inClass) == nullptr) {
+            newArchetype.EmplaceAddEdge(inClass, inArchetype);
+        }
+        return inArchetype.EmplaceRemoveEdge(inClass, newArchetype);
+    }
+
+    Internal::Archetype& ECRegistry::EmplaceArchetype(Internal::ArchetypeId inId, const std::vector<Internal::CompRtti>& inRttiVec)
+    {
+        auto& archetype = archetypes.emplace(inId, Internal::Archetype(inRttiVec)).first->second;
+        Assert(archetype.Id() == inId);
+        archetypeList.emplace_back(&archetype);
+        return archetype;
+    }
+
+    void ECRegistry::RebuildArchetypeList()
+    {
+        archetypeList.clear();
+        archetypeList.reserve(archetypes.size());
+        for (auto& archetype : archetypes | std::views::values) {
+            archetypeList.emplace_back(&archetype);
+        }
+        std::unique_lock lock(queryMutex);
+        queries.clear();
+    }
+
+    Internal::Query& ECRegistry::FindOrAddQuery(const Internal::QueryKey& inKey) const
+    {
+        auto iter = queries.find(inKey);
+        if (iter == queries.end()) {
+            iter = queries.emplace(inKey, Internal::Query(inKey)).first;
+        }
+        iter->second.Update(archetypeList);
+        return iter->second;
+    }
+
+    Internal::EntityRecord& ECRegistry::MigrateEntity(Entity inEntity, const Internal::ArchetypeEdge& inEdge)
+    {
+        auto& record = entities.GetRecord(inEntity);
+        Entity movedEntity;
+        const auto newElemIndex = record.archetype->MoveElem(record.elemIndex, inEdge, movedEntity);
+        FixMovedRecord(movedEntity, record.elemIndex);
+        record = { inEdge.target, newElemIndex };
+        return record;
+    }
+
+    void ECRegistry::FixMovedRecord(Entity inMovedEntity, Internal::ElemIndex inElemIndex)
+    {
+        // the last row of an archetype was relocated into the erased row, so its owner record must follow
+        if (inMovedEntity != entityNull) {
+            entities.GetRecord(inMovedEntity).elemIndex = inElemIndex;
+        }
+    }
+
     void ECRegistry::NotifyUpdatedDyn(CompClass inClass, Entity inEntity)
     {
+#if BUILD_CONFIG_DEBUG
+        Internal::CheckCompAccess(inClass, true);
+#endif
+        const auto& record = entities.GetRecord(inEntity);
+        record.archetype->MarkChange(record.elemIndex, inClass, ChangeKind::changed, changeTick);
+
         const auto iter = compEvents.find(inClass);
         if (iter == compEvents.end()) {
             return;
@@ -800,6 +1888,26 @@ namespace Runtime {
         return Runtime::Observer { *this };
     }
 
+    EntityCommandBuffer& ECRegistry::Commands()
+    {
+        return commandBuffer;
+    }
+
+    void ECRegistry::PlaybackCommands()
+    {
+        commandBuffer.Playback(*this);
+    }
+
+    ChangeTick ECRegistry::GetChangeTick() const
+    {
+        return changeTick;
+    }
+
+    ChangeTick ECRegistry::IncChangeTick()
+    {
+        return ++changeTick;
+    }
+
     void ECRegistry::Save(ECArchive& outArchive) const
     {
         outArchive = {};
@@ -835,16 +1943,26 @@ namespace Runtime {
     {
         Clear();
 
+        std::vector<CompClass> compClasses;
+        std::vector<const std::vector<uint8_t>*> compDatas;
         for (const auto& [entity, entityArchive] : inArchive.entities) {
             Create(entity);
+
+            compClasses.clear();
+            compDatas.clear();
             for (const auto& [compClass, compData] : entityArchive.comps) {
                 if (compClass->IsTransient()) {
                     continue;
                 }
                 Assert(compClass->HasDefaultConstructor());
-                Mirror::Any compRef = EmplaceDyn(compClass, entity, {});
-                Common::MemoryDeserializeStream stream(compData);
-                compRef.Deserialize(stream);
+                compClasses.emplace_back(compClass);
+                compDatas.emplace_back(&compData);
+            }
+
+            const auto compRefs = EmplaceDynBundle(compClasses, entity, std::vector<Mirror::ArgumentList>(compClasses.size()));
+            for (size_t i = 0; i < compRefs.size(); i++) {
+                Common::MemoryDeserializeStream stream(*compDatas[i]);
+                compRefs[i].Deserialize(stream);
             }
         }
 
@@ -859,6 +1977,274 @@ namespace Runtime {
         }
     }
 
+    void ECRegistry::SaveColumnar(std::vector<uint8_t>& outBytes) const
+    {
+        std::vector<CompClass> schemas;
+        std::unordered_map<CompClass, uint32_t> schemaIndices;
+        const auto getSchemaIndex = [&](CompClass inClass) -> uint32_t {
+            const auto [iter, inserted] = schemaIndices.emplace(inClass, static_cast<uint32_t>(schemas.size()));
+            if (inserted) {
+                schemas.emplace_back(inClass);
+            }
+            return iter->second;
+        };
+
+        // the schema table is only known after walking all the columns, so the body is written first
+        std::vector<uint8_t> body;
+        std::vector<size_t> compIndices;
+        uint32_t archetypeNum = 0;
+        for (const auto* archetype : archetypeList) {
+            if (archetype->Count() == 0) {
+                continue;
+            }
+            const auto& rttiVec = archetype->GetRttiVec();
+            compIndices.clear();
+            for (size_t i = 0; i < rttiVec.size(); i++) {
+                if (!rttiVec[i].Class()->IsTransient()) {
+                    compIndices.emplace_back(i);
+                }
+            }
+
+            Internal::ColumnarWrite(body, static_cast<uint32_t>(compIndices.size()));
+            Internal::ColumnarWrite(body, static_cast<uint32_t>(0));
+            Internal::ColumnarWrite(body, static_cast<uint64_t>(archetype->Count()));
+            for (const auto compIndex : compIndices) {
+                Internal::ColumnarWrite(body, getSchemaIndex(rttiVec[compIndex].Class()));
+            }
+            Internal::ColumnarWritePadding(body);
+            for (size_t chunk = 0; chunk < archetype->ChunkNum(); chunk++) {
+                Internal::ColumnarWriteBytes(body, archetype->ChunkEntities(chunk), archetype->ChunkElemNum(chunk) * sizeof(Entity));
+            }
+            Internal::ColumnarWritePadding(body);
+
+            for (const auto compIndex : compIndices) {
+                const auto& rtti = rttiVec[compIndex];
+                const auto blobSizeOffset = body.size();
+                Internal::ColumnarWrite(body, static_cast<uint64_t>(0));
+                Internal::ColumnarWritePadding(body);
+
+                const auto blobBegin = body.size();
+                if (rtti.Class()->GetTypeInfo()->triviallyCopyable) {
+                    for (size_t chunk = 0; chunk < archetype->ChunkNum(); chunk++) {
+                        Internal::ColumnarWriteBytes(body, archetype->ChunkColumn(chunk, compIndex), archetype->ChunkElemNum(chunk) * rtti.MemorySize());
+                    }
+                } else {
+                    Common::MemorySerializeStream stream(body, blobBegin);
+                    for (size_t chunk = 0; chunk < archetype->ChunkNum(); chunk++) {
+                        const auto* column = static_cast<const uint8_t*>(archetype->ChunkColumn(chunk, compIndex));
+                        for (size_t i = 0; i < archetype->ChunkElemNum(chunk); i++) {
+                            rtti.Get(const_cast<uint8_t*>(column) + i * rtti.MemorySize()).Serialize(stream);
+                        }
+                    }
+                }
+                const auto blobSize = static_cast<uint64_t>(body.size() - blobBegin);
+                memcpy(body.data() + blobSizeOffset, &blobSize, sizeof(uint64_t));
+                Internal::ColumnarWritePadding(body);
+            }
+            archetypeNum++;
+        }
+
+        uint32_t globalCompNum = 0;
+        GCompEach([&](GCompClass clazz) -> void {
+            if (clazz->IsTransient()) {
+                return;
+            }
+            Internal::ColumnarWrite(body, getSchemaIndex(clazz));
+            Internal::ColumnarWrite(body, static_cast<uint32_t>(0));
+            const auto blobSizeOffset = body.size();
+            Internal::ColumnarWrite(body, static_cast<uint64_t>(0));
+
+            const auto blobBegin = body.size();
+            Common::MemorySerializeStream stream(body, blobBegin);
+            GGetDyn(clazz).Serialize(stream);
+            const auto blobSize = static_cast<uint64_t>(body.size() - blobBegin);
+            memcpy(body.data() + blobSizeOffset, &blobSize, sizeof(uint64_t));
+            Internal::ColumnarWritePadding(body);
+            globalCompNum++;
+        });
+
+        outBytes.clear();
+        Internal::ColumnarWrite(outBytes, Internal::ColumnarHeader {
+            Internal::columnarMagic,
+            Internal::columnarVersion,
+            Internal::columnarByteOrderMark,
+            static_cast<uint32_t>(schemas.size()),
+            archetypeNum,
+            globalCompNum
+        });
+        for (const auto* clazz : schemas) {
+            const auto& name = clazz->GetName();
+            Internal::ColumnarWrite(outBytes, static_cast<uint32_t>(name.size()));
+            Internal::ColumnarWriteBytes(outBytes, name.data(), name.size());
+            Internal::ColumnarWrite(outBytes, static_cast<uint32_t>(clazz->SizeOf()));
+            Internal::ColumnarWrite(outBytes, static_cast<uint8_t>(clazz->GetTypeInfo()->triviallyCopyable));
+        }
+        Internal::ColumnarWritePadding(outBytes);
+        outBytes.insert(outBytes.end(), body.begin(), body.end());
+    }
+
+    bool ECRegistry::LoadColumnar(const uint8_t* inData, size_t inSize)
+    {
+#if BUILD_CONFIG_DEBUG
+        Internal::CheckStructuralAccess();
+#endif
+        // the header and the schema table are validated before the registry is touched, a snapshot of another byte order
+        // or component layout fails the load and leaves the registry as it is
+        Internal::ColumnarReader reader(inData, inSize);
+        const auto header = reader.Read<Internal::ColumnarHeader>();
+        if (reader.Failed() || header.magic != Internal::columnarMagic || header.version != Internal::columnarVersion || header.byteOrderMark != Internal::columnarByteOrderMark) {
+            return false;
+        }
+
+        std::vector<CompClass> schemas;
+        std::vector<bool> rawSchemas;
+        schemas.reserve(header.schemaNum);
+        rawSchemas.reserve(header.schemaNum);
+        for (uint32_t i = 0; i < header.schemaNum; i++) {
+            const auto nameSize = reader.Read<uint32_t>();
+            const auto* nameData = reader.ReadBytes(nameSize);
+            const auto memorySize = reader.Read<uint32_t>();
+            const auto raw = reader.Read<uint8_t>() != 0;
+            if (reader.Failed()) {
+                return false;
+            }
+
+            const auto* clazz = Mirror::Class::Find(Mirror::Id(std::string(reinterpret_cast<const char*>(nameData), nameSize)));
+            // raw columns are copied as they are, so the layout must not have changed since the snapshot was saved
+            if (clazz == nullptr || (raw && (!clazz->GetTypeInfo()->triviallyCopyable || clazz->SizeOf() != memorySize))) {
+                return false;
+            }
+            schemas.emplace_back(clazz);
+            rawSchemas.emplace_back(raw);
+        }
+        reader.SkipPadding();
+
+        Clear();
+        // from here on a failure means a truncated or corrupted body, the partially loaded registry is cleared again
+        const auto fail = [&]() -> bool {
+            Clear();
+            return false;
+        };
+
+        std::vector<uint32_t> schemaIndices;
+        std::vector<Internal::CompRtti> rttiVec;
+        for (uint32_t i = 0; i < header.archetypeNum; i++) {
+            const auto compNum = reader.Read<uint32_t>();
+            reader.Read<uint32_t>();
+            const auto rowNum = static_cast<size_t>(reader.Read<uint64_t>());
+
+            schemaIndices.clear();
+            rttiVec.clear();
+            Internal::ArchetypeId archetypeId = 0;
+            for (uint32_t j = 0; j < compNum && !reader.Failed(); j++) {
+                const auto schemaIndex = reader.Read<uint32_t>();
+                if (schemaIndex >= schemas.size()) {
+                    return fail();
+                }
+                schemaIndices.emplace_back(schemaIndex);
+                rttiVec.emplace_back(schemas[schemaIndex]);
+                archetypeId += schemas[schemaIndex]->GetTypeInfo()->id;
+            }
+            reader.SkipPadding();
+            const auto* rowEntities = reinterpret_cast<const Entity*>(reader.ReadBytes(rowNum * sizeof(Entity)));
+            if (reader.Failed()) {
+                return fail();
+            }
+
+            // transient components are not saved, so two archetypes of the snapshot may land in the same one
+            const auto iter = archetypes.find(archetypeId);
+            auto& archetype = iter != archetypes.end() ? iter->second : EmplaceArchetype(archetypeId, rttiVec);
+            const auto begin = archetype.EmplaceElems(rowEntities, rowNum);
+            for (size_t row = 0; row < rowNum; row++) {
+                const auto entity = archetype.GetEntity(begin + row);
+                entities.Allocate(entity);
+                entities.GetRecord(entity) = { &archetype, begin + row };
+            }
+            reader.SkipPadding();
+
+            for (const auto schemaIndex : schemaIndices) {
+                const auto* clazz = schemas[schemaIndex];
+                const auto blobSize = static_cast<size_t>(reader.Read<uint64_t>());
+                reader.SkipPadding();
+                const auto* blob = reader.ReadBytes(blobSize);
+                reader.SkipPadding();
+                if (reader.Failed()) {
+                    return fail();
+                }
+
+                const auto compIndex = archetype.CompIndex(clazz);
+                if (rawSchemas[schemaIndex]) {
+                    const auto memorySize = clazz->SizeOf();
+                    if (blobSize != rowNum * memorySize) {
+                        return fail();
+                    }
+                    const auto capacity = archetype.ChunkCapacity();
+                    for (auto row = begin; row < begin + rowNum;) {
+                        const auto elemNum = std::min(begin + rowNum - row, capacity - row % capacity);
+                        auto* column = static_cast<uint8_t*>(archetype.ChunkColumn(row / capacity, compIndex));
+                        memcpy(column + (row % capacity) * memorySize, blob + (row - begin) * memorySize, elemNum * memorySize);
+                        row += elemNum;
+                    }
+                } else {
+                    Assert(clazz->HasDefaultConstructor());
+                    Common::MemoryDeserializeStream stream(blob, blobSize);
+                    for (auto row = begin; row < begin + rowNum; row++) {
+                        archetype.EmplaceComp(row, clazz, {}).Deserialize(stream);
+                    }
+                }
+                archetype.MarkChanges(begin, rowNum, clazz, ChangeKind::added, changeTick);
+            }
+
+            for (const auto schemaIndex : schemaIndices) {
+                const auto eventsIter = compEvents.find(schemas[schemaIndex]);
+                if (eventsIter == compEvents.end()) {
+                    continue;
+                }
+                for (auto row = begin; row < begin + rowNum; row++) {
+                    eventsIter->second.onConstructed.Broadcast(*this, archetype.GetEntity(row));
+                }
+            }
+        }
+
+        for (uint32_t i = 0; i < header.globalCompNum; i++) {
+            const auto schemaIndex = reader.Read<uint32_t>();
+            reader.Read<uint32_t>();
+            const auto blobSize = static_cast<size_t>(reader.Read<uint64_t>());
+            const auto* blob = reader.ReadBytes(blobSize);
+            reader.SkipPadding();
+            if (reader.Failed() || schemaIndex >= schemas.size()) {
+                return fail();
+            }
+
+            const auto* clazz = schemas[schemaIndex];
+            Assert(clazz->HasDefaultConstructor());
+            Mirror::Any gCompRef = GEmplaceDyn(clazz, {});
+            Common::MemoryDeserializeStream stream(blob, blobSize);
+            gCompRef.Deserialize(stream);
+        }
+        return reader.End() ? true : fail();
+    }
+
+    void ECRegistry::SaveColumnarToFile(const std::string& inFileName) const
+    {
+        std::vector<uint8_t> bytes;
+        SaveColumnar(bytes);
+
+        if (const auto parentPath = Common::Path(inFileName).Parent();
+            !parentPath.Exists()) {
+            parentPath.MakeDir();
+        }
+        std::ofstream file(inFileName, std::ios::binary);
+        Assert(file.is_open());
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    bool ECRegistry::LoadColumnarFromFile(const std::string& inFileName)
+    {
+        const Common::MappedFile file(inFileName);
+        return file.IsValid() && LoadColumnar(file.Data(), file.Size());
+    }
+
     void ECRegistry::CheckEventsUnbound() const
     {
         for (const auto& events : compEvents | std::views::values) {
@@ -876,42 +2262,76 @@ namespace Runtime {
 
     Mirror::Any ECRegistry::EmplaceDyn(CompClass inClass, Entity inEntity, const Mirror::ArgumentList& inArgs)
     {
+#if BUILD_CONFIG_DEBUG
+        Internal::CheckStructuralAccess();
+#endif
         Assert(Valid(inEntity));
-        const Internal::ArchetypeId archetypeId = entities.GetArchetype(inEntity);
-        Internal::Archetype& archetype = archetypes.at(archetypeId);
+        const auto& record = MigrateEntity(inEntity, GetAddEdge(*entities.GetRecord(inEntity).archetype, inClass));
+        Mirror::Any compRef = record.archetype->EmplaceComp(record.elemIndex, inClass, inArgs);
+        record.archetype->MarkChange(record.elemIndex, inClass, ChangeKind::added, changeTick);
+        NotifyConstructedDyn(inClass, inEntity);
+        return compRef;
+    }
 
-        const Internal::ArchetypeId newArchetypeId = archetypeId + inClass->GetTypeInfo()->id;
-        entities.SetArchetype(inEntity, newArchetypeId);
+    std::vector<Mirror::Any> ECRegistry::EmplaceDynBundle(const std::vector<CompClass>& inClasses, Entity inEntity, const std::vector<Mirror::ArgumentList>& inArgs)
+    {
+#if BUILD_CONFIG_DEBUG
+        Internal::CheckStructuralAccess();
+#endif
+        Assert(Valid(inEntity) && inClasses.size() == inArgs.size());
+        if (inClasses.empty()) {
+            return {};
+        }
 
-        if (!archetypes.contains(newArchetypeId)) {
-            archetypes.emplace(newArchetypeId, Internal::Archetype(archetype.NewRttiVecByAdd(Internal::CompRtti(inClass))));
+        Internal::Archetype& archetype = *entities.GetRecord(inEntity).archetype;
+
+        Internal::ArchetypeId newArchetypeId = archetype.Id();
+        for (size_t i = 0; i < inClasses.size(); i++) {
+            Assert(!archetype.Contains(inClasses[i]) && std::find(inClasses.begin(), inClasses.begin() + i, inClasses[i]) == inClasses.begin() + i);
+            newArchetypeId += inClasses[i]->GetTypeInfo()->id;
         }
-        Internal::Archetype& newArchetype = archetypes.at(newArchetypeId);
-        newArchetype.EmplaceElem(inEntity, archetype.GetElem(inEntity), archetype.GetRttiVec());
-        archetype.EraseElem(inEntity);
 
-        Mirror::Any tempObj = inClass->ConstructDyn(inArgs);
-        Mirror::Any compRef = newArchetype.EmplaceComp(inEntity, inClass, tempObj.Ref());
-        NotifyConstructedDyn(inClass, inEntity);
-        return compRef;
+        // the edge of a bundle signature is resolved once per source archetype like the single add edges
+        const auto* edge = archetype.FindBundleEdge(newArchetypeId);
+        if (edge == nullptr) {
+            Internal::Archetype* newArchetype;
+            if (const auto iter = archetypes.find(newArchetypeId);
+                iter != archetypes.end()) {
+                newArchetype = &iter->second;
+            } else {
+                auto rttiVec = archetype.GetRttiVec();
+                rttiVec.reserve(rttiVec.size() + inClasses.size());
+                for (const auto* clazz : inClasses) {
+                    rttiVec.emplace_back(clazz);
+                }
+                newArchetype = &EmplaceArchetype(newArchetypeId, rttiVec);
+            }
+            edge = &archetype.EmplaceBundleEdge(*newArchetype);
+        }
+        Internal::Archetype* newArchetype = edge->target;
+        const auto& record = MigrateEntity(inEntity, *edge);
+
+        std::vector<Mirror::Any> result;
+        result.reserve(inClasses.size());
+        for (size_t i = 0; i < inClasses.size(); i++) {
+            result.emplace_back(newArchetype->EmplaceComp(record.elemIndex, inClasses[i], inArgs[i]));
+            newArchetype->MarkChange(record.elemIndex, inClasses[i], ChangeKind::added, changeTick);
+        }
+        for (const auto* clazz : inClasses) {
+            NotifyConstructedDyn(clazz, inEntity);
+        }
+        return result;
     }
 
     void ECRegistry::RemoveDyn(CompClass inClass, Entity inEntity)
     {
+#if BUILD_CONFIG_DEBUG
+        Internal::CheckStructuralAccess();
+#endif
         Assert(Valid(inEntity) && HasDyn(inClass, inEntity));
-        const Internal::ArchetypeId archetypeId = entities.GetArchetype(inEntity);
-        Internal::Archetype& archetype = archetypes.at(archetypeId);
-
-        const Internal::ArchetypeId newArchetypeId = archetypeId - inClass->GetTypeInfo()->id;
-        entities.SetArchetype(inEntity, newArchetypeId);
-
-        if (!archetypes.contains(newArchetypeId)) {
-            archetypes.emplace(newArchetypeId, Internal::Archetype(archetype.NewRttiVecByRemove(Internal::CompRtti(inClass))));
-        }
         NotifyRemoveDyn(inClass, inEntity);
-        Internal::Archetype& newArchetype = archetypes.at(newArchetypeId);
-        newArchetype.EmplaceElem(inEntity, archetype.GetElem(inEntity), archetype.GetRttiVec());
-        archetype.EraseElem(inEntity);
+
+        MigrateEntity(inEntity, GetRemoveEdge(*entities.GetRecord(inEntity).archetype, inClass));
     }
 
     void ECRegistry::UpdateDyn(CompClass inClass, Entity inEntity, const DynUpdateFunc& inFunc)
@@ -929,10 +2349,11 @@ namespace Runtime {
 
     bool ECRegistry::HasDyn(CompClass inClass, Entity inEntity) const
     {
+#if BUILD_CONFIG_DEBUG
+        Internal::CheckCompAccess(inClass, false);
+#endif
         Assert(Valid(inEntity));
-        return archetypes
-            .at(entities.GetArchetype(inEntity))
-            .Contains(inClass);
+        return entities.GetRecord(inEntity).archetype->Contains(inClass);
     }
 
     Mirror::Any ECRegistry::FindDyn(CompClass inClass, Entity inEntity)
@@ -947,19 +2368,23 @@ namespace Runtime {
 
     Mirror::Any ECRegistry::GetDyn(CompClass inClass, Entity inEntity)
     {
+#if BUILD_CONFIG_DEBUG
+        Internal::CheckCompAccess(inClass, false);
+#endif
         Assert(Valid(inEntity) && HasDyn(inClass, inEntity));
-        Mirror::Any compRef = archetypes
-            .at(entities.GetArchetype(inEntity))
-            .GetComp(inEntity, inClass);
+        const auto& record = entities.GetRecord(inEntity);
+        Mirror::Any compRef = record.archetype->GetComp(record.elemIndex, inClass);
         return compRef;
     }
 
     Mirror::Any ECRegistry::GetDyn(CompClass inClass, Entity inEntity) const
     {
+#if BUILD_CONFIG_DEBUG
+        Internal::CheckCompAccess(inClass, false);
+#endif
         Assert(Valid(inEntity) && HasDyn(inClass, inEntity));
-        Mirror::Any compRef = archetypes
-            .at(entities.GetArchetype(inEntity))
-            .GetComp(inEntity, inClass);
+        const auto& record = entities.GetRecord(inEntity);
+        Mirror::Any compRef = std::as_const(*record.archetype).GetComp(record.elemIndex, inClass);
         return compRef.ConstRef();
     }
 
@@ -970,6 +2395,9 @@ namespace Runtime {
 
     void ECRegistry::GNotifyUpdatedDyn(GCompClass inClass)
     {
+#if BUILD_CONFIG_DEBUG
+        Internal::CheckCompAccess(inClass, true);
+#endif
         const auto iter = globalCompEvents.find(inClass);
         if (iter == globalCompEvents.end()) {
             return;
@@ -997,6 +2425,9 @@ namespace Runtime {
 
     Mirror::Any ECRegistry::GEmplaceDyn(GCompClass inClass, const Mirror::ArgumentList& inArgs)
     {
+#if BUILD_CONFIG_DEBUG
+        Internal::CheckStructuralAccess();
+#endif
         Assert(Internal::IsGlobalCompClass(inClass));
         Assert(!GHasDyn(inClass));
         globalComps.emplace(inClass, inClass->ConstructDyn(inArgs));
@@ -1006,6 +2437,9 @@ namespace Runtime {
 
     void ECRegistry::GRemoveDyn(GCompClass inClass)
     {
+#if BUILD_CONFIG_DEBUG
+        Internal::CheckStructuralAccess();
+#endif
         Assert(Internal::IsGlobalCompClass(inClass));
         Assert(GHasDyn(inClass));
         GNotifyRemoveDyn(inClass);
@@ -1029,6 +2463,9 @@ namespace Runtime {
 
     bool ECRegistry::GHasDyn(GCompClass inClass) const
     {
+#if BUILD_CONFIG_DEBUG
+        Internal::CheckCompAccess(inClass, false);
+#endif
         Assert(Internal::IsGlobalCompClass(inClass));
         return globalComps.contains(inClass);
     }
@@ -1047,6 +2484,9 @@ namespace Runtime {
 
     Mirror::Any ECRegistry::GGetDyn(GCompClass inClass)
     {
+#if BUILD_CONFIG_DEBUG
+        Internal::CheckCompAccess(inClass, false);
+#endif
         Assert(Internal::IsGlobalCompClass(inClass));
         Assert(GHasDyn(inClass));
         return globalComps.at(inClass).Ref();
@@ -1054,6 +2494,9 @@ namespace Runtime {
 
     Mirror::Any ECRegistry::GGetDyn(GCompClass inClass) const
     {
+#if BUILD_CONFIG_DEBUG
+        Internal::CheckCompAccess(inClass, false);
+#endif
         Assert(Internal::IsGlobalCompClass(inClass));
         Assert(GHasDyn(inClass));
         return globalComps.at(inClass).ConstRef();
@@ -1229,6 +2672,8 @@ namespace Runtime {
     }
 
     SystemPipeline::SystemPipeline(const SystemGraph& inGraph)
+        : currentAction(nullptr)
+        , currentSync(nullptr)
     {
         const auto& systemGroups = inGraph.GetGroups();
         systemGraph.reserve(systemGroups.size());
@@ -1243,67 +2688,120 @@ namespace Runtime {
                 systemContexts.emplace_back(factory, nullptr);
             }
         }
+        Compile();
     }
 
-    void SystemPipeline::ParallelPerformAction(const ActionFunc& inActionFunc)
+    SystemPipeline::~SystemPipeline() = default;
+
+    static bool IsEffectivelyExclusive(SystemExecuteStrategy inStrategy, const SystemAccess* inAccess)
     {
-        tf::Taskflow taskFlow;
-        auto lastBarrier = taskFlow.emplace([]() -> void { Core::ScopedThreadTag threadTag(Core::ThreadTag::gameWorker); });
+        if (inAccess == nullptr || !inAccess->Declared()) {
+            return inStrategy == SystemExecuteStrategy::sequential;
+        }
+        return inAccess->IsExclusive();
+    }
 
-        for (auto& groupContext : systemGraph) {
-            if (groupContext.strategy == SystemExecuteStrategy::sequential) {
-                tf::Task lastTask = lastBarrier;
-                for (auto& systemContext : groupContext.systems) {
-                    auto task = taskFlow.emplace([&]() -> void {
-                        Core::ScopedThreadTag threadTag(Core::ThreadTag::gameWorker);
-                        inActionFunc(systemContext);
-                    });
-                    task.succeed(lastTask);
-                    lastTask = task;
-                }
-                lastBarrier = lastTask;
-            } else if (groupContext.strategy == SystemExecuteStrategy::concurrent) {
-                std::vector<tf::Task> tasks;
-                tasks.reserve(groupContext.systems.size());
-
-                for (auto& systemContext : groupContext.systems) {
-                    tasks.emplace_back(taskFlow.emplace([&]() -> void {
-                        Core::ScopedThreadTag threadTag(Core::ThreadTag::gameWorker);
-                        inActionFunc(systemContext);
-                    }));
-                    tasks.back().succeed(lastBarrier);
-                }
+    static bool AccessConflicts(SystemExecuteStrategy inStrategy, const SystemAccess* inLhs, const SystemAccess* inRhs)
+    {
+        if (IsEffectivelyExclusive(inStrategy, inLhs) || IsEffectivelyExclusive(inStrategy, inRhs)) {
+            return true;
+        }
+        if (inLhs == nullptr || !inLhs->Declared() || inRhs == nullptr || !inRhs->Declared()) {
+            return false;
+        }
+        return inLhs->ConflictsWith(*inRhs);
+    }
+
+    void SystemPipeline::Compile()
+    {
+        taskGraph.Clear();
+        auto lastBarrier = taskGraph.Emplace();
 
-                auto barrier = taskFlow.emplace([]() -> void { Core::ScopedThreadTag threadTag(Core::ThreadTag::gameWorker); });
-                for (const auto& task : tasks) {
-                    barrier.succeed(task);
+        for (auto& groupContext : systemGraph) {
+            const auto strategy = groupContext.strategy;
+            Assert(strategy < SystemExecuteStrategy::max);
+
+            std::vector<Common::TaskGraph::NodeId> tasks;
+            std::vector<const SystemAccess*> accesses;
+            tasks.reserve(groupContext.systems.size());
+            accesses.reserve(groupContext.systems.size());
+
+            auto barrier = taskGraph.Emplace();
+            taskGraph.Precede(lastBarrier, barrier);
+            for (auto& systemContext : groupContext.systems) {
+                auto task = taskGraph.Emplace([this, &systemContext]() -> void {
+                    PerformAction(systemContext);
+                });
+                taskGraph.Precede(lastBarrier, task);
+
+                // depend on the earlier systems with conflicting access, an exclusive one already runs after all systems
+                // before it, so the search can stop there
+                const auto* access = systemContext.instance != nullptr ? &systemContext.instance->GetAccess() : nullptr;
+                for (auto i = tasks.size(); i > 0; i--) {
+                    if (!AccessConflicts(strategy, accesses[i - 1], access)) {
+                        continue;
+                    }
+                    taskGraph.Precede(tasks[i - 1], task);
+                    if (IsEffectivelyExclusive(strategy, accesses[i - 1])) {
+                        break;
+                    }
                 }
-                lastBarrier = barrier;
-            } else {
-                QuickFail();
+                taskGraph.Precede(task, barrier);
+                tasks.emplace_back(task);
+                accesses.emplace_back(access);
             }
+            lastBarrier = barrier;
+
+            auto syncTask = taskGraph.Emplace([this]() -> void {
+                PerformSync();
+            });
+            taskGraph.Precede(lastBarrier, syncTask);
+            lastBarrier = syncTask;
+        }
+    }
+
+    void SystemPipeline::PerformAction(SystemContext& inSystemContext) const
+    {
+        Core::ScopedThreadTag threadTag(Core::ThreadTag::gameWorker);
+        (*currentAction)(inSystemContext);
+    }
+
+    void SystemPipeline::PerformSync() const
+    {
+        if (!currentSync) {
+            return;
         }
+        Core::ScopedThreadTag threadTag(Core::ThreadTag::gameWorker);
+        (*currentSync)();
+    }
 
-        tf::Executor executor;
-        executor
-            .run(taskFlow)
-            .wait();
+    void SystemPipeline::ParallelPerformAction(const ActionFunc& inActionFunc, const SyncFunc& inSyncFunc)
+    {
+        Assert(currentAction == nullptr && currentSync == nullptr);
+        currentAction = &inActionFunc;
+        currentSync = inSyncFunc ? &inSyncFunc : nullptr;
+        GameWorkerThreads::Get().RunAndWait(taskGraph);
+        currentAction = nullptr;
+        currentSync = nullptr;
     }
 
     SystemSetupContext::SystemSetupContext()
         : playType(PlayType::max)
         , client(nullptr)
+        , checkAccess(false)
     {
     }
 
     SystemGraphExecutor::SystemGraphExecutor(ECRegistry& inEcRegistry, const SystemGraph& inSystemGraph, const SystemSetupContext& inSetupContext)
         : ecRegistry(inEcRegistry)
         , systemGraph(inSystemGraph)
-        , pipeline(inSystemGraph)
+        , pipeline(systemGraph)
+        , checkAccess(inSetupContext.checkAccess)
     {
         pipeline.ParallelPerformAction([&](SystemPipeline::SystemContext& context) -> void {
             context.instance = context.factory.Build(inEcRegistry, inSetupContext);
         });
+        pipeline.Compile();
     }
 
     SystemGraphExecutor::~SystemGraphExecutor()
@@ -1316,8 +2814,15 @@ namespace Runtime {
 
     void SystemGraphExecutor::Tick(float inDeltaTimeSeconds)
     {
-        pipeline.ParallelPerformAction([&](const SystemPipeline::SystemContext& context) -> void {
-            context.instance->Tick(inDeltaTimeSeconds);
-        });
+        pipeline.ParallelPerformAction(
+            [&](const SystemPipeline::SystemContext& context) -> void {
+#if BUILD_CONFIG_DEBUG
+                Internal::ScopedAccessCheck accessCheck(checkAccess ? &context.instance->GetAccess() : nullptr);
+#endif
+                context.instance->Tick(inDeltaTimeSeconds);
+            },
+            [&]() -> void {
+                ecRegistry.PlaybackCommands();
+            });
     }
 } // namespace Runtime
@@ -66,7 +66,7 @@ namespace Runtime {
         Core::ThreadContext::IncFrameNumber();
 
         auto& renderThread = renderModule->GetRenderThread();
-        renderThread.EmplaceTask([]() -> void {
+        renderThread.PostTask([]() -> void {
             Core::ThreadContext::IncFrameNumber();
             Core::Console::Get().PerformRenderThreadSettingsCopy();
             Render::ShaderArtifactRegistry::Get().PerformThreadCopy();
@@ -2,6 +2,8 @@
 // Created by Kindem on 2025/3/1.
 //
 
+#include <utility>
+
 #include <Runtime/GameThread.h>
 
 namespace Runtime {
@@ -11,7 +13,10 @@ namespace Runtime {
         return instance;
     }
 
-    GameThread::GameThread() = default;
+    GameThread::GameThread()
+        : tasks(taskQueueCapacity)
+    {
+    }
 
     GameThread::~GameThread()
     {
@@ -20,16 +25,25 @@ namespace Runtime {
 
     void GameThread::Flush()
     {
-        std::queue<std::function<void()>> tasksToExecute;
-        {
-            std::unique_lock lock(mutex);
-            tasksToExecute.swap(tasks);
+        // tasks emplaced by the flushed tasks run in the next flush, the spilled ones were posted after the ones in the ring
+        std::swap(runningOverflowTasks, overflowTasks);
+        Common::UniqueTask task;
+        for (auto taskNum = tasks.Size(); taskNum > 0 && tasks.TryPop(task); taskNum--) {
+            task();
+        }
+        for (auto& overflowTask : runningOverflowTasks) {
+            overflowTask();
         }
+        runningOverflowTasks.clear();
+    }
 
-        while (!tasksToExecute.empty()) {
-            tasksToExecute.front()();
-            tasksToExecute.pop();
+    void GameThread::PostLocal(Common::UniqueTask&& inTask)
+    {
+        // once a task spilled, the later ones follow it to keep the submission order of the game thread
+        if (overflowTasks.empty() && tasks.TryPush(std::move(inTask))) {
+            return;
         }
+        overflowTasks.emplace_back(std::move(inTask));
     }
 
     GameWorkerThreads& GameWorkerThreads::Get()
@@ -54,4 +68,15 @@ namespace Runtime {
         Assert(threads != nullptr);
         threads = nullptr;
     }
+
+    bool GameWorkerThreads::Started() const
+    {
+        return threads != nullptr;
+    }
+
+    void GameWorkerThreads::RunAndWait(Common::TaskGraph& inGraph) const
+    {
+        Assert(threads != nullptr);
+        threads->RunAndWait(inGraph);
+    }
 } // namespace Runtime
@@ -20,7 +20,7 @@ namespace Runtime {
 
     RenderSystem::~RenderSystem() // NOLINT
     {
-        renderModule.GetRenderThread().EmplaceTask([fence = lastFrameFence]() -> void {
+        renderModule.GetRenderThread().PostTask([fence = lastFrameFence]() -> void {
             fence->Wait();
             delete fence;
         });
@@ -29,7 +29,7 @@ namespace Runtime {
     void RenderSystem::Tick(float inDeltaTimeSeconds)
     {
         auto& clientViewport = client->GetViewport();
-        renderModule.GetRenderThread().EmplaceTask(
+        renderModule.GetRenderThread().PostTask(
             [
                 fence = lastFrameFence,
                 views = BuildViews(),
@@ -76,12 +76,12 @@ namespace Runtime {
         return {};
     }
 
-    std::vector<Render::View> RenderSystem::BuildViews() const
+    Common::FrameVector<Render::View> RenderSystem::BuildViews() const
     {
         const auto& playersInfo = registry.GGet<PlayersInfo>();
         const auto playerNum = playersInfo.players.size();
 
-        std::vector<Render::View> result;
+        Common::FrameVector<Render::View> result(Core::ThreadContext::FrameArena());
         result.reserve(playerNum);
 
         for (auto i = 0; i < playerNum; i++) {
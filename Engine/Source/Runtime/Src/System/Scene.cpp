@@ -12,6 +12,8 @@ namespace Runtime {
     SceneSystem::SceneSystem(ECRegistry& inRegistry, const SystemSetupContext& inContext)
         : System(inRegistry, inContext)
         , renderModule(EngineHolder::Get().GetRenderModule())
+        , sceneUpdatePool(Common::MakeShared<Render::SceneUpdateBufferPool>())
+        , sceneUpdates(sceneUpdatePool->Acquire())
         , transformUpdatedObserver(inRegistry.Observer())
         , directionalLightsObserver(inRegistry.EventsObserver<DirectionalLight>())
         , pointLightsObserver(inRegistry.EventsObserver<PointLight>())
@@ -52,5 +54,23 @@ namespace Runtime {
         directionalLightsObserver.Clear();
         pointLightsObserver.Clear();
         spotLightsObserver.Clear();
+
+        SubmitSceneUpdates();
+    }
+
+    void SceneSystem::SubmitSceneUpdates()
+    {
+        if (sceneUpdates->Empty()) {
+            return;
+        }
+
+        // the buffer is handed over to the render thread and replaced with a recycled one, render thread returns it to
+        // the pool once applied
+        const auto& sceneHolder = registry.GGet<SceneHolder>();
+        renderModule.GetRenderThread().PostTask([scene = sceneHolder.scene.Get(), pool = sceneUpdatePool, updates = std::move(sceneUpdates)]() mutable -> void {
+            updates->Apply(*scene);
+            pool->Release(std::move(updates));
+        });
+        sceneUpdates = sceneUpdatePool->Acquire();
     }
 }
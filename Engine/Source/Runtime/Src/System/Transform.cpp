@@ -2,85 +2,238 @@
 // Created by johnk on 2025/1/21.
 //
 
+#include <algorithm>
+#include <utility>
+
+#include <Common/Math/TransformBatch.h>
+#include <Core/Thread.h>
 #include <Runtime/System/Transform.h>
 
 namespace Runtime {
     TransformSystem::TransformSystem(ECRegistry& inRegistry, const SystemSetupContext& inContext)
         : System(inRegistry, inContext)
-        , worldTransformUpdatedObserver(registry.Observer())
-        , localTransformUpdatedObserver(registry.Observer())
+        , lastChangeTick(registry.IncChangeTick())
     {
-        worldTransformUpdatedObserver.ObUpdated<WorldTransform>();
-        localTransformUpdatedObserver.ObUpdated<LocalTransform>();
+        access.Read<Hierarchy>().Write<LocalTransform>().Write<WorldTransform>();
     }
 
     TransformSystem::~TransformSystem() = default;
 
     void TransformSystem::Tick(float inDeltaTimeSeconds)
     {
-        // Step0: classify the updated entities
-        std::vector<Entity> pendingUpdateLocalTransforms;
-        std::vector<Entity> pendingUpdateChildrenWorldTransforms;
-        std::vector<Entity> pendingUpdateSelfAndChildrenWorldTransforms;
-
-        pendingUpdateLocalTransforms.reserve(worldTransformUpdatedObserver.Count());
-        pendingUpdateChildrenWorldTransforms.reserve(worldTransformUpdatedObserver.Count());
-        worldTransformUpdatedObserver.EachThenClear([&](Entity e) -> void {
-            if (registry.Has<LocalTransform>(e) && registry.Has<Hierarchy>(e) && HierarchyOps::HasParent(registry, e)) {
+        // Step0: classify the entities updated since the last tick, the value of dirtyEntities tells whether the entity's own
+        // world transform need be recomputed from its parent, or only its children's, all the transient containers of a tick
+        // live in the frame arena
+        auto& frameArena = Core::ThreadContext::FrameArena();
+        Common::FrameVector<Entity> pendingUpdateLocalTransforms(frameArena);
+        Common::FrameUnorderedMap<Entity, bool> dirtyEntities(frameArena);
+
+        const auto sinceTick = lastChangeTick;
+        lastChangeTick = registry.IncChangeTick();
+        SyncWorldMatrices(sinceTick);
+
+        const auto worldTransformUpdatedView = registry.View<WorldTransform>(Exclude<> {}, Changed<WorldTransform> { sinceTick });
+        worldTransformUpdatedView.Each([&](Entity e) -> void {
+            const auto* hierarchy = registry.Find<Hierarchy>(e);
+            if (hierarchy == nullptr) {
+                return;
+            }
+            if (hierarchy->parent != entityNull && registry.Has<LocalTransform>(e)) {
                 pendingUpdateLocalTransforms.emplace_back(e);
             }
-
-            if (registry.Has<Hierarchy>(e) && HierarchyOps::HasChildren(registry, e)) {
-                pendingUpdateChildrenWorldTransforms.emplace_back(e);
+            if (hierarchy->firstChild != entityNull) {
+                dirtyEntities.emplace(e, false);
             }
         });
 
-        pendingUpdateSelfAndChildrenWorldTransforms.reserve(localTransformUpdatedObserver.Count());
-        localTransformUpdatedObserver.EachThenClear([&](Entity e) -> void {
-            if (registry.Has<WorldTransform>(e) && registry.Has<Hierarchy>(e) && HierarchyOps::HasParent(registry, e)) {
-                pendingUpdateSelfAndChildrenWorldTransforms.emplace_back(e);
+        const auto localTransformUpdatedView = registry.View<LocalTransform>(Exclude<> {}, Changed<LocalTransform> { sinceTick });
+        localTransformUpdatedView.Each([&](Entity e) -> void {
+            const auto* hierarchy = registry.Find<Hierarchy>(e);
+            if (hierarchy != nullptr && hierarchy->parent != entityNull && registry.Has<WorldTransform>(e)) {
+                dirtyEntities[e] = true;
             }
         });
 
         // Step1: update local transforms
-        for (auto e : pendingUpdateLocalTransforms) {
+        UpdateLocalTransforms(pendingUpdateLocalTransforms);
+
+        // Step2: update world transforms level by level from the dirty roots
+        CollectDirtyRoots(dirtyEntities);
+        PropagateWorldTransforms();
+    }
+
+    void TransformSystem::SyncWorldMatrices(ChangeTick inSinceTick)
+    {
+        auto& frameArena = Core::ThreadContext::FrameArena();
+        Common::FrameVector<Common::FTransform> transforms(frameArena);
+        Common::FrameVector<Common::FMat4x4> matrices(frameArena);
+        const auto syncChunk = [&](std::span<const Entity>, std::span<WorldTransform> inWorldTransforms) -> void {
+            transforms.resize(inWorldTransforms.size());
+            matrices.resize(inWorldTransforms.size());
+            for (size_t i = 0; i < inWorldTransforms.size(); i++) {
+                transforms[i] = inWorldTransforms[i].localToWorld;
+            }
+            Common::BatchTransformToMatrix(transforms, matrices);
+            for (size_t i = 0; i < inWorldTransforms.size(); i++) {
+                inWorldTransforms[i].localToWorldMatrix = matrices[i];
+            }
+        };
+
+        const auto addedView = registry.View<WorldTransform>(Exclude<> {}, Added<WorldTransform> { inSinceTick });
+        addedView.ForEachChunk(syncChunk);
+        const auto changedView = registry.View<WorldTransform>(Exclude<> {}, Changed<WorldTransform> { inSinceTick });
+        changedView.ForEachChunk(syncChunk);
+    }
+
+    void TransformSystem::UpdateLocalTransforms(const Common::FrameVector<Entity>& inEntities)
+    {
+        // siblings share the parent, so the inverse of each parent world matrix is only computed once
+        Common::FrameUnorderedMap<Entity, Common::FMat4x4> parentWorldToLocalMatrices(Core::ThreadContext::FrameArena());
+        for (const auto e : inEntities) {
             auto& localTransform = registry.Get<LocalTransform>(e);
             const auto& worldTransform = registry.Get<WorldTransform>(e);
-            const auto& hierarchy = registry.Get<Hierarchy>(e);
-            const auto& parentWorldTransform = registry.Get<WorldTransform>(hierarchy.parent);
+            const auto parent = registry.Get<Hierarchy>(e).parent;
+
+            auto iter = parentWorldToLocalMatrices.find(parent);
+            if (iter == parentWorldToLocalMatrices.end()) {
+                const auto& parentWorldTransform = registry.Get<WorldTransform>(parent);
+                iter = parentWorldToLocalMatrices.emplace(parent, parentWorldTransform.localToWorldMatrix.Inverse()).first;
+            }
+            localTransform.localToParent = Common::FTransform(iter->second * worldTransform.localToWorldMatrix);
+        }
+    }
 
-            const auto& localToWorldMatrix = worldTransform.localToWorld.GetTransformMatrix();
-            const auto& parentLocalToWorldMatrix = parentWorldTransform.localToWorld.GetTransformMatrix();
-            localTransform.localToParent = Common::FTransform(parentLocalToWorldMatrix.Inverse() * localToWorldMatrix);
+    void TransformSystem::CollectDirtyRoots(const Common::FrameUnorderedMap<Entity, bool>& inDirtyEntities)
+    {
+        for (auto& level : levels) {
+            level.clear();
+        }
+        if (levels.empty()) {
+            levels.emplace_back();
         }
 
-        // Step2: update world transforms
-        const auto updateWorldByLocal = [&](Entity child, Entity parent) -> void {
-            if (!registry.Has<LocalTransform>(child) || !registry.Has<WorldTransform>(child) || !registry.Has<WorldTransform>(parent)) {
-                return;
+        // a dirty entity below another dirty entity is already covered by the traversal from the upper one
+        auto& roots = levels[0];
+        for (const auto& [entity, updateSelf] : inDirtyEntities) {
+            bool covered = false;
+            for (auto e = registry.Get<Hierarchy>(entity).parent; e != entityNull; e = registry.Get<Hierarchy>(e).parent) {
+                if (inDirtyEntities.contains(e)) {
+                    covered = true;
+                    break;
+                }
             }
+            if (covered) {
+                continue;
+            }
+
+            PropagateNode node {};
+            node.entity = entity;
+            node.parentIndex = rootParentIndex;
+            node.updateSelf = updateSelf;
+            node.valid = false;
+            node.worldTransform = nullptr;
+            roots.emplace_back(node);
+        }
+    }
 
-            auto& childWorldTransform = registry.Get<WorldTransform>(child);
-            const auto& childLocalTransform = registry.Get<LocalTransform>(child);
-            const auto& parentWorldTransform = registry.Get<WorldTransform>(parent);
+    void TransformSystem::PropagateWorldTransforms()
+    {
+        auto& frameArena = Core::ThreadContext::FrameArena();
+        for (size_t depth = 0; depth < levels.size() && !levels[depth].empty(); depth++) {
+            auto& level = levels[depth];
+            const auto* parentLevel = depth == 0 ? nullptr : &levels[depth - 1];
 
-            const auto& parentLocalToWorldMatrix = parentWorldTransform.localToWorld.GetTransformMatrix();
-            const auto& childLocalToParentMatrix = childLocalTransform.localToParent.GetTransformMatrix();
-            childWorldTransform.localToWorld = Common::FTransform(parentLocalToWorldMatrix * childLocalToParentMatrix);
-        };
+            // the mutable lookup detaches the chunk of a world transform shared with a snapshot, which must not happen on
+            // the workers, so the batches only write through the pointers resolved here
+            for (auto& node : level) {
+                node.worldTransform = registry.Find<WorldTransform>(node.entity);
+            }
 
-        for (const auto e : pendingUpdateChildrenWorldTransforms) {
-            HierarchyOps::TraverseChildrenRecursively(registry, e, [&](Entity child, Entity parent) -> void {
-                updateWorldByLocal(child, parent);
+            // each batch updates its nodes and gathers their children, the children are appended to the next level in
+            // batch order once the whole level is done
+            const auto batchNum = (level.size() + propagateGrainSize - 1) / propagateGrainSize;
+            Common::FrameVector<Common::FrameVector<PropagateNode>> batchChildren(batchNum, Common::FrameVector<PropagateNode>(frameArena), frameArena);
+            Internal::ParallelFor(batchNum, [&](size_t inBatchIndex) -> void {
+                const auto begin = inBatchIndex * propagateGrainSize;
+                const auto end = std::min(level.size(), begin + propagateGrainSize);
+                PropagateBatch(level, begin, end, parentLevel, batchChildren[inBatchIndex]);
             });
+
+            if (depth + 1 == levels.size()) {
+                levels.emplace_back();
+            }
+            // level may be dangling after the emplace above
+            auto& nextLevel = levels[depth + 1];
+            for (auto& children : batchChildren) {
+                nextLevel.insert(nextLevel.end(), children.begin(), children.end());
+            }
         }
-        for (const auto e : pendingUpdateSelfAndChildrenWorldTransforms) {
-            const auto& hierarchy = registry.Get<Hierarchy>(e);
-            updateWorldByLocal(e, hierarchy.parent);
+    }
 
-            HierarchyOps::TraverseChildrenRecursively(registry, e, [&](Entity child, Entity parent) -> void {
-                updateWorldByLocal(child, parent);
-            });
+    void TransformSystem::PropagateBatch(std::vector<PropagateNode>& ioLevel, size_t inBegin, size_t inEnd, const std::vector<PropagateNode>* inParentLevel, Common::FrameVector<PropagateNode>& outChildren)
+    {
+        // nodes recomputed from their parent are gathered and composed by the batch kernels, the others keep their
+        // cached world matrix, the batches run in parallel so the registry is only read here
+        const auto& constRegistry = std::as_const(registry);
+        auto& frameArena = Core::ThreadContext::FrameArena();
+        Common::FrameVector<size_t> composedNodes(frameArena);
+        Common::FrameVector<WorldTransform*> composedWorldTransforms(frameArena);
+        Common::FrameVector<Common::FTransform> localToParents(frameArena);
+        Common::FrameVector<Common::FMat4x4> parentLocalToWorlds(frameArena);
+        composedNodes.reserve(inEnd - inBegin);
+        composedWorldTransforms.reserve(inEnd - inBegin);
+        localToParents.reserve(inEnd - inBegin);
+        parentLocalToWorlds.reserve(inEnd - inBegin);
+
+        for (auto i = inBegin; i < inEnd; i++) {
+            auto& node = ioLevel[i];
+            const auto& hierarchy = constRegistry.Get<Hierarchy>(node.entity);
+            for (auto child = hierarchy.firstChild; child != entityNull; child = constRegistry.Get<Hierarchy>(child).nextBro) {
+                PropagateNode childNode {};
+                childNode.entity = child;
+                childNode.parentIndex = static_cast<uint32_t>(i);
+                childNode.updateSelf = true;
+                childNode.valid = false;
+                childNode.worldTransform = nullptr;
+                outChildren.emplace_back(childNode);
+            }
+
+            auto* worldTransform = node.worldTransform;
+            if (worldTransform == nullptr) {
+                node.valid = false;
+                continue;
+            }
+
+            const Common::FMat4x4* parentLocalToWorld = nullptr;
+            if (node.parentIndex != rootParentIndex) {
+                const auto& parentNode = (*inParentLevel)[node.parentIndex];
+                parentLocalToWorld = parentNode.valid ? &parentNode.localToWorld : nullptr;
+            } else if (node.updateSelf) {
+                const auto* parentWorldTransform = constRegistry.Find<WorldTransform>(hierarchy.parent);
+                parentLocalToWorld = parentWorldTransform != nullptr ? &parentWorldTransform->localToWorldMatrix : nullptr;
+            }
+
+            const auto* localTransform = constRegistry.Find<LocalTransform>(node.entity);
+            if (node.updateSelf && parentLocalToWorld != nullptr && localTransform != nullptr) {
+                composedNodes.emplace_back(i);
+                composedWorldTransforms.emplace_back(worldTransform);
+                localToParents.emplace_back(localTransform->localToParent);
+                parentLocalToWorlds.emplace_back(*parentLocalToWorld);
+            } else {
+                node.localToWorld = worldTransform->localToWorldMatrix;
+                node.valid = true;
+            }
+        }
+
+        Common::FrameVector<Common::FMat4x4> localToWorlds(composedNodes.size(), frameArena);
+        Common::BatchTransformToMatrix(localToParents, localToWorlds);
+        Common::BatchMulAffine(parentLocalToWorlds, localToWorlds, localToWorlds);
+        for (size_t i = 0; i < composedNodes.size(); i++) {
+            auto& node = ioLevel[composedNodes[i]];
+            node.localToWorld = localToWorlds[i];
+            node.valid = true;
+            composedWorldTransforms[i]->localToWorld = Common::FTransform(localToWorlds[i]);
+            composedWorldTransforms[i]->localToWorldMatrix = localToWorlds[i];
         }
     }
 }
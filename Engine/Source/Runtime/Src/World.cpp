@@ -53,6 +53,9 @@ namespace Runtime {
     {
         Assert(Stopped() && !executor.has_value());
         playStatus = PlayStatus::playing;
+        if (systemSetupContext.playType == PlayType::editor) {
+            editorSnapshot.emplace(ecRegistry);
+        }
         executor.emplace(ecRegistry, systemGraph, systemSetupContext);
     }
 
@@ -73,6 +76,10 @@ namespace Runtime {
         Assert((Playing() || Paused()) && executor.has_value());
         playStatus = PlayStatus::stopped;
         executor.reset();
+        if (editorSnapshot.has_value()) {
+            ecRegistry = std::move(*editorSnapshot);
+            editorSnapshot.reset();
+        }
     }
 
     void World::LoadFrom(AssetPtr<Level> inLevel)
@@ -53,6 +53,19 @@ TEST(AssetTest, SaveLoadTest)
     ASSERT_EQ(restore->b, "hello");
 }
 
+TEST(AssetTest, CompressedSaveLoadTest)
+{
+    static Core::Uri uri("asset://Engine/Test/Generated/Runtime/AssetTest.CompressedSaveLoadTest");
+
+    AssetPtr<TestAsset> asset = MakeShared<TestAsset>(uri, 3, std::string(4096, 'a'));
+    AssetManager::Get().Save(asset, true);
+
+    AssetPtr<TestAsset> restore = AssetManager::Get().SyncLoad<TestAsset>(uri, TestAsset::GetStaticClass());
+    ASSERT_EQ(restore.Uri(), uri);
+    ASSERT_EQ(restore->a, 3);
+    ASSERT_EQ(restore->b, std::string(4096, 'a'));
+}
+
 TEST(AssetTest, AsyncLoadTest)
 {
     static Core::Uri uri("asset://Engine/Test/Generated/Runtime/AssetTest.SaveLoadTest");
@@ -80,3 +93,16 @@ TEST(AssetTest, PolySaveLoadTest)
     ASSERT_EQ(result->a, 1);
     ASSERT_EQ(result->b, "hello");
 }
+
+TEST(AssetTest, CoLoadTest)
+{
+    static Core::Uri uri("asset://Engine/Test/Generated/Runtime/AssetTest.CoLoadTest");
+
+    AssetPtr<TestAsset> asset = MakeShared<TestAsset>(uri, 2, "world");
+    AssetManager::Get().Save(asset);
+
+    AssetPtr<TestAsset> restore = Common::SyncWait(AssetManager::Get().CoLoad<TestAsset>(uri, TestAsset::GetStaticClass()));
+    ASSERT_EQ(restore.Uri(), uri);
+    ASSERT_EQ(restore->a, 2);
+    ASSERT_EQ(restore->b, "world");
+}
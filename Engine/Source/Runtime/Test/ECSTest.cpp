@@ -2,7 +2,15 @@
 // Created by johnk on 2024/12/9.
 //
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
 #include <ECSTest.h>
+#include <Runtime/GameThread.h>
+#include <Runtime/System/Transform.h>
 #include <Test/Test.h>
 
 TEST(ECSTest, EntityTest)
@@ -31,6 +39,35 @@ TEST(ECSTest, EntityTest)
     });
 }
 
+TEST(ECSTest, EntityGenerationTest)
+{
+    ECRegistry registry;
+    const auto entity0 = registry.Create();
+    const auto entity1 = registry.Create();
+    registry.Emplace<CompA>(entity0, 1);
+    registry.Emplace<CompA>(entity1, 2);
+
+    registry.Destroy(entity0);
+    const auto entity2 = registry.Create();
+    ASSERT_EQ(EntityIndex(entity2), EntityIndex(entity0));
+    ASSERT_NE(entity2, entity0);
+    ASSERT_FALSE(registry.Valid(entity0));
+    ASSERT_TRUE(registry.Valid(entity2));
+    ASSERT_FALSE(registry.Has<CompA>(entity2));
+    ASSERT_EQ(registry.Get<CompA>(entity1).value, 2);
+
+    // entity1 was relocated into the hole left by entity0, its record must still point at the right row
+    registry.Emplace<CompA>(entity2, 3);
+    registry.Destroy(entity1);
+    ASSERT_EQ(registry.Get<CompA>(entity2).value, 3);
+    ASSERT_EQ(registry.Count(), 1);
+
+    registry.Create(MakeEntity(10, 2));
+    ASSERT_TRUE(registry.Valid(MakeEntity(10, 2)));
+    ASSERT_FALSE(registry.Valid(MakeEntity(10, 0)));
+    ASSERT_EQ(registry.Count(), 2);
+}
+
 TEST(ECSTest, ComponentStaticTest)
 {
     ECRegistry registry;
@@ -418,6 +455,571 @@ TEST(ECSTest, ECRegistryCopyTest)
     ASSERT_EQ(registry1.Get<CompB>(entity1).value, 2.0f);
 }
 
+TEST(ECSTest, ECRegistrySnapshotTest)
+{
+    constexpr int entityNum = 5000;
+
+    ECRegistry registry;
+    std::vector<Entity> entities;
+    entities.reserve(entityNum);
+    for (auto i = 0; i < entityNum; i++) {
+        const auto entity = registry.Create();
+        registry.EmplaceBundle(entity, CompA(i), CompC(std::to_string(i)));
+        entities.emplace_back(entity);
+    }
+
+    const ECRegistry snapshot = registry;
+    registry.Get<CompA>(entities[0]).value = -1;
+    registry.Update<CompC>(entities[1], [](CompC& compC) -> void { compC.value = "updated"; });
+    registry.View<CompA>().Each([](Entity, CompA& compA) -> void { compA.value *= 2; });
+    registry.Emplace<CompB>(entities[2], 2.0f);
+    registry.Destroy(entities[3]);
+    (void) registry.Create();
+
+    ASSERT_EQ(registry.Get<CompA>(entities[0]).value, -2);
+    ASSERT_EQ(registry.Get<CompC>(entities[1]).value, "updated");
+    ASSERT_EQ(registry.Get<CompA>(entities[4]).value, 8);
+    ASSERT_EQ(snapshot.Count(), entityNum);
+    ASSERT_FALSE(snapshot.Has<CompB>(entities[2]));
+    snapshot.ConstView<CompA, CompC>().Each([&](Entity e, const CompA& compA, const CompC& compC) -> void {
+        ASSERT_EQ(entities[compA.value], e);
+        ASSERT_EQ(compC.value, std::to_string(compA.value));
+    });
+
+    registry = snapshot;
+    ASSERT_EQ(registry.Count(), entityNum);
+    ASSERT_TRUE(registry.Valid(entities[3]));
+    ASSERT_EQ(registry.Get<CompA>(entities[0]).value, 0);
+    ASSERT_EQ(registry.Get<CompC>(entities[1]).value, "1");
+    ASSERT_FALSE(registry.Has<CompB>(entities[2]));
+    const auto restoredView = registry.View<CompA, CompC>();
+    ASSERT_EQ(restoredView.Count(), entityNum);
+}
+
+SnapshotTest_WriteASystem::SnapshotTest_WriteASystem(ECRegistry& inRegistry, const SystemSetupContext& inContext)
+    : System(inRegistry, inContext)
+{
+    access.Write<CompA>();
+}
+
+SnapshotTest_WriteASystem::~SnapshotTest_WriteASystem() = default;
+
+void SnapshotTest_WriteASystem::Tick(float inDeltaTimeSeconds)
+{
+    registry.View<CompA>().ParallelEach([](Entity, CompA& compA) -> void {
+        compA.value++;
+    }, 16);
+}
+
+SnapshotTest_WriteBSystem::SnapshotTest_WriteBSystem(ECRegistry& inRegistry, const SystemSetupContext& inContext)
+    : System(inRegistry, inContext)
+{
+    access.Write<CompB>();
+}
+
+SnapshotTest_WriteBSystem::~SnapshotTest_WriteBSystem() = default;
+
+void SnapshotTest_WriteBSystem::Tick(float inDeltaTimeSeconds)
+{
+    registry.View<CompB>().ParallelEach([](Entity, CompB& compB) -> void {
+        compB.value += 1.0f;
+    }, 16);
+}
+
+TEST(ECSTest, ECRegistrySnapshotParallelWriteTest)
+{
+    constexpr int entityNum = 5000;
+    constexpr int tickNum = 3;
+
+    // both systems write the chunks of one archetype at the same time, right after the snapshot shared all of them
+    GameWorkerThreads::Get().Start();
+    {
+        ECRegistry registry;
+        std::vector<Entity> entities;
+        entities.reserve(entityNum);
+        for (auto i = 0; i < entityNum; i++) {
+            const auto entity = registry.Create();
+            registry.EmplaceBundle(entity, CompA(i), CompB(static_cast<float>(i)));
+            entities.emplace_back(entity);
+        }
+        const ECRegistry snapshot = registry;
+
+        SystemGraph systemGraph;
+        auto& group = systemGraph.AddGroup("ParallelWriteGroup", SystemExecuteStrategy::concurrent);
+        group.EmplaceSystem<SnapshotTest_WriteASystem>();
+        group.EmplaceSystem<SnapshotTest_WriteBSystem>();
+        {
+            SystemGraphExecutor executor(registry, systemGraph, SystemSetupContext());
+            for (auto i = 0; i < tickNum; i++) {
+                executor.Tick(0.0167f);
+            }
+        }
+
+        for (auto i = 0; i < entityNum; i++) {
+            ASSERT_EQ(registry.Get<CompA>(entities[i]).value, i + tickNum);
+            ASSERT_EQ(registry.Get<CompB>(entities[i]).value, static_cast<float>(i + tickNum));
+            ASSERT_EQ(snapshot.Get<CompA>(entities[i]).value, i);
+            ASSERT_EQ(snapshot.Get<CompB>(entities[i]).value, static_cast<float>(i));
+        }
+    }
+    GameWorkerThreads::Get().Stop();
+}
+
+SnapshotTest_ReadASystem::SnapshotTest_ReadASystem(ECRegistry& inRegistry, const SystemSetupContext& inContext)
+    : System(inRegistry, inContext)
+    , sum(0)
+{
+    access.Read<CompA>();
+}
+
+SnapshotTest_ReadASystem::~SnapshotTest_ReadASystem() = default;
+
+void SnapshotTest_ReadASystem::Tick(float inDeltaTimeSeconds)
+{
+    std::as_const(registry).ConstView<CompA>().Each([this](Entity, const CompA& compA) -> void {
+        sum += compA.value;
+    });
+}
+
+TEST(ECSTest, ECRegistrySnapshotSharingTest)
+{
+    constexpr int entityNum = 5000;
+
+    // the way World::Play() of an editor world snapshots the registry, then ticks a graph which writes nothing
+    GameWorkerThreads::Get().Start();
+    {
+        ECRegistry registry;
+        std::vector<Entity> entities;
+        entities.reserve(entityNum);
+        for (auto i = 0; i < entityNum; i++) {
+            const auto entity = registry.Create();
+            registry.EmplaceBundle(entity, CompA(i), CompB(static_cast<float>(i)));
+            entities.emplace_back(entity);
+        }
+        const ECRegistry snapshot = registry;
+        const auto sharedWithSnapshot = [&]() -> bool {
+            return std::ranges::all_of(entities, [&](Entity e) -> bool {
+                return &std::as_const(registry).Get<CompA>(e) == &snapshot.Get<CompA>(e)
+                    && &std::as_const(registry).Get<CompB>(e) == &snapshot.Get<CompB>(e);
+            });
+        };
+        ASSERT_TRUE(sharedWithSnapshot());
+
+        SystemGraph readGraph;
+        auto& readGroup = readGraph.AddGroup("ReadGroup", SystemExecuteStrategy::concurrent);
+        readGroup.EmplaceSystem<SnapshotTest_ReadASystem>();
+        {
+            SystemGraphExecutor executor(registry, readGraph, SystemSetupContext());
+            ASSERT_TRUE(sharedWithSnapshot());
+            executor.Tick(0.0167f);
+            executor.Tick(0.0167f);
+            ASSERT_TRUE(sharedWithSnapshot());
+        }
+
+        // a write only detaches the chunks it touches
+        registry.Get<CompA>(entities[0]).value = -1;
+        ASSERT_NE(&std::as_const(registry).Get<CompA>(entities[0]), &snapshot.Get<CompA>(entities[0]));
+        ASSERT_EQ(&std::as_const(registry).Get<CompA>(entities[entityNum - 1]), &snapshot.Get<CompA>(entities[entityNum - 1]));
+        ASSERT_EQ(snapshot.Get<CompA>(entities[0]).value, 0);
+    }
+    GameWorkerThreads::Get().Stop();
+}
+
+TEST(ECSTest, MultiChunkTest)
+{
+    constexpr int entityNum = 10000;
+
+    ECRegistry registry;
+    std::vector<Entity> entities;
+    entities.reserve(entityNum);
+    for (auto i = 0; i < entityNum; i++) {
+        const auto entity = registry.Create();
+        registry.Emplace<CompA>(entity, i);
+        registry.Emplace<CompB>(entity, static_cast<float>(i));
+        entities.emplace_back(entity);
+    }
+
+    for (auto i = 0; i < entityNum; i += 2) {
+        registry.Destroy(entities[i]);
+    }
+    for (auto i = 1; i < entityNum; i += 4) {
+        registry.Remove<CompB>(entities[i]);
+    }
+
+    ASSERT_EQ(registry.View<CompA>().Count(), entityNum / 2);
+    const auto view = registry.View<CompA, CompB>();
+    ASSERT_EQ(view.Count(), entityNum / 4);
+    registry.View<CompA>().Each([&](Entity e, CompA& compA) -> void {
+        ASSERT_EQ(entities[compA.value], e);
+        ASSERT_EQ(compA.value % 2, 1);
+        ASSERT_EQ(registry.Has<CompB>(e), compA.value % 4 == 3);
+    });
+
+    const ECRegistry copied = registry;
+    copied.ConstView<CompA, CompB>().Each([&](Entity e, const CompA& compA, const CompB& compB) -> void {
+        ASSERT_EQ(entities[compA.value], e);
+        ASSERT_EQ(static_cast<float>(compA.value), compB.value);
+    });
+}
+
+TEST(ECSTest, ViewChunkIterationTest)
+{
+    constexpr int entityNum = 5000;
+
+    ECRegistry registry;
+    for (auto i = 0; i < entityNum; i++) {
+        const auto entity = registry.Create();
+        registry.Emplace<CompA>(entity, i);
+        if (i % 2 == 0) {
+            registry.Emplace<CompB>(entity, static_cast<float>(i));
+        }
+    }
+
+    const auto view = registry.View<CompA>();
+    size_t chunkNum = 0;
+    size_t elemNum = 0;
+    int64_t sum = 0;
+    view.ForEachChunk([&](std::span<const Entity> entities, std::span<CompA> compAs) -> void {
+        ASSERT_EQ(entities.size(), compAs.size());
+        chunkNum++;
+        elemNum += compAs.size();
+        for (auto& compA : compAs) {
+            sum += compA.value;
+            compA.value *= 2;
+        }
+    });
+    ASSERT_GT(chunkNum, 2);
+    ASSERT_EQ(elemNum, entityNum);
+    ASSERT_EQ(sum, static_cast<int64_t>(entityNum) * (entityNum - 1) / 2);
+
+    size_t iterNum = 0;
+    for (const auto& [entity, compA] : view) {
+        ASSERT_EQ(registry.Get<CompA>(entity).value, compA.value);
+        ASSERT_EQ(compA.value % 2, 0);
+        iterNum++;
+    }
+    ASSERT_EQ(iterNum, entityNum);
+
+    const auto constView = registry.ConstView<CompA, CompB>();
+    iterNum = 0;
+    constView.ForEachChunk([&](std::span<const Entity> entities, std::span<const CompA> compAs, std::span<const CompB> compBs) -> void {
+        for (auto i = 0; i < entities.size(); i++) {
+            ASSERT_EQ(static_cast<float>(compAs[i].value), compBs[i].value * 2.0f);
+        }
+        iterNum += entities.size();
+    });
+    ASSERT_EQ(iterNum, entityNum / 2);
+}
+
+TEST(ECSTest, ParallelEachTest)
+{
+    constexpr int entityNum = 5000;
+
+    ECRegistry registry;
+    for (auto i = 0; i < entityNum; i++) {
+        const auto entity = registry.Create();
+        registry.Emplace<CompA>(entity, i);
+        if (i % 2 == 0) {
+            registry.Emplace<CompB>(entity, static_cast<float>(i));
+        }
+    }
+
+    std::atomic<int64_t> sum = 0;
+    registry.View<CompA>().ParallelEach([&](Entity e, CompA& compA) -> void {
+        sum += compA.value;
+        compA.value++;
+    }, 100);
+    ASSERT_EQ(sum.load(), static_cast<int64_t>(entityNum) * (entityNum - 1) / 2);
+
+    std::atomic<int> count = 0;
+    registry.ConstView<CompA>(Exclude<CompB> {}).ParallelEach([&](Entity e, const CompA& compA) -> void {
+        ASSERT_EQ(compA.value % 2, 0);
+        count++;
+    }, 7);
+    ASSERT_EQ(count.load(), entityNum / 2);
+
+    count = 0;
+    registry.ConstRuntimeView(RuntimeFilter().Include<CompA>().Include<CompB>()).ParallelEach([&](Entity e, const CompA& compA, const CompB& compB) -> void {
+        ASSERT_EQ(static_cast<float>(compA.value - 1), compB.value);
+        count++;
+    }, 64);
+    ASSERT_EQ(count.load(), entityNum / 2);
+
+    registry.RuntimeView(RuntimeFilter().Include<CompA>()).ParallelEach([&](Entity e, CompA& compA) -> void {
+        compA.value--;
+    }, 64);
+    sum = 0;
+    registry.ConstView<CompA>().Each([&](Entity e, const CompA& compA) -> void {
+        sum += compA.value;
+    });
+    ASSERT_EQ(sum.load(), static_cast<int64_t>(entityNum) * (entityNum - 1) / 2);
+
+    // a thread without tag has no frame arena, the batches must not come from it
+    count = 0;
+    std::thread([&]() -> void {
+        registry.View<CompA>().ParallelEach([&](Entity e, CompA& compA) -> void {
+            count++;
+        }, 1);
+    }).join();
+    ASSERT_EQ(count.load(), entityNum);
+}
+
+TEST(ECSTest, ArchetypeTransitionTest)
+{
+    constexpr int entityNum = 1000;
+
+    ECRegistry registry;
+    std::vector<Entity> entities;
+    entities.reserve(entityNum);
+    for (auto i = 0; i < entityNum; i++) {
+        const auto entity = registry.Create();
+        registry.Emplace<CompA>(entity, i);
+        registry.Emplace<CompC>(entity, std::to_string(i));
+        entities.emplace_back(entity);
+    }
+
+    for (auto round = 0; round < 10; round++) {
+        for (auto i = round % 2; i < entityNum; i += 2) {
+            registry.Emplace<CompB>(entities[i], static_cast<float>(i));
+        }
+        for (auto i = round % 2; i < entityNum; i += 2) {
+            registry.Remove<CompB>(entities[i]);
+        }
+    }
+
+    for (auto i = 0; i < entityNum; i++) {
+        ASSERT_FALSE(registry.Has<CompB>(entities[i]));
+        ASSERT_EQ(registry.Get<CompA>(entities[i]).value, i);
+        ASSERT_EQ(registry.Get<CompC>(entities[i]).value, std::to_string(i));
+    }
+
+    for (auto i = 0; i < entityNum; i += 3) {
+        registry.Remove<CompC>(entities[i]);
+    }
+    const auto view = registry.View<CompA, CompC>();
+    ASSERT_EQ(view.Count(), entityNum - (entityNum + 2) / 3);
+    view.Each([&](Entity e, const CompA& compA, const CompC& compC) -> void {
+        ASSERT_EQ(compC.value, std::to_string(compA.value));
+    });
+
+    const ECRegistry copied = registry;
+    ASSERT_EQ(copied.Get<CompC>(entities[1]).value, "1");
+}
+
+TEST(ECSTest, QueryCacheTest)
+{
+    ECRegistry registry;
+    const auto entity0 = registry.Create();
+    registry.Emplace<CompA>(entity0, 1);
+
+    const auto view0 = registry.View<CompA>(Exclude<CompB> {});
+    ASSERT_EQ(view0.Count(), 1);
+
+    // archetypes created after the query was cached must still be picked up
+    const auto entity1 = registry.Create();
+    registry.EmplaceBundle(entity1, CompA(2), CompC("2"));
+    const auto entity2 = registry.Create();
+    registry.EmplaceBundle(entity2, CompA(3), CompB(3.0f));
+
+    const auto view1 = registry.View<CompA>(Exclude<CompB> {});
+    ASSERT_EQ(view1.Count(), 2);
+    view1.Each([&](Entity e, const CompA& compA) -> void {
+        ASSERT_TRUE(e == entity0 || e == entity1);
+        ASSERT_EQ(compA.value, e == entity0 ? 1 : 2);
+    });
+
+    const auto view2 = registry.View<CompC, CompA>();
+    view2.Each([&](Entity e, const CompC& compC, const CompA& compA) -> void {
+        ASSERT_EQ(e, entity1);
+        ASSERT_EQ(compC.value, std::to_string(compA.value));
+    });
+
+    // equal filters share a cached query regardless of the order classes were added in
+    const auto runtimeView0 = registry.RuntimeView(RuntimeFilter().Include<CompA>().Include<CompB>());
+    const auto runtimeView1 = registry.RuntimeView(RuntimeFilter().Include<CompB>().Include<CompA>());
+    ASSERT_EQ(runtimeView0.Count(), 1);
+    ASSERT_EQ(runtimeView1.Count(), 1);
+
+    registry.Clear();
+    const auto entity3 = registry.Create();
+    registry.Emplace<CompA>(entity3, 4);
+    const auto view3 = registry.View<CompA>(Exclude<CompB> {});
+    ASSERT_EQ(view3.Count(), 1);
+}
+
+TEST(ECSTest, ChangeFilterTest)
+{
+    constexpr int entityNum = 1000;
+
+    ECRegistry registry;
+    std::vector<Entity> entities;
+    entities.reserve(entityNum);
+    for (auto i = 0; i < entityNum; i++) {
+        const auto entity = registry.Create();
+        registry.EmplaceBundle(entity, CompA(i), CompB(static_cast<float>(i)));
+        entities.emplace_back(entity);
+    }
+
+    const auto tick0 = registry.IncChangeTick();
+    {
+        const auto view = registry.View<CompA>(Exclude<> {}, Added<CompA> { tick0 });
+        ASSERT_EQ(view.Count(), 0);
+        const auto allView = registry.View<CompA>(Exclude<> {}, Added<CompA> { 0 });
+        ASSERT_EQ(allView.Count(), entityNum);
+    }
+
+    for (auto i = 0; i < entityNum; i += 7) {
+        registry.Update<CompA>(entities[i], [](CompA& compA) -> void { compA.value = -compA.value; });
+    }
+    const auto newEntity = registry.Create();
+    registry.Emplace<CompA>(newEntity, entityNum);
+    registry.Emplace<CompB>(newEntity, static_cast<float>(entityNum));
+
+    const auto tick1 = registry.IncChangeTick();
+    {
+        const auto view = registry.View<CompA, CompB>(Exclude<> {}, Changed<CompA> { tick0 });
+        ASSERT_EQ(view.Count(), (entityNum + 6) / 7);
+        view.Each([&](Entity e, const CompA& compA, const CompB& compB) -> void {
+            ASSERT_EQ(compA.value, -static_cast<int>(compB.value));
+        });
+
+        size_t rowNum = 0;
+        view.ForEachChunk([&](std::span<const Entity> inEntities, std::span<CompA> inCompAs, std::span<CompB>) -> void {
+            rowNum += inEntities.size();
+            for (const auto& compA : inCompAs) {
+                ASSERT_LE(compA.value, 0);
+            }
+        });
+        ASSERT_EQ(rowNum, view.Count());
+
+        size_t iterNum = 0;
+        for (const auto& [e, compA, compB] : view) {
+            ASSERT_EQ(compA.value, -static_cast<int>(compB.value));
+            iterNum++;
+        }
+        ASSERT_EQ(iterNum, view.Count());
+
+        const auto addedView = registry.View<CompB>(Exclude<> {}, Added<CompB> { tick0 });
+        ASSERT_EQ(addedView.Count(), 1);
+        ASSERT_EQ(std::get<0>(*addedView.Begin()), newEntity);
+    }
+
+    // change ticks follow the rows through archetype migrations and swap-removes
+    registry.Emplace<CompC>(entities[7], std::string("7"));
+    registry.Destroy(entities[0]);
+    {
+        const auto view = registry.View<CompA>(Exclude<> {}, Changed<CompA> { tick0 });
+        ASSERT_EQ(view.Count(), (entityNum + 6) / 7 - 1);
+        const auto nothingView = registry.View<CompA>(Exclude<> {}, Changed<CompA> { tick1 });
+        ASSERT_EQ(nothingView.Count(), 0);
+    }
+}
+
+TEST(ECSTest, SystemAccessTest)
+{
+    SystemAccess undeclared;
+    ASSERT_FALSE(undeclared.Declared());
+
+    SystemAccess readA;
+    readA.Read<CompA>();
+    ASSERT_TRUE(readA.Declared());
+    ASSERT_TRUE(readA.CanRead(&Mirror::Class::Get<CompA>()));
+    ASSERT_FALSE(readA.CanWrite(&Mirror::Class::Get<CompA>()));
+    ASSERT_FALSE(readA.CanRead(&Mirror::Class::Get<CompB>()));
+
+    SystemAccess writeAReadB;
+    writeAReadB.Write<CompA>().Read<CompB>();
+    ASSERT_TRUE(writeAReadB.CanRead(&Mirror::Class::Get<CompA>()));
+    ASSERT_TRUE(writeAReadB.CanWrite(&Mirror::Class::Get<CompA>()));
+
+    SystemAccess readAB;
+    readAB.Read<CompA>().Read<CompB>();
+    SystemAccess writeC;
+    writeC.Write<CompC>();
+    SystemAccess exclusive;
+    exclusive.Exclusive();
+
+    ASSERT_FALSE(readA.ConflictsWith(readAB));
+    ASSERT_TRUE(readA.ConflictsWith(writeAReadB));
+    ASSERT_TRUE(writeAReadB.ConflictsWith(readAB));
+    ASSERT_FALSE(writeAReadB.ConflictsWith(writeC));
+    ASSERT_TRUE(writeC.ConflictsWith(writeC));
+    ASSERT_TRUE(exclusive.ConflictsWith(readA));
+    ASSERT_TRUE(readA.ConflictsWith(exclusive));
+}
+
+TEST(ECSTest, EmplaceBundleTest)
+{
+    ECRegistry registry;
+    const auto entity0 = registry.Create();
+    auto [compA, compB] = registry.EmplaceBundle(entity0, CompA(1), CompB(2.0f));
+    ASSERT_EQ(compA.value, 1);
+    ASSERT_EQ(compB.value, 2.0f);
+    ASSERT_EQ(registry.CompCount(entity0), 2);
+
+    const auto entity1 = registry.Create();
+    registry.Emplace<CompA>(entity1, 3);
+    const auto compRefs = registry.EmplaceDynBundle(
+        { &Mirror::Class::Get<CompB>(), &Mirror::Class::Get<CompC>() },
+        entity1,
+        { Mirror::ForwardAsArgList(4.0f), Mirror::ForwardAsArgList(std::string("5")) });
+    ASSERT_EQ(compRefs.size(), 2);
+    ASSERT_EQ(compRefs[0].As<CompB&>().value, 4.0f);
+    ASSERT_EQ(registry.Get<CompA>(entity1).value, 3);
+    ASSERT_EQ(registry.Get<CompB>(entity1).value, 4.0f);
+    ASSERT_EQ(registry.Get<CompC>(entity1).value, "5");
+}
+
+TEST(ECSTest, EntityCommandBufferTest)
+{
+    ECRegistry registry;
+    const auto entity0 = registry.Create();
+    const auto entity1 = registry.Create();
+    registry.Emplace<CompA>(entity0, 1);
+    registry.Emplace<CompA>(entity1, 2);
+
+    auto& commands = registry.Commands();
+    std::vector<std::thread> threads;
+    for (auto i = 0; i < 4; i++) {
+        threads.emplace_back([&commands, i]() -> void {
+            for (auto j = 0; j < 100; j++) {
+                const auto entity = commands.Create();
+                commands.Emplace<CompA>(entity, i * 100 + j);
+                commands.Emplace<CompB>(entity, static_cast<float>(i));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    commands.Emplace<CompB>(entity0, 6.0f);
+    commands.Emplace<CompB>(entity0, 3.0f);
+    commands.Emplace<CompC>(entity0, "4");
+    commands.Remove<CompA>(entity0);
+    commands.Emplace<CompB>(entity1, 5.0f);
+    commands.Remove<CompB>(entity1);
+    commands.Destroy(entity1);
+    ASSERT_FALSE(commands.Empty());
+    ASSERT_EQ(registry.Count(), 2);
+
+    registry.PlaybackCommands();
+    ASSERT_TRUE(commands.Empty());
+    ASSERT_EQ(registry.Count(), 401);
+    ASSERT_FALSE(registry.Valid(entity1));
+    ASSERT_FALSE(registry.Has<CompA>(entity0));
+    ASSERT_EQ(registry.Get<CompB>(entity0).value, 3.0f);
+    ASSERT_EQ(registry.Get<CompC>(entity0).value, "4");
+    ASSERT_EQ(registry.CompCount(entity0), 2);
+
+    std::unordered_set<int> values;
+    registry.View<CompA, CompB>().Each([&](Entity e, const CompA& compA, const CompB& compB) -> void {
+        ASSERT_EQ(static_cast<float>(compA.value / 100), compB.value);
+        values.emplace(compA.value);
+    });
+    ASSERT_EQ(values.size(), 400);
+}
+
 TEST(ECSTest, ECSRegistrySaveLoadTest)
 {
     ECArchive archive;
@@ -447,3 +1049,171 @@ TEST(ECSTest, ECSRegistrySaveLoadTest)
         ASSERT_EQ(registry.GCompCount(), 2);
     }
 }
+
+TEST(ECSTest, ECSRegistryColumnarSaveLoadTest)
+{
+    std::vector<uint8_t> bytes;
+    {
+        ECRegistry registry;
+        // enough rows to span several chunks
+        for (auto i = 0; i < 2000; i++) {
+            const auto entity = registry.Create();
+            registry.Emplace<CompA>(entity, i);
+            if (i % 2 == 0) {
+                registry.Emplace<CompC>(entity, std::to_string(i));
+            }
+        }
+        const auto entity = registry.Create();
+        registry.Emplace<CompB>(entity, 2.0f);
+        (void) registry.Create();
+        registry.GEmplace<GCompA>(1);
+        registry.GEmplace<GCompB>(2.0f);
+
+        registry.SaveColumnar(bytes);
+    }
+
+    {
+        ECRegistry registry;
+        size_t constructedNum = 0;
+        const auto constructedCallback = registry.Events<CompC>().onConstructed.BindLambda([&](ECRegistry&, Entity) -> void { constructedNum++; });
+        ASSERT_TRUE(registry.LoadColumnar(bytes.data(), bytes.size()));
+        registry.Events<CompC>().onConstructed.Unbind(constructedCallback);
+
+        ASSERT_EQ(registry.Count(), 2002);
+        ASSERT_EQ(constructedNum, 1000);
+        for (auto i = 0; i < 2000; i++) {
+            const auto entity = static_cast<Entity>(i + 1);
+            ASSERT_EQ(registry.Get<CompA>(entity).value, i);
+            ASSERT_EQ(registry.Has<CompC>(entity), i % 2 == 0);
+            if (i % 2 == 0) {
+                ASSERT_EQ(registry.Get<CompC>(entity).value, std::to_string(i));
+            }
+        }
+        ASSERT_EQ(registry.Get<CompB>(2001u).value, 2.0f);
+        ASSERT_EQ(registry.CompCount(2002u), 0);
+        ASSERT_EQ(registry.GGet<GCompA>().value, 1);
+        ASSERT_EQ(registry.GGet<GCompB>().value, 2.0f);
+
+        const auto addedView = registry.View<CompA>(Exclude<> {}, Added<CompA> { 0 });
+        ASSERT_EQ(addedView.Count(), 2000);
+
+        // a snapshot of the other byte order, a changed raw layout or a truncated body fails the load, the first two are
+        // rejected before the registry is touched
+        auto swapped = bytes;
+        std::reverse(swapped.begin() + 8, swapped.begin() + 12);
+        ASSERT_FALSE(registry.LoadColumnar(swapped.data(), swapped.size()));
+        ASSERT_EQ(registry.Count(), 2002);
+
+        auto resized = bytes;
+        const std::string compAName = CompA::GetStaticClass().GetName();
+        const auto compAIter = std::search(resized.begin(), resized.end(), compAName.begin(), compAName.end());
+        ASSERT_NE(compAIter, resized.end());
+        *(compAIter + static_cast<ptrdiff_t>(compAName.size())) += 1;
+        ASSERT_FALSE(registry.LoadColumnar(resized.data(), resized.size()));
+        ASSERT_EQ(registry.Count(), 2002);
+
+        ASSERT_FALSE(registry.LoadColumnar(bytes.data(), bytes.size() / 2));
+        ASSERT_EQ(registry.Count(), 0);
+    }
+}
+
+TEST(ECSTest, TransformSystemPropagateTest)
+{
+    // root -> mid -> [leafNum leaves] -> grand child under every 16th leaf, the leaves span several propagate batches
+    constexpr size_t leafNum = 600;
+    constexpr size_t grandChildStride = 16;
+
+    GameWorkerThreads::Get().Start();
+    {
+        ECRegistry registry;
+        const auto createNode = [&](Entity inParent, const Common::FTransform& inLocalToParent) -> Entity {
+            const auto entity = registry.Create();
+            registry.EmplaceBundle(entity, Hierarchy(), LocalTransform(inLocalToParent), WorldTransform());
+            if (inParent != entityNull) {
+                HierarchyOps::AttachToParent(registry, entity, inParent);
+            }
+            return entity;
+        };
+        const auto makeTransform = [](size_t inSeed) -> Common::FTransform {
+            const auto seed = static_cast<float>(inSeed);
+            return {
+                Common::FVec3(1.0f + 0.001f * seed),
+                Common::FQuat(Common::FVec3(1.0f, seed, 2.0f), seed * 7.0f),
+                Common::FVec3(seed * 0.01f, 1.0f, -seed * 0.02f)
+            };
+        };
+
+        std::vector<Entity> nodes;
+        const auto root = createNode(entityNull, makeTransform(0));
+        const auto mid = createNode(root, makeTransform(1));
+        nodes.emplace_back(root);
+        nodes.emplace_back(mid);
+        for (size_t i = 0; i < leafNum; i++) {
+            const auto leaf = createNode(mid, makeTransform(i + 2));
+            nodes.emplace_back(leaf);
+            if (i % grandChildStride == 0) {
+                nodes.emplace_back(createNode(leaf, makeTransform(i + leafNum)));
+            }
+        }
+
+        // the expected world matrices composed serially from the root down, the localToWorld of the children is checked
+        // against the decomposition of the expected matrix, which is what the system stores
+        const auto verify = [&]() -> void {
+            const auto& constRegistry = std::as_const(registry);
+            std::unordered_map<Entity, Common::FMat4x4> expected;
+            expected.emplace(root, constRegistry.Get<WorldTransform>(root).localToWorld.GetTransformMatrix());
+            for (const auto e : nodes) {
+                if (e == root) {
+                    continue;
+                }
+                const auto parent = constRegistry.Get<Hierarchy>(e).parent;
+                expected.emplace(e, expected.at(parent) * constRegistry.Get<LocalTransform>(e).localToParent.GetTransformMatrix());
+            }
+            for (const auto e : nodes) {
+                const auto& worldTransform = constRegistry.Get<WorldTransform>(e);
+                const auto& expectedMatrix = expected.at(e);
+                const auto expectedDecomposedMatrix = e == root ? expectedMatrix : Common::FTransform(expectedMatrix).GetTransformMatrix();
+                const auto actualDecomposedMatrix = worldTransform.localToWorld.GetTransformMatrix();
+                for (uint8_t row = 0; row < 4; row++) {
+                    for (uint8_t col = 0; col < 4; col++) {
+                        ASSERT_NEAR(worldTransform.localToWorldMatrix.At(row, col), expectedMatrix.At(row, col), 1e-3f);
+                        ASSERT_NEAR(actualDecomposedMatrix.At(row, col), expectedDecomposedMatrix.At(row, col), 1e-3f);
+                    }
+                }
+            }
+        };
+
+        SystemSetupContext setupContext;
+        setupContext.playType = PlayType::game;
+        TransformSystem transformSystem(registry, setupContext);
+        const auto tickAndVerify = [&]() -> void {
+            Core::ThreadContext::IncFrameNumber();
+            transformSystem.Tick(0.0167f);
+            verify();
+        };
+        transformSystem.Tick(0.0167f);
+
+        // the root is moved through its world transform, which propagates to the whole tree
+        registry.Update<WorldTransform>(root, [](WorldTransform& outTransform) -> void {
+            outTransform.localToWorld.Translate(Common::FVec3(3.0f, -2.0f, 1.0f));
+            outTransform.localToWorld.Rotate(Common::FQuat(Common::FVec3(1.0f, 0.0f, 0.0f), 45.0f));
+        });
+        tickAndVerify();
+
+        // a parent and its child are both dirty in the same tick
+        registry.Update<LocalTransform>(mid, [](LocalTransform& outTransform) -> void {
+            outTransform.localToParent.Rotate(Common::FQuat(Common::FVec3(0.0f, 0.0f, 1.0f), 30.0f));
+        });
+        registry.Update<LocalTransform>(nodes[2], [](LocalTransform& outTransform) -> void {
+            outTransform.localToParent.Translate(Common::FVec3(0.0f, 5.0f, 0.0f));
+        });
+        tickAndVerify();
+
+        // a single leaf of the last batch
+        registry.Update<LocalTransform>(nodes.back(), [](LocalTransform& outTransform) -> void {
+            outTransform.localToParent.Scale(Common::FVec3(2.0f));
+        });
+        tickAndVerify();
+    }
+    GameWorkerThreads::Get().Stop();
+}
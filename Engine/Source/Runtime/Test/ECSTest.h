@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <string>
+
 #include <Runtime/Meta.h>
 #include <Runtime/ECS.h>
 using namespace Runtime;
@@ -40,6 +42,19 @@ struct EClass() CompB {
     EProperty() float value;
 };
 
+struct EClass() CompC {
+    EClassBody(CompC)
+
+    CompC() = default;
+
+    explicit CompC(std::string inValue)
+        : value(std::move(inValue))
+    {
+    }
+
+    EProperty() std::string value;
+};
+
 struct EClass(globalComp) GCompA {
     EClassBody(GCompA)
 
@@ -72,6 +87,35 @@ struct EClass(globalComp) GCompB {
     EProperty() float value;
 };
 
+class EClass() SnapshotTest_WriteASystem : public System {
+    EPolyClassBody(SnapshotTest_WriteASystem)
+
+    explicit SnapshotTest_WriteASystem(ECRegistry& inRegistry, const SystemSetupContext& inContext);
+    ~SnapshotTest_WriteASystem() override;
+
+    void Tick(float inDeltaTimeSeconds) override;
+};
+
+class EClass() SnapshotTest_WriteBSystem : public System {
+    EPolyClassBody(SnapshotTest_WriteBSystem)
+
+    explicit SnapshotTest_WriteBSystem(ECRegistry& inRegistry, const SystemSetupContext& inContext);
+    ~SnapshotTest_WriteBSystem() override;
+
+    void Tick(float inDeltaTimeSeconds) override;
+};
+
+class EClass() SnapshotTest_ReadASystem : public System {
+    EPolyClassBody(SnapshotTest_ReadASystem)
+
+    explicit SnapshotTest_ReadASystem(ECRegistry& inRegistry, const SystemSetupContext& inContext);
+    ~SnapshotTest_ReadASystem() override;
+
+    void Tick(float inDeltaTimeSeconds) override;
+
+    int64_t sum;
+};
+
 struct EventCounts {
     uint32_t onConstructed;
     uint32_t onUpdated;
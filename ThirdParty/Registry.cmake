@@ -22,9 +22,9 @@ endif ()
 find_package(glfw3 REQUIRED GLOBAL)
 find_package(stb REQUIRED GLOBAL)
 find_package(cityhash REQUIRED GLOBAL)
+find_package(lz4 REQUIRED GLOBAL)
 find_package(GTest REQUIRED GLOBAL)
 find_package(benchmark REQUIRED GLOBAL)
-find_package(Taskflow REQUIRED GLOBAL)
 find_package(libclang REQUIRED GLOBAL)
 find_package(assimp REQUIRED GLOBAL)
 find_package(VulkanMemoryAllocator REQUIRED GLOBAL)